@@ -38,6 +38,7 @@ static __thread napi_ref g_rendererConstructor = nullptr;
 std::unique_ptr<AudioParameters> AudioRendererNapi::sAudioParameters_ = nullptr;
 std::unique_ptr<AudioRendererOptions> AudioRendererNapi::sRendererOptions_ = nullptr;
 napi_ref AudioRendererNapi::audioRendererRate_ = nullptr;
+napi_ref AudioRendererNapi::audioRendererFlag_ = nullptr;
 napi_ref AudioRendererNapi::interruptEventType_ = nullptr;
 napi_ref AudioRendererNapi::interruptHintType_ = nullptr;
 napi_ref AudioRendererNapi::interruptForceType_ = nullptr;
@@ -204,6 +205,36 @@ napi_value AudioRendererNapi::CreateAudioRendererRateObject(napi_env env)
     return result;
 }
 
+napi_value AudioRendererNapi::CreateAudioRendererFlagObject(napi_env env)
+{
+    napi_value result = nullptr;
+    napi_status status;
+    std::string propName;
+
+    status = napi_create_object(env, &result);
+    if (status == napi_ok) {
+        for (auto &iter: rendererFlagMap) {
+            propName = iter.first;
+            status = AddNamedProperty(env, result, propName, iter.second);
+            if (status != napi_ok) {
+                HiLog::Error(LABEL, "Failed to add named prop!");
+                break;
+            }
+            propName.clear();
+        }
+        if (status == napi_ok) {
+            status = napi_create_reference(env, result, REFERENCE_CREATION_COUNT, &audioRendererFlag_);
+            if (status == napi_ok) {
+                return result;
+            }
+        }
+    }
+    HiLog::Error(LABEL, "CreateAudioRendererFlagObject is Failed!");
+    napi_get_undefined(env, &result);
+
+    return result;
+}
+
 napi_value AudioRendererNapi::CreateAudioStateObject(napi_env env)
 {
     napi_value result = nullptr;
@@ -358,6 +389,7 @@ napi_value AudioRendererNapi::Init(napi_env env, napi_value exports)
     napi_property_descriptor static_prop[] = {
         DECLARE_NAPI_STATIC_FUNCTION("createAudioRenderer", CreateAudioRenderer),
         DECLARE_NAPI_PROPERTY("AudioRendererRate", CreateAudioRendererRateObject(env)),
+        DECLARE_NAPI_PROPERTY("AudioRendererFlag", CreateAudioRendererFlagObject(env)),
         DECLARE_NAPI_PROPERTY("InterruptType", CreateInterruptEventTypeObject(env)),
         DECLARE_NAPI_PROPERTY("InterruptForceType", CreateInterruptForceTypeObject(env)),
         DECLARE_NAPI_PROPERTY("InterruptHint", CreateInterruptHintTypeObject(env)),
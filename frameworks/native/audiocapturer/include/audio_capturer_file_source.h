@@ -20,12 +20,30 @@
 
 #include <cstdio>
 #include <list>
+#include <random>
 
 namespace OHOS {
 namespace AudioStandard {
+typedef struct {
+    const char *filePath;
+    uint32_t sampleRate;
+    uint32_t channel;
+    uint32_t bitsPerSample;
+    bool isRealtime;
+    uint32_t jitterUsec;
+} FileSourceAttr;
+
+/**
+ * Captures from a raw PCM or WAV file, looping at the end.
+ *
+ * The file is mapped and prefaulted at init, so a capture is a copy out of memory and never waits for storage. In
+ * real-time mode a capture returns when its last frame would have been recorded by a device running at the sample
+ * rate, plus a random delay of up to jitterUsec. The delays come from a fixed seed and restart with Start, so runs
+ * are reproducible.
+ */
 class AudioCapturerFileSource {
 public:
-    int32_t Init(const char *filePath);
+    int32_t Init(const FileSourceAttr &attr);
     void DeInit(void);
     int32_t Start(void);
     int32_t Stop(void);
@@ -34,7 +52,21 @@ public:
 private:
     AudioCapturerFileSource();
     ~AudioCapturerFileSource();
-    FILE *filePtr = nullptr;
+
+    int32_t MapFile(const std::string &path);
+    void FindWavData(void);
+    void Pace(uint64_t bytes);
+
+    FileSourceAttr attr_ = {};
+    void *mapBase_ = nullptr;
+    size_t mapSize_ = 0;
+    const char *data_ = nullptr;
+    uint64_t dataSize_ = 0;
+    uint64_t readPos_ = 0;
+
+    uint64_t startUsec_ = 0;
+    uint64_t capturedFrames_ = 0;
+    std::minstd_rand jitterRng_;
 };
 }  // namespace AudioStandard
 }  // namespace OHOS
@@ -19,7 +19,16 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-int32_t AudioCapturerFileSourceInit(const char* filePath);
+typedef struct {
+    const char *filePath;
+    uint32_t sampleRate;
+    uint32_t channel;
+    uint32_t bitsPerSample;
+    bool isRealtime;
+    uint32_t jitterUsec;
+} FileSourceAttr;
+
+int32_t AudioCapturerFileSourceInit(const FileSourceAttr *attr);
 void AudioCapturerFileSourceDeInit(void);
 int32_t AudioCapturerFileSourceStart(void);
 int32_t AudioCapturerFileSourceStop(void);
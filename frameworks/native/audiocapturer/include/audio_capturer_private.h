@@ -31,8 +31,11 @@ public:
     int32_t GetStreamInfo(AudioStreamInfo &streamInfo) const override;
     bool Start() const override;
     int32_t  Read(uint8_t &buffer, size_t userSize, bool isBlockingRead) const override;
+    int32_t AcquireReadBuffer(BufferDesc &bufDesc) const override;
+    int32_t ReleaseReadBuffer() const override;
     CapturerState GetStatus() const override;
     bool GetAudioTime(Timestamp &timestamp, Timestamp::Timestampbase base) const override;
+    int32_t GetStatistics(AudioStreamStatistics &stats) const override;
     bool Pause() const override;
     bool Stop() const override;
     bool Flush() const override;
@@ -35,6 +35,9 @@ typedef struct {
     uint32_t bufferSize;
     bool isBigEndian;
     const char *filePath;
+    // File source only: deliver at the sample rate, delaying each read by up to fileJitterUsec
+    bool fileRealtime;
+    uint32_t fileJitterUsec;
 } SourceAttr;
 
 struct CapturerSourceAdapter {
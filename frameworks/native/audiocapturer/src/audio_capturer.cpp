@@ -249,6 +249,16 @@ int32_t AudioCapturerPrivate::Read(uint8_t &buffer, size_t userSize, bool isBloc
     return audioStream_->Read(buffer, userSize, isBlockingRead);
 }
 
+int32_t AudioCapturerPrivate::AcquireReadBuffer(BufferDesc &bufDesc) const
+{
+    return audioStream_->AcquireReadBuffer(bufDesc);
+}
+
+int32_t AudioCapturerPrivate::ReleaseReadBuffer() const
+{
+    return audioStream_->ReleaseReadBuffer();
+}
+
 CapturerState AudioCapturerPrivate::GetStatus() const
 {
     return (CapturerState)audioStream_->GetState();
@@ -259,6 +269,11 @@ bool AudioCapturerPrivate::GetAudioTime(Timestamp &timestamp, Timestamp::Timesta
     return audioStream_->GetAudioTime(timestamp, base);
 }
 
+int32_t AudioCapturerPrivate::GetStatistics(AudioStreamStatistics &stats) const
+{
+    return audioStream_->GetStatistics(stats);
+}
+
 bool AudioCapturerPrivate::Pause() const
 {
     return audioStream_->PauseAudioStream();
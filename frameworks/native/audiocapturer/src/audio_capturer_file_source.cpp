@@ -15,10 +15,16 @@
 
 #include "audio_capturer_file_source.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cinttypes>
 #include <cstring>
+#include <ctime>
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "audio_errors.h"
@@ -28,6 +34,42 @@ using namespace std;
 
 namespace OHOS {
 namespace AudioStandard {
+namespace {
+const uint32_t BITS_PER_BYTE = 8;
+const uint64_t USEC_PER_SEC = 1000000;
+const uint64_t NSEC_PER_USEC = 1000;
+// A caller that fell further behind than this, e.g. while suspended, restarts the timeline instead of catching up
+const uint64_t MAX_PACING_LAG_USEC = 200000;
+const uint32_t JITTER_SEED = 1;
+
+const size_t WAV_RIFF_HEADER_SIZE = 12;
+const size_t WAV_CHUNK_HEADER_SIZE = 8;
+const size_t WAV_FMT_CHANNELS_OFFSET = 2;
+const size_t WAV_FMT_RATE_OFFSET = 4;
+const size_t WAV_FMT_BITS_OFFSET = 14;
+const size_t WAV_FMT_MIN_SIZE = 16;
+
+uint16_t GetLe16(const char *p)
+{
+    const uint8_t *u = reinterpret_cast<const uint8_t *>(p);
+    return static_cast<uint16_t>(u[0] | (u[1] << 8)); // 8: second byte
+}
+
+uint32_t GetLe32(const char *p)
+{
+    const uint8_t *u = reinterpret_cast<const uint8_t *>(p);
+    return static_cast<uint32_t>(u[0]) | (static_cast<uint32_t>(u[1]) << 8) | // 8: second byte
+        (static_cast<uint32_t>(u[2]) << 16) | (static_cast<uint32_t>(u[3]) << 24); // 16, 24: third and fourth byte
+}
+
+uint64_t GetNowUsec()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * USEC_PER_SEC + static_cast<uint64_t>(ts.tv_nsec) / NSEC_PER_USEC;
+}
+}
+
 AudioCapturerFileSource::AudioCapturerFileSource()
 {
 }
@@ -46,16 +88,19 @@ AudioCapturerFileSource *AudioCapturerFileSource::GetInstance()
 
 void AudioCapturerFileSource::DeInit()
 {
-    if (filePtr != nullptr) {
-        fclose(filePtr);
-        filePtr = nullptr;
+    if (mapBase_ != nullptr) {
+        munmap(mapBase_, mapSize_);
+        mapBase_ = nullptr;
     }
+    mapSize_ = 0;
+    data_ = nullptr;
+    dataSize_ = 0;
 }
 
-int32_t AudioCapturerFileSource::Init(const char *filePath)
+int32_t AudioCapturerFileSource::Init(const FileSourceAttr &attr)
 {
     char realPath[PATH_MAX + 1] = {0x00};
-    std::string sourceFilePath(filePath);
+    std::string sourceFilePath(attr.filePath);
     std::string rootPath;
     std::string fileName;
 
@@ -70,44 +115,163 @@ int32_t AudioCapturerFileSource::Init(const char *filePath)
         return ERROR;
     }
 
+    DeInit();
+    attr_ = attr;
     std::string verifiedPath(realPath);
-    filePtr = fopen(verifiedPath.append(fileName).c_str(), "rb");
-    if (filePtr == nullptr) {
-        AUDIO_ERR_LOG("Error opening pcm test file!");
+    if (MapFile(verifiedPath.append(fileName)) != SUCCESS) {
+        return ERROR;
+    }
+
+    data_ = static_cast<const char *>(mapBase_);
+    dataSize_ = mapSize_;
+    FindWavData();
+
+    // Serve whole frames only, so looping never splits one
+    uint32_t frameSize = attr_.channel * attr_.bitsPerSample / BITS_PER_BYTE;
+    if (frameSize > 0) {
+        dataSize_ -= dataSize_ % frameSize;
+    }
+    if (dataSize_ == 0) {
+        AUDIO_ERR_LOG("AudioCapturerFileSource: no audio data in file");
+        DeInit();
+        return ERROR;
+    }
+    readPos_ = 0;
+    AUDIO_INFO_LOG("AudioCapturerFileSource: %{public}" PRIu64 " bytes of audio, realtime %{public}d, "
+        "jitter %{public}u us", dataSize_, attr_.isRealtime, attr_.jitterUsec);
+
+    return SUCCESS;
+}
+
+int32_t AudioCapturerFileSource::MapFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        AUDIO_ERR_LOG("Error opening pcm test file! errno = %{public}d", errno);
+        return ERROR;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        AUDIO_ERR_LOG("AudioCapturerFileSource: empty or unreadable file, errno = %{public}d", errno);
+        close(fd);
+        return ERROR;
+    }
+
+    // Prefault the whole file, page faults on the capture path would show up in the measurements
+    size_t size = static_cast<size_t>(st.st_size);
+    void *base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        AUDIO_ERR_LOG("AudioCapturerFileSource: mmap failed, errno = %{public}d", errno);
         return ERROR;
     }
 
+    mapBase_ = base;
+    mapSize_ = size;
     return SUCCESS;
 }
 
+// Narrows the data to the "data" chunk of a WAV file. Anything else is taken as raw PCM in the source format.
+void AudioCapturerFileSource::FindWavData(void)
+{
+    if (dataSize_ < WAV_RIFF_HEADER_SIZE || memcmp(data_, "RIFF", 4) != 0 || // 4: chunk id size
+        memcmp(data_ + 8, "WAVE", 4) != 0) { // 8: form type offset, 4: its size
+        return;
+    }
+
+    uint64_t offset = WAV_RIFF_HEADER_SIZE;
+    while (offset + WAV_CHUNK_HEADER_SIZE <= dataSize_) {
+        const char *chunk = data_ + offset;
+        uint64_t chunkSize = GetLe32(chunk + 4); // 4: chunk size offset
+        const char *payload = chunk + WAV_CHUNK_HEADER_SIZE;
+        uint64_t available = dataSize_ - offset - WAV_CHUNK_HEADER_SIZE;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= WAV_FMT_MIN_SIZE && available >= WAV_FMT_MIN_SIZE) { // 4
+            uint16_t channels = GetLe16(payload + WAV_FMT_CHANNELS_OFFSET);
+            uint32_t rate = GetLe32(payload + WAV_FMT_RATE_OFFSET);
+            uint16_t bits = GetLe16(payload + WAV_FMT_BITS_OFFSET);
+            if (channels != attr_.channel || rate != attr_.sampleRate || bits != attr_.bitsPerSample) {
+                AUDIO_ERR_LOG("AudioCapturerFileSource: wav is %{public}u Hz %{public}u ch %{public}u bit, "
+                    "served as %{public}u Hz %{public}u ch %{public}u bit", rate, channels, bits,
+                    attr_.sampleRate, attr_.channel, attr_.bitsPerSample);
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) { // 4: chunk id size
+            data_ = payload;
+            dataSize_ = std::min(chunkSize, available);
+            return;
+        }
+        // Chunks are padded to an even size
+        offset += WAV_CHUNK_HEADER_SIZE + chunkSize + (chunkSize & 1);
+    }
+    AUDIO_ERR_LOG("AudioCapturerFileSource: wav without data chunk, reading it raw");
+}
+
+// Blocks until the frames captured so far, these included, would have been recorded by a device at the sample rate
+void AudioCapturerFileSource::Pace(uint64_t bytes)
+{
+    uint32_t frameSize = attr_.channel * attr_.bitsPerSample / BITS_PER_BYTE;
+    if (frameSize == 0 || attr_.sampleRate == 0) {
+        return;
+    }
+
+    uint64_t now = GetNowUsec();
+    uint64_t due = startUsec_ + capturedFrames_ * USEC_PER_SEC / attr_.sampleRate;
+    if (startUsec_ == 0 || now > due + MAX_PACING_LAG_USEC) {
+        startUsec_ = now;
+        capturedFrames_ = 0;
+    }
+
+    capturedFrames_ += bytes / frameSize;
+    due = startUsec_ + capturedFrames_ * USEC_PER_SEC / attr_.sampleRate;
+    if (attr_.jitterUsec > 0) {
+        // Jitter delays single reads, the timeline itself does not drift
+        std::uniform_int_distribution<uint32_t> jitter(0, attr_.jitterUsec);
+        due += jitter(jitterRng_);
+    }
+    if (due > now) {
+        usleep(static_cast<useconds_t>(due - now));
+    }
+}
+
 int32_t AudioCapturerFileSource::CaptureFrame(char *frame, uint64_t requestBytes, uint64_t &replyBytes)
 {
-    if (filePtr == nullptr) {
-        AUDIO_ERR_LOG("Invalid filePtr!");
+    if (data_ == nullptr) {
+        AUDIO_ERR_LOG("Invalid file mapping!");
         return ERROR;
     }
 
-    if (feof(filePtr)) {
-        AUDIO_INFO_LOG("End of the file reached, start reading from beginning");
-        rewind(filePtr);
+    if (attr_.isRealtime) {
+        Pace(requestBytes);
     }
 
-    replyBytes = fread(frame, 1, requestBytes, filePtr);
+    uint64_t copied = 0;
+    while (copied < requestBytes) {
+        uint64_t len = std::min(requestBytes - copied, dataSize_ - readPos_);
+        std::copy(data_ + readPos_, data_ + readPos_ + len, frame + copied);
+        copied += len;
+        readPos_ += len;
+        if (readPos_ == dataSize_) {
+            AUDIO_DEBUG_LOG("End of the file reached, start reading from beginning");
+            readPos_ = 0;
+        }
+    }
+    replyBytes = copied;
 
     return SUCCESS;
 }
 
 int32_t AudioCapturerFileSource::Start(void)
 {
+    // A new timeline with the same jitter sequence
+    startUsec_ = 0;
+    capturedFrames_ = 0;
+    jitterRng_.seed(JITTER_SEED);
     return SUCCESS;
 }
 
 int32_t AudioCapturerFileSource::Stop(void)
 {
-    if (filePtr != nullptr) {
-        fclose(filePtr);
-        filePtr = nullptr;
-    }
     return SUCCESS;
 }
 } // namespace AudioStandard
@@ -121,9 +285,14 @@ using namespace OHOS::AudioStandard;
 
 AudioCapturerFileSource *g_fileSourceInstance = AudioCapturerFileSource::GetInstance();
 
-int32_t AudioCapturerFileSourceInit(const char *filePath)
+int32_t AudioCapturerFileSourceInit(const FileSourceAttr *attr)
 {
-    return g_fileSourceInstance->Init(filePath);
+    if (attr == nullptr || attr->filePath == nullptr) {
+        AUDIO_ERR_LOG("AudioCapturerFileSourceInit invalid attr");
+        return ERR_INVALID_PARAM;
+    }
+
+    return g_fileSourceInstance->Init(*attr);
 }
 
 void AudioCapturerFileSourceDeInit()
@@ -133,12 +302,12 @@ void AudioCapturerFileSourceDeInit()
 
 int32_t AudioCapturerFileSourceStop()
 {
-    return SUCCESS;
+    return g_fileSourceInstance->Stop();
 }
 
 int32_t AudioCapturerFileSourceStart()
 {
-    return SUCCESS;
+    return g_fileSourceInstance->Start();
 }
 
 int32_t AudioCapturerFileSourceSetMute()
@@ -33,12 +33,31 @@ const int32_t CLASS_TYPE_PRIMARY = 0;
 const int32_t CLASS_TYPE_A2DP = 1;
 const int32_t CLASS_TYPE_FILE = 2;
 
+const uint32_t PCM_8_BIT = 8;
+const uint32_t PCM_16_BIT = 16;
+const uint32_t PCM_24_BIT = 24;
+const uint32_t PCM_32_BIT = 32;
+
 const char *g_deviceClassPrimary = "primary";
 const char *g_deviceClassA2Dp = "a2dp";
 const char *g_deviceClassFile = "file_io";
 
 int32_t g_deviceClass = -1;
 
+static uint32_t PcmFormatToBits(enum AudioFormat format)
+{
+    switch (format) {
+        case AUDIO_FORMAT_PCM_8_BIT:
+            return PCM_8_BIT;
+        case AUDIO_FORMAT_PCM_24_BIT:
+            return PCM_24_BIT;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            return PCM_32_BIT;
+        default:
+            return PCM_16_BIT;
+    }
+}
+
 static int32_t CapturerSourceInitInner(const SourceAttr *attr)
 {
     AUDIO_INFO_LOG("%{public}s: CapturerSourceInitInner", __func__);
@@ -57,7 +76,14 @@ static int32_t CapturerSourceInitInner(const SourceAttr *attr)
         return AudioCapturerSourceInit((AudioSourceAttr *)attr);
     } else if (g_deviceClass == CLASS_TYPE_FILE) {
         AUDIO_INFO_LOG("%{public}s: CLASS_TYPE_FILE", __func__);
-        return AudioCapturerFileSourceInit(attr->filePath);
+        FileSourceAttr fileSourceAttr;
+        fileSourceAttr.filePath = attr->filePath;
+        fileSourceAttr.sampleRate = attr->sampleRate;
+        fileSourceAttr.channel = attr->channel;
+        fileSourceAttr.bitsPerSample = PcmFormatToBits(attr->format);
+        fileSourceAttr.isRealtime = attr->fileRealtime;
+        fileSourceAttr.jitterUsec = attr->fileJitterUsec;
+        return AudioCapturerFileSourceInit(&fileSourceAttr);
     } else {
         AUDIO_ERR_LOG("%{public}s: Device not supported", __func__);
         return ERROR;
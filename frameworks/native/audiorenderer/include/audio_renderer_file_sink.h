@@ -18,16 +18,35 @@
 
 #include "audio_info.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
 #include <list>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace OHOS {
 namespace AudioStandard {
+typedef struct {
+    const char *filePath;
+    uint32_t sampleRate;
+    uint32_t channel;
+    uint32_t bitsPerSample;
+} FileSinkAttr;
+
+/**
+ * Writes rendered audio to a file, as a WAV file when the path ends in ".wav" and as raw PCM otherwise.
+ *
+ * RenderFrame only copies into a lock-free single producer, single consumer ring. A flush thread started with the
+ * sink writes the ring out, so slow storage costs dropped audio, counted by GetDroppedBytes, instead of blocking
+ * the render thread.
+ */
 class AudioRendererFileSink {
 public:
-    int32_t Init(const char *filePath);
+    int32_t Init(const FileSinkAttr &attr);
     void DeInit(void);
     int32_t Start(void);
     int32_t Stop(void);
@@ -39,12 +58,39 @@ public:
     int32_t SetVolume(float left, float right);
     int32_t GetLatency(uint32_t *latency);
     int32_t GetTransactionId(uint64_t *transactionId);
+    int32_t GetDroppedBytes(uint64_t *bytes);
     static AudioRendererFileSink *GetInstance(void);
 private:
     AudioRendererFileSink();
     ~AudioRendererFileSink();
-    FILE *filePtr_ = nullptr;
+
+    int32_t OpenFile(void);
+    void FlushLoop(void);
+    void WriteOut(void);
+    void Preallocate(uint64_t size);
+    void WriteWavHeader(uint64_t dataBytes);
+
+    int fd_ = -1;
     std::string filePath_;
+    FileSinkAttr attr_ = {};
+    bool isWav_ = false;
+
+    // Positions only grow, the ring index is the position masked by the power of two ring size
+    std::vector<char> ring_;
+    std::atomic<uint64_t> readPos_ {0};
+    std::atomic<uint64_t> writePos_ {0};
+    std::atomic<uint64_t> droppedBytes_ {0};
+    bool isDropping_ = false;
+
+    std::thread flushThread_;
+    std::mutex flushMutex_;
+    std::condition_variable flushCond_;
+    bool isRunning_ = false;
+
+    // Flush thread only
+    uint64_t dataBytes_ = 0;
+    uint64_t preallocatedBytes_ = 0;
+    bool canPreallocate_ = true;
 };
 }  // namespace AudioStandard
 }  // namespace OHOS
@@ -19,7 +19,14 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-int32_t AudioRendererFileSinkInit(const char *filePath);
+typedef struct {
+    const char *filePath;
+    uint32_t sampleRate;
+    uint32_t channel;
+    uint32_t bitsPerSample;
+} FileSinkAttr;
+
+int32_t AudioRendererFileSinkInit(const FileSinkAttr *attr);
 void AudioRendererFileSinkDeInit(void);
 int32_t AudioRendererFileSinkStart(void);
 int32_t AudioRendererFileSinkStop(void);
@@ -29,6 +36,7 @@ int32_t AudioRendererFileSinkRenderFrame(char *data, uint64_t len, uint64_t *wri
 int32_t AudioRendererFileSinkSetVolume(float left, float right);
 int32_t AudioRendererFileSinkGetLatency(uint32_t *latency);
 int32_t AudioRendererFileSinkGetTransactionId(uint64_t *transactionId);
+int32_t AudioRendererFileSinkGetDroppedBytes(uint64_t *bytes);
 #ifdef __cplusplus
 }
 #endif
@@ -29,17 +29,24 @@ class AudioRendererPrivate : public AudioRenderer {
 public:
     int32_t GetFrameCount(uint32_t &frameCount) const override;
     int32_t GetLatency(uint64_t &latency) const override;
+    int32_t GetStatistics(AudioStreamStatistics &stats) const override;
     int32_t SetParams(const AudioRendererParams params) override;
     int32_t GetParams(AudioRendererParams &params) const override;
     int32_t GetRendererInfo(AudioRendererInfo &rendererInfo) const override;
     int32_t GetStreamInfo(AudioStreamInfo &streamInfo) const override;
     bool Start() override;
     int32_t Write(uint8_t *buffer, size_t bufferSize) override;
+    int32_t AcquireWriteBuffer(BufferDesc &bufDesc) const override;
+    int32_t CommitWriteBuffer(size_t length) const override;
     RendererState GetStatus() const override;
     bool GetAudioTime(Timestamp &timestamp, Timestamp::Timestampbase base) const override;
     bool Drain() const override;
     bool Pause() const override;
     bool Stop() const override;
+    int32_t DrainAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const override;
+    int32_t FlushAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const override;
+    int32_t PauseAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const override;
+    int32_t StopAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const override;
     bool Flush() const override;
     bool Release() const override;
     int32_t GetBufferSize(size_t &bufferSize) const override;
@@ -73,11 +80,16 @@ public:
     ~AudioRendererPrivate();
 
 private:
+    std::shared_ptr<AudioStream> ClaimPooledStream(const AudioStreamParams &audioStreamParams);
+    void DeactivateInterrupt() const;
+
     static std::map<pid_t, std::map<AudioStreamType, AudioInterrupt>> sharedInterrupts_;
     std::shared_ptr<AudioStream> audioStream_;
     std::shared_ptr<AudioInterruptCallback> audioInterruptCallback_ = nullptr;
     std::shared_ptr<AudioStreamCallback> audioStreamCallback_ = nullptr;
     AppInfo appInfo_ = {};
+    // Kept to re-apply to a stream claimed from the pool
+    std::string cachePath_;
     AudioInterrupt audioInterrupt_ =
         {STREAM_USAGE_UNKNOWN, CONTENT_TYPE_UNKNOWN, AudioStreamType::STREAM_DEFAULT, 0};
      AudioInterrupt sharedInterrupt_ =
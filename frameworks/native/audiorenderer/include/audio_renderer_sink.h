@@ -50,6 +50,7 @@ public:
     int32_t GetVolume(float &left, float &right);
     int32_t GetLatency(uint32_t *latency);
     int32_t GetTransactionId(uint64_t *transactionId);
+    int32_t GetRenderPosition(uint64_t *frames, uint64_t *timeUsec);
     int32_t SetAudioScene(AudioScene audioScene, DeviceType activeDevice);
     int32_t SetOutputRoute(DeviceType deviceType, AudioPortPin &outputPortPin);
     int32_t SetOutputRoute(DeviceType deviceType);
@@ -19,8 +19,11 @@
 #include "audio_info.h"
 #include "audio_proxy_manager.h"
 
+#include <atomic>
 #include <cstdio>
 #include <list>
+#include <mutex>
+#include <vector>
 
 namespace OHOS {
 namespace AudioStandard {
@@ -30,6 +33,8 @@ typedef struct {
     uint32_t sampleRate;
     uint32_t channel;
     float volume;
+    uint32_t batchMsec;
+    uint32_t encoderFrameSamples;
 } BluetoothSinkAttr;
 
 class BluetoothRendererSink {
@@ -47,6 +52,7 @@ public:
     int32_t GetVolume(float &left, float &right);
     int32_t GetLatency(uint32_t *latency);
     int32_t GetTransactionId(uint64_t *transactionId);
+    int32_t GetWriteStats(uint64_t *retries, uint64_t *sleeps);
     static BluetoothRendererSink *GetInstance(void);
     bool rendererInited_;
 private:
@@ -63,8 +69,32 @@ private:
     struct HDI::Audio_Bluetooth::AudioPort audioPort = {};
     void *handle_;
 
+    // Write pacing, touched by the writing thread only except for the reset request, the counters and the flush of
+    // a partial batch, which holds batchMutex_
+    std::atomic<bool> isPacingReset_;
+    uint64_t paceStartUsec_;
+    uint64_t paceWrittenUsec_;
+    uint64_t stackLatencyUsec_;
+    std::atomic<uint64_t> writeRetries_;
+    std::atomic<uint64_t> writeSleeps_;
+
+    // Audio gathered for the next write, batching is off while batchBytes_ is 0
+    std::mutex batchMutex_;
+    std::vector<char> batchBuffer_;
+    uint64_t batchBytes_;
+    std::atomic<uint64_t> batchFill_;
+    std::atomic<bool> isBatchReset_;
+
     int32_t CreateRender(struct HDI::Audio_Bluetooth::AudioPort &renderPort);
     int32_t InitAudioManager();
+    uint64_t BytesToUsec(uint64_t bytes) const;
+    void ResetPacing(uint64_t nowUsec);
+    uint64_t GetQueuedUsec(uint64_t nowUsec);
+    void PaceSleep(uint64_t usec);
+    void InitBatch();
+    int32_t WriteFrame(char *frame, uint64_t len, uint64_t &writeLen);
+    int32_t WriteBatch(char *batch, uint64_t len);
+    void FlushBatch();
 #ifdef BT_DUMPFILE
     FILE *pfd;
 #endif // DUMPFILE
@@ -25,6 +25,8 @@ typedef struct {
     uint32_t sampleRate;
     uint32_t channel;
     float volume;
+    uint32_t batchMsec;
+    uint32_t encoderFrameSamples;
 } BluetoothSinkAttr;
 
 int32_t BluetoothRendererSinkInit(BluetoothSinkAttr *attr);
@@ -37,6 +39,7 @@ int32_t BluetoothRendererRenderFrame(char *data, uint64_t len, uint64_t *writeLe
 int32_t BluetoothRendererSinkSetVolume(float left, float right);
 int32_t BluetoothRendererSinkGetLatency(uint32_t *latency);
 int32_t BluetoothRendererSinkGetTransactionId(uint64_t *transactionId);
+int32_t BluetoothRendererSinkGetWriteStats(uint64_t *retries, uint64_t *sleeps);
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,10 @@ typedef struct {
     uint32_t channel;
     float volume;
     const char *filePath;
+    // Audio gathered into one device write, 0 writes every block as it comes. Honored by the a2dp sink.
+    uint32_t batchMsec;
+    // Samples per frame of the device encoder, batches are rounded up to whole frames. 0 leaves it to the sink.
+    uint32_t encoderFrameSamples;
 } SinkAttr;
 
 struct RendererSinkAdapter {
@@ -47,6 +51,12 @@ struct RendererSinkAdapter {
     int32_t (*RendererSinkSetVolume)(float left, float right);
     int32_t (*RendererSinkGetLatency)(uint32_t *latency);
     int32_t (*RendererSinkGetTransactionId)(uint64_t *transactionId);
+    // Frames played by the device and the monotonic time they were sampled at, NULL if not supported
+    int32_t (*RendererSinkGetRenderPosition)(uint64_t *frames, uint64_t *timeUsec);
+    // Writes retried because the device was busy and sleeps taken to pace writes, NULL if not supported
+    int32_t (*RendererSinkGetWriteStats)(uint64_t *retries, uint64_t *sleeps);
+    // Bytes accepted by RendererRenderFrame but discarded inside the sink, NULL if not supported
+    int32_t (*RendererSinkGetDroppedBytes)(uint64_t *bytes);
 };
 
 int32_t LoadSinkAdapter(const char *device, struct RendererSinkAdapter **sinkAdapter);
@@ -17,6 +17,7 @@
 #include "audio_policy_manager.h"
 #include "audio_renderer_private.h"
 #include "audio_stream.h"
+#include "audio_stream_pool.h"
 #include "audio_log.h"
 
 #include "audio_renderer.h"
@@ -102,6 +103,33 @@ std::unique_ptr<AudioRenderer> AudioRenderer::Create(const std::string cachePath
     return audioRenderer;
 }
 
+int32_t AudioRenderer::SetStreamPoolSize(const AudioRendererOptions &rendererOptions, uint32_t count)
+{
+    ContentType contentType = rendererOptions.rendererInfo.contentType;
+    CHECK_AND_RETURN_RET_LOG(contentType >= CONTENT_TYPE_UNKNOWN && contentType <= CONTENT_TYPE_RINGTONE,
+                             ERR_INVALID_PARAM, "Invalid content type");
+
+    StreamUsage streamUsage = rendererOptions.rendererInfo.streamUsage;
+    CHECK_AND_RETURN_RET_LOG(streamUsage >= STREAM_USAGE_UNKNOWN && streamUsage <= STREAM_USAGE_NOTIFICATION_RINGTONE,
+                             ERR_INVALID_PARAM, "Invalid stream usage");
+
+    AudioStreamPoolKey key;
+    key.streamType = AudioStream::GetStreamType(contentType, streamUsage);
+    key.rendererInfo = rendererOptions.rendererInfo;
+    key.params.format = rendererOptions.streamInfo.format;
+    key.params.samplingRate = rendererOptions.streamInfo.samplingRate;
+    key.params.channels = rendererOptions.streamInfo.channels;
+    key.params.encoding = rendererOptions.streamInfo.encoding;
+    AudioStreamPool::GetInstance().SetPoolSize(key, count);
+
+    return SUCCESS;
+}
+
+void AudioRenderer::GetStreamPoolStats(AudioStreamPoolStats &stats)
+{
+    AudioStreamPool::GetInstance().GetStats(stats);
+}
+
 AudioRendererPrivate::AudioRendererPrivate(AudioStreamType audioStreamType, const AppInfo &appInfo)
 {
     appInfo_ = appInfo;
@@ -167,6 +195,11 @@ int32_t AudioRendererPrivate::GetLatency(uint64_t &latency) const
     return audioStream_->GetLatency(latency);
 }
 
+int32_t AudioRendererPrivate::GetStatistics(AudioStreamStatistics &stats) const
+{
+    return audioStream_->GetStatistics(stats);
+}
+
 int32_t AudioRendererPrivate::SetParams(const AudioRendererParams params)
 {
     AudioStreamParams audioStreamParams;
@@ -179,9 +212,22 @@ int32_t AudioRendererPrivate::SetParams(const AudioRendererParams params)
     audioStreamParams.channels = params.channelCount;
     audioStreamParams.encoding = params.encodingType;
 
-    audioStream_->SetClientID(appInfo_.appPid, appInfo_.appUid);
-
-    int32_t ret = audioStream_->SetAudioStreamInfo(audioStreamParams, rendererProxyObj_);
+    std::shared_ptr<AudioStream> pooledStream = ClaimPooledStream(audioStreamParams);
+    int32_t ret = SUCCESS;
+    if (pooledStream != nullptr) {
+        AUDIO_INFO_LOG("AudioRendererPrivate::SetParams using pooled stream");
+        audioStream_ = pooledStream;
+        // The pool set the stream up without this renderer, apply what was set on the replaced stream
+        audioStream_->SetRendererInfo(rendererInfo_);
+        audioStream_->SetClientID(appInfo_.appPid, appInfo_.appUid);
+        if (!cachePath_.empty()) {
+            audioStream_->SetApplicationCachePath(cachePath_);
+        }
+        audioStream_->RegisterClientTracker(rendererProxyObj_);
+    } else {
+        audioStream_->SetClientID(appInfo_.appPid, appInfo_.appUid);
+        ret = audioStream_->SetAudioStreamInfo(audioStreamParams, rendererProxyObj_);
+    }
 
     AUDIO_INFO_LOG("AudioRendererPrivate::SetParams SetAudioStreamInfo Success");
     if (ret) {
@@ -206,6 +252,22 @@ int32_t AudioRendererPrivate::SetParams(const AudioRendererParams params)
     return AudioPolicyManager::GetInstance().SetAudioInterruptCallback(sessionID_, audioInterruptCallback_);
 }
 
+std::shared_ptr<AudioStream> AudioRendererPrivate::ClaimPooledStream(const AudioStreamParams &audioStreamParams)
+{
+    // Pooled streams belong to this process and have never been handed out. Once the renderer has a stream of
+    // its own, callbacks such as the interrupt callback already refer to it and it must not be swapped.
+    if ((audioStream_->GetState() != NEW) || (audioInterruptCallback_ != nullptr) ||
+        (appInfo_.appPid != getpid()) || (appInfo_.appUid != static_cast<int32_t>(getuid()))) {
+        return nullptr;
+    }
+
+    AudioStreamPoolKey key;
+    key.streamType = audioInterrupt_.streamType;
+    key.rendererInfo = rendererInfo_;
+    key.params = audioStreamParams;
+    return AudioStreamPool::GetInstance().Claim(key);
+}
+
 int32_t AudioRendererPrivate::GetParams(AudioRendererParams &params) const
 {
     AudioStreamParams audioStreamParams;
@@ -358,6 +420,16 @@ int32_t AudioRendererPrivate::Write(uint8_t *buffer, size_t bufferSize)
     return audioStream_->Write(buffer, bufferSize);
 }
 
+int32_t AudioRendererPrivate::AcquireWriteBuffer(BufferDesc &bufDesc) const
+{
+    return audioStream_->AcquireWriteBuffer(bufDesc);
+}
+
+int32_t AudioRendererPrivate::CommitWriteBuffer(size_t length) const
+{
+    return audioStream_->CommitWriteBuffer(length);
+}
+
 RendererState AudioRendererPrivate::GetStatus() const
 {
     return static_cast<RendererState>(audioStream_->GetState());
@@ -378,9 +450,8 @@ bool AudioRendererPrivate::Flush() const
     return audioStream_->FlushAudioStream();
 }
 
-bool AudioRendererPrivate::Pause() const
+void AudioRendererPrivate::DeactivateInterrupt() const
 {
-    bool result = audioStream_->PauseAudioStream();
     AudioInterrupt audioInterrupt;
     switch (mode_) {
         case InterruptMode::SHARE_MODE:
@@ -392,11 +463,17 @@ bool AudioRendererPrivate::Pause() const
         default:
             break;
     }
-    // When user is intentionally pausing , Deactivate to remove from active/pending owners list
+    // When user is intentionally pausing or stopping, Deactivate to remove from active/pending owners list
     int32_t ret = AudioPolicyManager::GetInstance().DeactivateAudioInterrupt(audioInterrupt);
     if (ret != 0) {
         AUDIO_ERR_LOG("AudioRenderer: DeactivateAudioInterrupt Failed");
     }
+}
+
+bool AudioRendererPrivate::Pause() const
+{
+    bool result = audioStream_->PauseAudioStream();
+    DeactivateInterrupt();
 
     return result;
 }
@@ -404,25 +481,46 @@ bool AudioRendererPrivate::Pause() const
 bool AudioRendererPrivate::Stop() const
 {
     bool result = audioStream_->StopAudioStream();
-    AudioInterrupt audioInterrupt;
-    switch (mode_) {
-        case InterruptMode::SHARE_MODE:
-            audioInterrupt = sharedInterrupt_;
-            break;
-        case InterruptMode::INDEPENDENT_MODE:
-            audioInterrupt = audioInterrupt_;
-            break;
-        default:
-            break;
-    }
-    int32_t ret = AudioPolicyManager::GetInstance().DeactivateAudioInterrupt(audioInterrupt);
-    if (ret != 0) {
-        AUDIO_ERR_LOG("AudioRenderer: DeactivateAudioInterrupt Failed");
-    }
+    DeactivateInterrupt();
 
     return result;
 }
 
+static StreamOperationCallback ToStreamOperationCallback(
+    const std::shared_ptr<AudioRendererOperationCallback> &callback)
+{
+    if (callback == nullptr) {
+        return nullptr;
+    }
+    return [callback](bool success) { callback->OnOperationComplete(success); };
+}
+
+int32_t AudioRendererPrivate::DrainAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const
+{
+    return audioStream_->DrainAudioStreamAsync(ToStreamOperationCallback(callback));
+}
+
+int32_t AudioRendererPrivate::FlushAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const
+{
+    return audioStream_->FlushAudioStreamAsync(ToStreamOperationCallback(callback));
+}
+
+int32_t AudioRendererPrivate::PauseAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const
+{
+    int32_t ret = audioStream_->PauseAudioStreamAsync(ToStreamOperationCallback(callback));
+    DeactivateInterrupt();
+
+    return ret;
+}
+
+int32_t AudioRendererPrivate::StopAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const
+{
+    int32_t ret = audioStream_->StopAudioStreamAsync(ToStreamOperationCallback(callback));
+    DeactivateInterrupt();
+
+    return ret;
+}
+
 bool AudioRendererPrivate::Release() const
 {
     // If Stop call was skipped, Release to take care of Deactivation
@@ -692,6 +790,7 @@ int32_t AudioRendererPrivate::GetBufQueueState(BufferQueueState &bufState) const
 
 void AudioRendererPrivate::SetApplicationCachePath(const std::string cachePath)
 {
+    cachePath_ = cachePath;
     audioStream_->SetApplicationCachePath(cachePath);
 }
 
@@ -15,10 +15,16 @@
 
 #include "audio_renderer_file_sink.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
 #include <cstring>
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <iostream>
+#include <pthread.h>
 #include <string>
 #include <unistd.h>
 
@@ -29,6 +35,39 @@ using namespace std;
 
 namespace OHOS {
 namespace AudioStandard {
+namespace {
+// Audio the ring holds while the storage stalls
+const uint64_t RING_BUFFER_MSEC = 2000;
+const size_t MIN_RING_BUFFER_SIZE = 65536;
+const uint64_t MSEC_PER_SEC = 1000;
+const uint32_t BITS_PER_BYTE = 8;
+// The flush thread runs at least this often, and earlier once a quarter of the ring is filled
+const std::chrono::milliseconds FLUSH_INTERVAL(100);
+const uint64_t FLUSH_THRESHOLD_DIVISOR = 4;
+// File space is reserved ahead of the data in steps of this size, keeping block allocation out of most writes
+const uint64_t PREALLOCATE_STEP = 4 * 1024 * 1024;
+
+const char *WAV_SUFFIX = ".wav";
+const size_t WAV_HEADER_SIZE = 44;
+const uint32_t WAV_FMT_CHUNK_SIZE = 16;
+const uint16_t WAV_FORMAT_PCM = 1;
+const uint32_t WAV_RIFF_HEADER_REST = 36;
+
+void PutLe16(uint8_t *p, uint16_t value)
+{
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8); // 8: second byte
+}
+
+void PutLe32(uint8_t *p, uint32_t value)
+{
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8); // 8: second byte
+    p[2] = static_cast<uint8_t>(value >> 16); // 16: third byte
+    p[3] = static_cast<uint8_t>(value >> 24); // 24: fourth byte
+}
+}
+
 AudioRendererFileSink::AudioRendererFileSink()
 {
 }
@@ -47,41 +86,72 @@ AudioRendererFileSink *AudioRendererFileSink::GetInstance()
 
 void AudioRendererFileSink::DeInit()
 {
-    if (filePtr_ != nullptr) {
-        fclose(filePtr_);
-        filePtr_ = nullptr;
-    }
+    Stop();
 }
 
 void InitAttrs(struct AudioSampleAttributes &attrs)
 {
 }
 
-int32_t AudioRendererFileSink::Init(const char *filePath)
+int32_t AudioRendererFileSink::Init(const FileSinkAttr &attr)
 {
-    filePath_.assign(filePath);
+    attr_ = attr;
+    filePath_.assign(attr.filePath);
+    isWav_ = (filePath_.length() > strlen(WAV_SUFFIX)) &&
+        (filePath_.compare(filePath_.length() - strlen(WAV_SUFFIX), strlen(WAV_SUFFIX), WAV_SUFFIX) == 0);
+
+    size_t ringSize = MIN_RING_BUFFER_SIZE;
+    uint64_t wanted = static_cast<uint64_t>(attr.sampleRate) * attr.channel * attr.bitsPerSample / BITS_PER_BYTE *
+        RING_BUFFER_MSEC / MSEC_PER_SEC;
+    while (ringSize < wanted) {
+        ringSize <<= 1;
+    }
+    ring_.assign(ringSize, 0);
+    readPos_ = 0;
+    writePos_ = 0;
+    droppedBytes_ = 0;
+    AUDIO_INFO_LOG("AudioRendererFileSink: ring %{public}zu bytes, wav %{public}d", ringSize, isWav_);
 
     return SUCCESS;
 }
 
 int32_t AudioRendererFileSink::RenderFrame(char &data, uint64_t len, uint64_t &writeLen)
 {
-    if (filePtr_ == nullptr) {
-        AUDIO_ERR_LOG("Invalid file ptr");
+    if (fd_ < 0) {
+        AUDIO_ERR_LOG("Invalid file descriptor");
         return ERROR;
     }
 
-    size_t writeResult = fwrite((void*)&data, 1, len, filePtr_);
-    if (writeResult != len) {
-        AUDIO_ERR_LOG("Failed to write the file.");
+    uint64_t writePos = writePos_.load(std::memory_order_relaxed);
+    uint64_t pending = writePos - readPos_.load(std::memory_order_acquire);
+    writeLen = len;
+    if (len > ring_.size() - pending) {
+        // Dropping the whole chunk keeps the file frame aligned
+        droppedBytes_.fetch_add(len, std::memory_order_relaxed);
+        if (!isDropping_) {
+            AUDIO_ERR_LOG("AudioRendererFileSink: storage too slow, dropping data");
+            isDropping_ = true;
+        }
+        flushCond_.notify_one();
+        return SUCCESS;
     }
+    isDropping_ = false;
 
-    writeLen = writeResult;
+    size_t index = writePos & (ring_.size() - 1);
+    size_t firstLen = std::min(static_cast<size_t>(len), ring_.size() - index);
+    char *src = &data;
+    std::copy(src, src + firstLen, ring_.begin() + index);
+    std::copy(src + firstLen, src + len, ring_.begin());
+    writePos_.store(writePos + len, std::memory_order_release);
+
+    if (pending + len >= ring_.size() / FLUSH_THRESHOLD_DIVISOR) {
+        flushCond_.notify_one();
+    }
 
     return SUCCESS;
 }
 
-int32_t AudioRendererFileSink::Start(void)
+int32_t AudioRendererFileSink::OpenFile(void)
 {
     char realPath[PATH_MAX + 1] = {0x00};
     std::string rootPath;
@@ -93,30 +163,161 @@ int32_t AudioRendererFileSink::Start(void)
         fileName = filePath_.substr(pos);
     }
 
-    if (filePtr_ == nullptr) {
-        if ((filePath_.length() >= PATH_MAX) || (realpath(rootPath.c_str(), realPath) == nullptr)) {
-            AUDIO_ERR_LOG("AudioRendererFileSink:: Invalid path  errno = %{public}d", errno);
-            return ERROR;
+    if ((filePath_.length() >= PATH_MAX) || (realpath(rootPath.c_str(), realPath) == nullptr)) {
+        AUDIO_ERR_LOG("AudioRendererFileSink:: Invalid path  errno = %{public}d", errno);
+        return ERROR;
+    }
+
+    std::string verifiedPath(realPath);
+    fd_ = open(verifiedPath.append(fileName).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    CHECK_AND_RETURN_RET_LOG(fd_ >= 0, ERROR, "Failed to open file, errno = %{public}d", errno);
+
+    dataBytes_ = 0;
+    preallocatedBytes_ = 0;
+    canPreallocate_ = true;
+    if (isWav_) {
+        // Sizes are filled in on stop
+        WriteWavHeader(0);
+        if (lseek(fd_, WAV_HEADER_SIZE, SEEK_SET) < 0) {
+            AUDIO_ERR_LOG("AudioRendererFileSink: seek past wav header failed, errno = %{public}d", errno);
         }
+    }
+    return SUCCESS;
+}
+
+int32_t AudioRendererFileSink::Start(void)
+{
+    if (fd_ >= 0) {
+        return SUCCESS;
+    }
 
-        std::string verifiedPath(realPath);
-        filePtr_ = fopen(verifiedPath.append(fileName).c_str(), "wb+");
-        CHECK_AND_RETURN_RET_LOG(filePtr_ != nullptr, ERROR, "Failed to open file, errno = %{public}d", errno);
+    int32_t ret = OpenFile();
+    if (ret != SUCCESS) {
+        return ret;
     }
 
+    readPos_ = writePos_.load();
+    isDropping_ = false;
+    isRunning_ = true;
+    flushThread_ = std::thread(&AudioRendererFileSink::FlushLoop, this);
+    pthread_setname_np(flushThread_.native_handle(), "OS_AudioFileWr");
+
     return SUCCESS;
 }
 
 int32_t AudioRendererFileSink::Stop(void)
 {
-    if (filePtr_ != nullptr) {
-        fclose(filePtr_);
-        filePtr_ = nullptr;
+    if (fd_ < 0) {
+        return SUCCESS;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        isRunning_ = false;
+    }
+    flushCond_.notify_one();
+    if (flushThread_.joinable()) {
+        flushThread_.join();
+    }
+
+    if (isWav_) {
+        WriteWavHeader(dataBytes_);
+    }
+    // Space reserved past the end of the data stays allocated after close unless the file is trimmed
+    off_t fileSize = static_cast<off_t>(dataBytes_ + (isWav_ ? WAV_HEADER_SIZE : 0));
+    if (preallocatedBytes_ > 0 && ftruncate(fd_, fileSize) != 0) {
+        AUDIO_ERR_LOG("AudioRendererFileSink: trim failed, errno = %{public}d", errno);
+    }
+    close(fd_);
+    fd_ = -1;
+    AUDIO_INFO_LOG("AudioRendererFileSink: %{public}" PRIu64 " bytes written, %{public}" PRIu64 " dropped",
+        dataBytes_, droppedBytes_.load());
+
     return SUCCESS;
 }
 
+void AudioRendererFileSink::FlushLoop(void)
+{
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (true) {
+        bool isRunning = isRunning_;
+        lock.unlock();
+        // After the stop request this drains whatever was rendered before it
+        WriteOut();
+        lock.lock();
+        if (!isRunning) {
+            break;
+        }
+        flushCond_.wait_for(lock, FLUSH_INTERVAL);
+    }
+}
+
+// Flush thread. Writes out everything queued so far, releasing ring space after each write.
+void AudioRendererFileSink::WriteOut(void)
+{
+    uint64_t readPos = readPos_.load(std::memory_order_relaxed);
+    uint64_t writePos = writePos_.load(std::memory_order_acquire);
+    while (readPos < writePos) {
+        size_t index = readPos & (ring_.size() - 1);
+        size_t len = std::min(static_cast<size_t>(writePos - readPos), ring_.size() - index);
+        Preallocate(dataBytes_ + len);
+        ssize_t ret = write(fd_, ring_.data() + index, len);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            AUDIO_ERR_LOG("AudioRendererFileSink: write failed, errno = %{public}d", errno);
+            droppedBytes_.fetch_add(writePos - readPos, std::memory_order_relaxed);
+            readPos = writePos;
+        } else {
+            readPos += static_cast<uint64_t>(ret);
+            dataBytes_ += static_cast<uint64_t>(ret);
+        }
+        readPos_.store(readPos, std::memory_order_release);
+    }
+}
+
+// Flush thread. Reserves file space ahead of the data. File systems without support are left to allocate on write.
+void AudioRendererFileSink::Preallocate(uint64_t size)
+{
+    if (!canPreallocate_ || size <= preallocatedBytes_) {
+        return;
+    }
+
+    uint64_t offset = preallocatedBytes_ + (isWav_ ? WAV_HEADER_SIZE : 0);
+    if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(PREALLOCATE_STEP)) != 0) {
+        AUDIO_INFO_LOG("AudioRendererFileSink: no preallocation, errno = %{public}d", errno);
+        canPreallocate_ = false;
+        return;
+    }
+    preallocatedBytes_ += PREALLOCATE_STEP;
+}
+
+void AudioRendererFileSink::WriteWavHeader(uint64_t dataBytes)
+{
+    uint8_t header[WAV_HEADER_SIZE] = {0};
+    uint32_t dataSize = static_cast<uint32_t>(std::min<uint64_t>(dataBytes, UINT32_MAX - WAV_RIFF_HEADER_REST));
+    uint16_t blockAlign = static_cast<uint16_t>(attr_.channel * attr_.bitsPerSample / BITS_PER_BYTE);
+
+    uint8_t *p = header;
+    (void)memcpy(p, "RIFF", 4); // 4: chunk id size
+    PutLe32(p + 4, WAV_RIFF_HEADER_REST + dataSize); // 4: riff size offset
+    (void)memcpy(p + 8, "WAVEfmt ", 8); // 8: wave id and fmt chunk id offset and size
+    PutLe32(p + 16, WAV_FMT_CHUNK_SIZE); // 16: fmt chunk size offset
+    PutLe16(p + 20, WAV_FORMAT_PCM); // 20: format tag offset
+    PutLe16(p + 22, static_cast<uint16_t>(attr_.channel)); // 22: channels offset
+    PutLe32(p + 24, attr_.sampleRate); // 24: sample rate offset
+    PutLe32(p + 28, attr_.sampleRate * blockAlign); // 28: byte rate offset
+    PutLe16(p + 32, blockAlign); // 32: block align offset
+    PutLe16(p + 34, static_cast<uint16_t>(attr_.bitsPerSample)); // 34: bits per sample offset
+    (void)memcpy(p + 36, "data", 4); // 36: data chunk id offset, 4: its size
+    PutLe32(p + 40, dataSize); // 40: data size offset
+
+    if (pwrite(fd_, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        AUDIO_ERR_LOG("AudioRendererFileSink: write wav header failed, errno = %{public}d", errno);
+    }
+}
+
 int32_t AudioRendererFileSink::Pause(void)
 {
     return SUCCESS;
@@ -137,6 +338,17 @@ int32_t AudioRendererFileSink::Flush(void)
     return SUCCESS;
 }
 
+int32_t AudioRendererFileSink::GetDroppedBytes(uint64_t *bytes)
+{
+    if (!bytes) {
+        AUDIO_ERR_LOG("AudioRendererFileSink: GetDroppedBytes failed param null");
+        return ERR_INVALID_PARAM;
+    }
+
+    *bytes = droppedBytes_.load(std::memory_order_relaxed);
+    return SUCCESS;
+}
+
 int32_t AudioRendererFileSink::SetVolume(float left, float right)
 {
     return ERR_NOT_SUPPORTED;
@@ -163,9 +375,14 @@ using namespace OHOS::AudioStandard;
 
 AudioRendererFileSink *g_fileSinkInstance = AudioRendererFileSink::GetInstance();
 
-int32_t AudioRendererFileSinkInit(const char *filePath)
+int32_t AudioRendererFileSinkInit(const FileSinkAttr *attr)
 {
-    return g_fileSinkInstance->Init(filePath);
+    if (attr == nullptr || attr->filePath == nullptr) {
+        AUDIO_ERR_LOG("AudioRendererFileSinkInit invalid attr");
+        return ERR_INVALID_PARAM;
+    }
+
+    return g_fileSinkInstance->Init(*attr);
 }
 
 void AudioRendererFileSinkDeInit()
@@ -212,6 +429,11 @@ int32_t AudioRendererFileSinkGetTransactionId(uint64_t *transactionId)
 {
     return g_fileSinkInstance->GetTransactionId(transactionId);
 }
+
+int32_t AudioRendererFileSinkGetDroppedBytes(uint64_t *bytes)
+{
+    return g_fileSinkInstance->GetDroppedBytes(bytes);
+}
 #ifdef __cplusplus
 }
 #endif
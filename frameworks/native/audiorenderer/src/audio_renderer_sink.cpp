@@ -39,6 +39,8 @@ const uint32_t PCM_16_BIT = 16;
 const uint32_t PCM_24_BIT = 24;
 const uint32_t PCM_32_BIT = 32;
 const uint32_t INTERNAL_OUTPUT_STREAM_ID = 0;
+const uint64_t USEC_PER_SEC = 1000000;
+const uint64_t NSEC_PER_USEC = 1000;
 }
 
 #ifdef DUMPFILE
@@ -510,6 +512,27 @@ int32_t AudioRendererSink::GetTransactionId(uint64_t *transactionId)
     return SUCCESS;
 }
 
+int32_t AudioRendererSink::GetRenderPosition(uint64_t *frames, uint64_t *timeUsec)
+{
+    if (audioRender_ == nullptr) {
+        AUDIO_ERR_LOG("AudioRendererSink: GetRenderPosition failed audio render null");
+        return ERR_INVALID_HANDLE;
+    }
+
+    if (!frames || !timeUsec) {
+        AUDIO_ERR_LOG("AudioRendererSink: GetRenderPosition failed param null");
+        return ERR_INVALID_PARAM;
+    }
+
+    struct AudioTimeStamp timestamp = {};
+    if (audioRender_->GetRenderPosition(audioRender_, frames, &timestamp) != 0) {
+        return ERR_OPERATION_FAILED;
+    }
+    *timeUsec = static_cast<uint64_t>(timestamp.tvSec) * USEC_PER_SEC +
+        static_cast<uint64_t>(timestamp.tvNSec) / NSEC_PER_USEC;
+    return SUCCESS;
+}
+
 int32_t AudioRendererSink::Stop(void)
 {
     int32_t ret;
@@ -751,6 +774,15 @@ int32_t AudioRendererSinkGetTransactionId(uint64_t *transactionId)
 
     return g_audioRendrSinkInstance->GetTransactionId(transactionId);
 }
+
+int32_t AudioRendererSinkGetRenderPosition(uint64_t *frames, uint64_t *timeUsec)
+{
+    if (!g_audioRendrSinkInstance->rendererInited_) {
+        return ERR_NOT_STARTED;
+    }
+
+    return g_audioRendrSinkInstance->GetRenderPosition(frames, timeUsec);
+}
 #ifdef __cplusplus
 }
 #endif
@@ -15,7 +15,10 @@
 
 #include "bluetooth_renderer_sink.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstring>
+#include <ctime>
 #include <dlfcn.h>
 #include <string>
 #include <unistd.h>
@@ -36,11 +39,26 @@ const uint32_t AUDIO_CHANNELCOUNT = 2;
 const uint32_t AUDIO_SAMPLE_RATE_48K = 48000;
 const uint32_t DEEP_BUFFER_RENDER_PERIOD_SIZE = 4096;
 const uint32_t RENDER_FRAME_INTERVAL_IN_MICROSECONDS = 10000;
+const uint64_t MIN_RETRY_SLEEP_IN_MICROSECONDS = 1000;
+// One frame playing and one waiting keeps the link fed without letting the stack buffer grow
+const uint64_t PACING_TARGET_FRAMES = 2;
+const int32_t RENDER_FRAME_BUSY = -4;
+// Each busy wait is at most one render interval, a stack that stays full this long is treated as a failed write
+const uint32_t MAX_RENDER_FRAME_BUSY_RETRIES = 20;
+const uint64_t USEC_PER_SEC = 1000000;
+const uint64_t USEC_PER_MSEC = 1000;
+const uint64_t NSEC_PER_USEC = 1000;
+// Batches are whole encoder frames. Unless the module configures the codec frame, they are whole AAC frames,
+// which are also whole SBC frames of 128 samples.
+const uint32_t DEFAULT_ENCODER_FRAME_SAMPLES = 1024;
+const uint32_t MSEC_PER_SEC = 1000;
 const uint32_t INT_32_MAX = 0x7fffffff;
 const uint32_t PCM_8_BIT = 8;
 const uint32_t PCM_16_BIT = 16;
 const uint32_t PCM_24_BIT = 24;
 const uint32_t PCM_32_BIT = 32;
+// 8-bit PCM is unsigned, its silence is the mid-scale value
+const uint8_t PCM_8_BIT_SILENCE = 0x80;
 }
 
 #ifdef BT_DUMPFILE
@@ -53,6 +71,15 @@ BluetoothRendererSink::BluetoothRendererSink()
       audioRender_(nullptr), handle_(nullptr)
 {
     attr_ = {};
+    isPacingReset_ = true;
+    paceStartUsec_ = 0;
+    paceWrittenUsec_ = 0;
+    stackLatencyUsec_ = 0;
+    writeRetries_ = 0;
+    writeSleeps_ = 0;
+    batchBytes_ = 0;
+    batchFill_ = 0;
+    isBatchReset_ = false;
 #ifdef BT_DUMPFILE
     pfd = nullptr;
 #endif // BT_DUMPFILE
@@ -269,7 +296,10 @@ int32_t BluetoothRendererSink::Init(const BluetoothSinkAttr &attr)
         return ERR_NOT_STARTED;
     }
 
+    InitBatch();
     rendererInited_ = true;
+    writeRetries_ = 0;
+    writeSleeps_ = 0;
 
 #ifdef BT_DUMPFILE
     pfd = fopen(g_audioOutTestFilePath, "wb+");
@@ -281,9 +311,133 @@ int32_t BluetoothRendererSink::Init(const BluetoothSinkAttr &attr)
     return SUCCESS;
 }
 
-int32_t BluetoothRendererSink::RenderFrame(char &data, uint64_t len, uint64_t &writeLen)
+void BluetoothRendererSink::InitBatch()
+{
+    uint32_t frameSize = PcmFormatToBits(attr_.format) * attr_.channel / PCM_8_BIT;
+    uint32_t encoderFrameSamples = (attr_.encoderFrameSamples != 0) ? attr_.encoderFrameSamples :
+        DEFAULT_ENCODER_FRAME_SAMPLES;
+    uint64_t batchFrames = static_cast<uint64_t>(attr_.sampleRate) * attr_.batchMsec / MSEC_PER_SEC;
+    batchFrames = (batchFrames + encoderFrameSamples - 1) / encoderFrameSamples * encoderFrameSamples;
+    batchBytes_ = batchFrames * frameSize;
+    batchBuffer_.assign(batchBytes_, 0);
+    batchFill_ = 0;
+    isBatchReset_ = false;
+    AUDIO_INFO_LOG("BluetoothRendererSink: batch %{public}" PRIu64 " bytes for %{public}u ms, encoder frame "
+        "%{public}u samples", batchBytes_, attr_.batchMsec, encoderFrameSamples);
+}
+
+static uint64_t GetNowUsec()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * USEC_PER_SEC + static_cast<uint64_t>(ts.tv_nsec) / NSEC_PER_USEC;
+}
+
+uint64_t BluetoothRendererSink::BytesToUsec(uint64_t bytes) const
+{
+    uint32_t frameSize = PcmFormatToBits(attr_.format) * attr_.channel / PCM_8_BIT;
+    if (frameSize == 0 || attr_.sampleRate == 0) {
+        return 0;
+    }
+    return bytes / frameSize * USEC_PER_SEC / attr_.sampleRate;
+}
+
+// Restarts the model of what the stack holds. The latency the stack reports is its own buffering, which is kept
+// filled on top of the pacing target.
+void BluetoothRendererSink::ResetPacing(uint64_t nowUsec)
+{
+    uint32_t hdiLatency = 0;
+    stackLatencyUsec_ = (audioRender_->GetLatency(audioRender_, &hdiLatency) == 0) ? hdiLatency * USEC_PER_MSEC : 0;
+    paceStartUsec_ = nowUsec;
+    paceWrittenUsec_ = 0;
+}
+
+// Audio handed to the stack and not played yet, assuming the stack plays in real time since pacing restarted
+uint64_t BluetoothRendererSink::GetQueuedUsec(uint64_t nowUsec)
+{
+    uint64_t elapsed = nowUsec - paceStartUsec_;
+    if (elapsed >= paceWrittenUsec_) {
+        // The stack ran dry, or the model drifted, start over from here
+        paceStartUsec_ = nowUsec;
+        paceWrittenUsec_ = 0;
+        return 0;
+    }
+    return paceWrittenUsec_ - elapsed;
+}
+
+void BluetoothRendererSink::PaceSleep(uint64_t usec)
+{
+    writeSleeps_++;
+    usleep(static_cast<useconds_t>(usec));
+}
+
+// One paced write into the stack
+int32_t BluetoothRendererSink::WriteFrame(char *frame, uint64_t len, uint64_t &writeLen)
 {
     int32_t ret = SUCCESS;
+    if (isPacingReset_.exchange(false)) {
+        ResetPacing(GetNowUsec());
+    }
+    uint64_t frameUsec = BytesToUsec(len);
+    uint64_t targetUsec = stackLatencyUsec_ + frameUsec * PACING_TARGET_FRAMES;
+    uint32_t busyRetries = 0;
+
+    while (true) {
+        ret = audioRender_->RenderFrame(audioRender_, (void*)frame, len, &writeLen);
+        AUDIO_DEBUG_LOG("A2dp RenderFrame returns: %{public}x", ret);
+        if (ret == RENDER_FRAME_BUSY && busyRetries++ < MAX_RENDER_FRAME_BUSY_RETRIES) {
+            // The stack is full. Wait for about the excess over the target to play out rather than polling, the
+            // stack accepting less than the model predicts shows up as a higher retry rate.
+            writeRetries_++;
+            uint64_t queued = GetQueuedUsec(GetNowUsec());
+            uint64_t wait = (queued > targetUsec) ? (queued - targetUsec) : (frameUsec / HALF_FACTOR);
+            PaceSleep(std::min(std::max(wait, MIN_RETRY_SLEEP_IN_MICROSECONDS),
+                static_cast<uint64_t>(RENDER_FRAME_INTERVAL_IN_MICROSECONDS)));
+            continue;
+        }
+
+        if (ret != 0) {
+            AUDIO_ERR_LOG("A2dp RenderFrame failed ret: %{public}x", ret);
+            ret = ERR_WRITE_FAILED;
+        }
+
+        break;
+    }
+
+    if (ret == SUCCESS) {
+        uint64_t now = GetNowUsec();
+        uint64_t queued = GetQueuedUsec(now);
+        paceWrittenUsec_ += BytesToUsec(writeLen);
+        queued += BytesToUsec(writeLen);
+        // Sleep only while the stack holds more than the target, and never longer than the frame just written. A
+        // stack that blocks in RenderFrame until it has room stays at the target and is never slept on.
+        if (queued > targetUsec) {
+            PaceSleep(std::min(queued - targetUsec, frameUsec));
+        }
+    }
+
+    return ret;
+}
+
+// Hands a whole batch to the stack. A failed write drops the rest of the batch.
+int32_t BluetoothRendererSink::WriteBatch(char *batch, uint64_t len)
+{
+    uint64_t written = 0;
+    while (written < len) {
+        uint64_t writeLen = 0;
+        int32_t ret = WriteFrame(batch + written, len - written, writeLen);
+        if (ret != SUCCESS || writeLen == 0) {
+            AUDIO_ERR_LOG("BluetoothRendererSink: batch write failed, %{public}" PRIu64 " bytes dropped",
+                len - written);
+            return ERR_WRITE_FAILED;
+        }
+        written += writeLen;
+    }
+    return SUCCESS;
+}
+
+int32_t BluetoothRendererSink::RenderFrame(char &data, uint64_t len, uint64_t &writeLen)
+{
     if (audioRender_ == nullptr) {
         AUDIO_ERR_LOG("Bluetooth Render Handle is nullptr!");
         return ERR_INVALID_HANDLE;
@@ -296,27 +450,83 @@ int32_t BluetoothRendererSink::RenderFrame(char &data, uint64_t len, uint64_t &w
     }
 #endif // BT_DUMPFILE
 
-    while (true) {
-        ret = audioRender_->RenderFrame(audioRender_, (void*)&data, len, &writeLen);
-        AUDIO_DEBUG_LOG("A2dp RenderFrame returns: %{public}x", ret);
-        if (ret == -4) {
-            AUDIO_ERR_LOG("retry render frame...");
-            usleep(RENDER_FRAME_INTERVAL_IN_MICROSECONDS);
+    if (batchBytes_ == 0) {
+        return WriteFrame(&data, len, writeLen);
+    }
+
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    if (isBatchReset_.exchange(false)) {
+        batchFill_ = 0;
+    }
+
+    // Whole batches go to the stack straight from the caller's buffer while nothing is gathered, the rest is
+    // copied. Data that is gathered counts as written, a failed batch write loses that batch only.
+    char *src = &data;
+    uint64_t remaining = len;
+    int32_t ret = SUCCESS;
+    while (remaining > 0 && ret == SUCCESS) {
+        uint64_t fill = batchFill_.load();
+        if (fill == 0 && remaining >= batchBytes_) {
+            ret = WriteBatch(src, batchBytes_);
+            src += batchBytes_;
+            remaining -= batchBytes_;
             continue;
         }
 
-        if (ret != 0) {
-            AUDIO_ERR_LOG("A2dp RenderFrame failed ret: %{public}x", ret);
-            ret = ERR_WRITE_FAILED;
+        uint64_t copyLen = std::min(remaining, batchBytes_ - fill);
+        std::copy(src, src + copyLen, batchBuffer_.begin() + fill);
+        src += copyLen;
+        remaining -= copyLen;
+        fill += copyLen;
+        if (fill == batchBytes_) {
+            ret = WriteBatch(batchBuffer_.data(), batchBytes_);
+            fill = 0;
         }
-
-        break;
+        batchFill_ = fill;
     }
-    usleep(RENDER_FRAME_INTERVAL_IN_MICROSECONDS);
 
+    writeLen = len - remaining;
     return ret;
 }
 
+// Called on the IO thread before pausing or stopping. Audio gathered so far would otherwise wait for data that may
+// never come, so it goes out as a whole batch padded with silence. The IO thread does not wait for a writer that is
+// in the middle of a write, the partial batch is dropped instead.
+void BluetoothRendererSink::FlushBatch()
+{
+    if (batchBytes_ == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(batchMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        AUDIO_INFO_LOG("BluetoothRendererSink: writer busy, partial batch dropped");
+        isBatchReset_ = true;
+        return;
+    }
+    uint64_t fill = isBatchReset_.exchange(false) ? 0 : batchFill_.load();
+    if (fill == 0) {
+        return;
+    }
+
+    char silence = (attr_.format == AUDIO_FORMAT_PCM_8_BIT) ? static_cast<char>(PCM_8_BIT_SILENCE) : 0;
+    std::fill(batchBuffer_.begin() + fill, batchBuffer_.end(), silence);
+    WriteBatch(batchBuffer_.data(), batchBytes_);
+    batchFill_ = 0;
+}
+
+int32_t BluetoothRendererSink::GetWriteStats(uint64_t *retries, uint64_t *sleeps)
+{
+    if (!retries || !sleeps) {
+        AUDIO_ERR_LOG("BluetoothRendererSink: GetWriteStats failed param null");
+        return ERR_INVALID_PARAM;
+    }
+
+    *retries = writeRetries_.load();
+    *sleeps = writeSleeps_.load();
+    return SUCCESS;
+}
+
 int32_t BluetoothRendererSink::Start(void)
 {
     int32_t ret;
@@ -325,6 +535,7 @@ int32_t BluetoothRendererSink::Start(void)
         ret = audioRender_->control.Start(reinterpret_cast<AudioHandle>(audioRender_));
         if (!ret) {
             started_ = true;
+            isPacingReset_ = true;
             return SUCCESS;
         } else {
             AUDIO_ERR_LOG("BluetoothRendererSink::Start failed!");
@@ -384,7 +595,8 @@ int32_t BluetoothRendererSink::GetLatency(uint32_t *latency)
 
     uint32_t hdiLatency;
     if (audioRender_->GetLatency(audioRender_, &hdiLatency) == 0) {
-        *latency = hdiLatency;
+        // Gathered audio waits for the rest of its batch on top of the stack latency
+        *latency = hdiLatency + static_cast<uint32_t>(BytesToUsec(batchFill_.load()) / USEC_PER_MSEC);
         return SUCCESS;
     } else {
         return ERR_OPERATION_FAILED;
@@ -420,12 +632,16 @@ int32_t BluetoothRendererSink::Stop(void)
     }
 
     if (started_) {
+        if (!paused_) {
+            FlushBatch();
+        }
         AUDIO_INFO_LOG("BluetoothRendererSink::Stop control before");
         ret = audioRender_->control.Stop(reinterpret_cast<AudioHandle>(audioRender_));
         AUDIO_INFO_LOG("BluetoothRendererSink::Stop control after");
         if (!ret) {
             started_ = false;
             paused_ = false;
+            isBatchReset_ = true;
             return SUCCESS;
         } else {
             AUDIO_ERR_LOG("BluetoothRendererSink::Stop failed!");
@@ -451,6 +667,7 @@ int32_t BluetoothRendererSink::Pause(void)
     }
 
     if (!paused_) {
+        FlushBatch();
         ret = audioRender_->control.Pause(reinterpret_cast<AudioHandle>(audioRender_));
         if (!ret) {
             paused_ = true;
@@ -482,6 +699,7 @@ int32_t BluetoothRendererSink::Resume(void)
         ret = audioRender_->control.Resume(reinterpret_cast<AudioHandle>(audioRender_));
         if (!ret) {
             paused_ = false;
+            isPacingReset_ = true;
             return SUCCESS;
         } else {
             AUDIO_ERR_LOG("BluetoothRendererSink::Resume failed!");
@@ -499,6 +717,8 @@ int32_t BluetoothRendererSink::Reset(void)
     if (started_ && audioRender_ != nullptr) {
         ret = audioRender_->control.Flush(reinterpret_cast<AudioHandle>(audioRender_));
         if (!ret) {
+            isPacingReset_ = true;
+            isBatchReset_ = true;
             return SUCCESS;
         } else {
             AUDIO_ERR_LOG("BluetoothRendererSink::Reset failed!");
@@ -516,6 +736,8 @@ int32_t BluetoothRendererSink::Flush(void)
     if (started_ && audioRender_ != nullptr) {
         ret = audioRender_->control.Flush(reinterpret_cast<AudioHandle>(audioRender_));
         if (!ret) {
+            isPacingReset_ = true;
+            isBatchReset_ = true;
             return SUCCESS;
         } else {
             AUDIO_ERR_LOG("BluetoothRendererSink::Flush failed!");
@@ -655,6 +877,15 @@ int32_t BluetoothRendererSinkGetTransactionId(uint64_t *transactionId)
 
     return g_bluetoothRendrSinkInstance->GetTransactionId(transactionId);
 }
+
+int32_t BluetoothRendererSinkGetWriteStats(uint64_t *retries, uint64_t *sleeps)
+{
+    if (!g_bluetoothRendrSinkInstance->rendererInited_) {
+        return ERR_NOT_STARTED;
+    }
+
+    return g_bluetoothRendrSinkInstance->GetWriteStats(retries, sleeps);
+}
 #ifdef __cplusplus
 }
 #endif
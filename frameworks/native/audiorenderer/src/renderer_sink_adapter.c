@@ -33,12 +33,31 @@ const int32_t CLASS_TYPE_PRIMARY = 0;
 const int32_t CLASS_TYPE_A2DP = 1;
 const int32_t CLASS_TYPE_FILE = 2;
 
+const uint32_t PCM_8_BIT = 8;
+const uint32_t PCM_16_BIT = 16;
+const uint32_t PCM_24_BIT = 24;
+const uint32_t PCM_32_BIT = 32;
+
 const char *g_deviceClassPrimary = "primary";
 const char *g_deviceClassA2Dp = "a2dp";
 const char *g_deviceClassFile = "file_io";
 
 int32_t g_deviceClass = -1;
 
+static uint32_t PcmFormatToBits(enum AudioFormat format)
+{
+    switch (format) {
+        case AUDIO_FORMAT_PCM_8_BIT:
+            return PCM_8_BIT;
+        case AUDIO_FORMAT_PCM_24_BIT:
+            return PCM_24_BIT;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            return PCM_32_BIT;
+        default:
+            return PCM_16_BIT;
+    }
+}
+
 static int32_t RendererSinkInitInner(const SinkAttr *attr)
 {
     if (attr == NULL) {
@@ -62,10 +81,17 @@ static int32_t RendererSinkInitInner(const SinkAttr *attr)
         bluetoothSinkAttr.sampleRate = attr->sampleRate;
         bluetoothSinkAttr.channel = attr->channel;
         bluetoothSinkAttr.volume = attr->volume;
+        bluetoothSinkAttr.batchMsec = attr->batchMsec;
+        bluetoothSinkAttr.encoderFrameSamples = attr->encoderFrameSamples;
         return BluetoothRendererSinkInit(&bluetoothSinkAttr);
     } else if (g_deviceClass == CLASS_TYPE_FILE) {
         AUDIO_INFO_LOG("%{public}s: CLASS_TYPE_FILE", __func__);
-        return AudioRendererFileSinkInit(attr->filePath);
+        FileSinkAttr fileSinkAttr;
+        fileSinkAttr.filePath = attr->filePath;
+        fileSinkAttr.sampleRate = attr->sampleRate;
+        fileSinkAttr.channel = attr->channel;
+        fileSinkAttr.bitsPerSample = PcmFormatToBits(attr->format);
+        return AudioRendererFileSinkInit(&fileSinkAttr);
     } else {
         AUDIO_ERR_LOG("%{public}s: Device not supported", __func__);
         return ERROR;
@@ -97,6 +123,7 @@ int32_t LoadSinkAdapter(const char *device, struct RendererSinkAdapter **sinkAda
         adapter->RendererSinkSetVolume = AudioRendererSinkSetVolume;
         adapter->RendererSinkGetLatency = AudioRendererSinkGetLatency;
         adapter->RendererSinkGetTransactionId = AudioRendererSinkGetTransactionId;
+        adapter->RendererSinkGetRenderPosition = AudioRendererSinkGetRenderPosition;
         g_deviceClass = CLASS_TYPE_PRIMARY;
     } else if (!strcmp(device, g_deviceClassA2Dp)) {
         adapter->RendererSinkInit = RendererSinkInitInner;
@@ -109,6 +136,7 @@ int32_t LoadSinkAdapter(const char *device, struct RendererSinkAdapter **sinkAda
         adapter->RendererSinkSetVolume = BluetoothRendererSinkSetVolume;
         adapter->RendererSinkGetLatency = BluetoothRendererSinkGetLatency;
         adapter->RendererSinkGetTransactionId = BluetoothRendererSinkGetTransactionId;
+        adapter->RendererSinkGetWriteStats = BluetoothRendererSinkGetWriteStats;
         g_deviceClass = CLASS_TYPE_A2DP;
     } else if (!strcmp(device, g_deviceClassFile)) {
         adapter->RendererSinkInit = RendererSinkInitInner;
@@ -121,6 +149,7 @@ int32_t LoadSinkAdapter(const char *device, struct RendererSinkAdapter **sinkAda
         adapter->RendererSinkSetVolume = AudioRendererFileSinkSetVolume;
         adapter->RendererSinkGetLatency = AudioRendererFileSinkGetLatency;
         adapter->RendererSinkGetTransactionId = AudioRendererFileSinkGetTransactionId;
+        adapter->RendererSinkGetDroppedBytes = AudioRendererFileSinkGetDroppedBytes;
         g_deviceClass = CLASS_TYPE_FILE;
     } else {
         AUDIO_ERR_LOG("%{public}s: Device not supported", __func__);
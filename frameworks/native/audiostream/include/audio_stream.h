@@ -15,6 +15,11 @@
 #ifndef AUDIO_STREAM_H
 #define AUDIO_STREAM_H
 
+#include <condition_variable>
+#include <mutex>
+
+#include "audio_buffer_queue.h"
+#include "audio_format_converter.h"
 #include "audio_info.h"
 #include "audio_session.h"
 #include "timestamp.h"
@@ -33,6 +38,7 @@ public:
     void SetCapturerInfo(const AudioCapturerInfo &capturerInfo);
     int32_t SetAudioStreamInfo(const AudioStreamParams info,
         const std::shared_ptr<AudioClientTracker> &proxyObj);
+    void RegisterClientTracker(const std::shared_ptr<AudioClientTracker> &proxyObj);
     int32_t GetAudioStreamInfo(AudioStreamParams &info);
     bool VerifyClientPermission(const std::string &permissionName, uint32_t appTokenId, int32_t appUid);
 
@@ -42,7 +48,9 @@ public:
     int32_t GetBufferSize(size_t &bufferSize) const;
     int32_t GetFrameCount(uint32_t &frameCount) const;
     int32_t GetLatency(uint64_t &latency);
+    int32_t GetStatistics(AudioStreamStatistics &stats);
     static AudioStreamType GetStreamType(ContentType contentType, StreamUsage streamUsage);
+    static bool IsDeepBufferStream(const AudioRendererInfo &rendererInfo);
     int32_t SetAudioStreamType(AudioStreamType audioStreamType);
     int32_t SetVolume(float volume);
     float GetVolume();
@@ -71,32 +79,54 @@ public:
     bool ReleaseAudioStream();
     bool FlushAudioStream();
 
+    // Asynchronous variants, the callback runs on the AudioCallbackExecutor thread once the server completes
+    int32_t PauseAudioStreamAsync(const StreamOperationCallback &callback);
+    int32_t StopAudioStreamAsync(const StreamOperationCallback &callback);
+    int32_t FlushAudioStreamAsync(const StreamOperationCallback &callback);
+    int32_t DrainAudioStreamAsync(const StreamOperationCallback &callback);
+
     // Playback related APIs
     bool DrainAudioStream();
     size_t Write(uint8_t *buffer, size_t buffer_size);
+    int32_t AcquireWriteBuffer(BufferDesc &bufDesc);
+    int32_t CommitWriteBuffer(size_t length);
 
     // Recording related APIs
     int32_t Read(uint8_t &buffer, size_t userSize, bool isBlockingRead);
+    int32_t AcquireReadBuffer(BufferDesc &bufDesc);
+    int32_t ReleaseReadBuffer();
 private:
     AudioStreamType eStreamType_;
     AudioMode eMode_;
     State state_;
     std::atomic<bool> isReadInProgress_;
     std::atomic<bool> isWriteInProgress_;
+    std::mutex ioMutex_;
+    std::condition_variable ioIdleCond_;
     bool resetTime_;
     uint64_t resetTimestamp_;
     struct timespec baseTimestamp_ = {0};
     AudioRenderMode renderMode_;
     AudioCaptureMode captureMode_;
-    std::queue<BufferDesc> freeBufferQ_;
-    std::queue<BufferDesc> filledBufferQ_;
+    AudioBufferQueue freeBufferQ_ {MAX_NUM_BUFFERS};
+    AudioBufferQueue filledBufferQ_ {MAX_NUM_BUFFERS};
+    std::mutex bufferQueueMutex_;
+    std::condition_variable bufferQueueCond_;
     std::array<std::unique_ptr<uint8_t[]>, MAX_NUM_BUFFERS> bufferPool_ = {};
     std::unique_ptr<std::thread> writeThread_ = nullptr;
     std::unique_ptr<std::thread> readThread_ = nullptr;
-    bool isReadyToWrite_;
-    bool isReadyToRead_;
+    std::atomic<bool> isReadyToWrite_;
+    std::atomic<bool> isReadyToRead_;
     void WriteBuffers();
     void ReadBuffers();
+    bool WaitForBuffers(const AudioBufferQueue &bufferQ, const std::atomic<bool> &isReady);
+    bool WaitForRetry(const std::atomic<bool> &isReady, uint32_t &delayMs);
+    void NotifyBufferQueue();
+    void StopBufferThread(std::atomic<bool> &isReady, std::unique_ptr<std::thread> &bufferThread);
+    void ClearBufferQueues();
+    void EndIo(std::atomic<bool> &isInProgress);
+    void StopDataPath();
+    void SignalDataPathStop();
     std::unique_ptr<AudioStreamTracker> audioStreamTracker_;
     AudioRendererInfo rendererInfo_;
     AudioCapturerInfo capturerInfo_;
@@ -106,6 +136,16 @@ private:
     static std::map<std::pair<ContentType, StreamUsage>, AudioStreamType> CreateStreamMap();
     bool isFirstRead_;
     bool isFirstWrite_;
+
+    // Set when the application format has to be converted before it reaches pulseaudio
+    AudioSampleFormat appFormat_ = SAMPLE_S16LE;
+    AudioSampleFormat streamFormat_ = SAMPLE_S16LE;
+    std::unique_ptr<AudioFormatConverter> formatConverter_ = nullptr;
+    std::vector<uint8_t> convertBuffer_;
+    static AudioSampleFormat GetStreamFormat(AudioSampleFormat appFormat);
+    size_t ToAppBytes(size_t streamBytes) const;
+    int32_t ConvertToStreamFormat(StreamBuffer &stream);
+    int32_t ReadInAppFormat(StreamBuffer &stream, bool isBlockingRead);
 };
 } // namespace AudioStandard
 } // namespace OHOS
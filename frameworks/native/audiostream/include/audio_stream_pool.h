@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_STREAM_POOL_H
+#define AUDIO_STREAM_POOL_H
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "audio_info.h"
+#include "audio_stream.h"
+
+namespace OHOS {
+namespace AudioStandard {
+struct AudioStreamPoolKey {
+    AudioStreamType streamType = STREAM_DEFAULT;
+    AudioRendererInfo rendererInfo;
+    AudioStreamParams params = {};
+
+    bool operator<(const AudioStreamPoolKey &other) const
+    {
+        return std::tie(streamType, rendererInfo.contentType, rendererInfo.streamUsage, rendererInfo.rendererFlags,
+            params.samplingRate, params.encoding, params.format, params.channels) <
+            std::tie(other.streamType, other.rendererInfo.contentType, other.rendererInfo.streamUsage,
+            other.rendererInfo.rendererFlags, other.params.samplingRate, other.params.encoding, other.params.format,
+            other.params.channels);
+    }
+};
+
+/**
+ * Process wide pool of prepared, corked playback streams.
+ *
+ * Applications opt in per renderer configuration with SetPoolSize. A refill thread keeps that many streams
+ * connected to the server, so creating a renderer with the same configuration only takes a pooled stream
+ * instead of the synchronous stream setup. Pooled streams are registered with the stream tracker only once
+ * they are claimed. Nothing is pooled, and no thread is started, until SetPoolSize is called.
+ */
+class AudioStreamPool {
+public:
+    static AudioStreamPool &GetInstance();
+
+    /**
+    * Sets how many streams are kept ready for a configuration
+    *
+    * @param key the stream type, renderer info and stream parameters of the pooled streams
+    * @param count number of streams to keep ready, 0 stops pooling and releases the pooled streams
+    */
+    void SetPoolSize(const AudioStreamPoolKey &key, uint32_t count);
+
+    /**
+    * Takes a prepared stream out of the pool and schedules a refill
+    *
+    * @param key the configuration of the renderer being created
+    * @return Returns a stream in PREPARED state; returns {@code nullptr} if none is ready.
+    */
+    std::shared_ptr<AudioStream> Claim(const AudioStreamPoolKey &key);
+
+    void GetStats(AudioStreamPoolStats &stats);
+
+private:
+    AudioStreamPool() = default;
+    ~AudioStreamPool();
+
+    AudioStreamPool(const AudioStreamPool &) = delete;
+    AudioStreamPool &operator=(const AudioStreamPool &) = delete;
+
+    struct PoolEntry {
+        uint32_t targetSize = 0;
+        std::vector<std::shared_ptr<AudioStream>> streams;
+    };
+
+    void RefillLoop();
+    bool FindShortEntry(AudioStreamPoolKey &key);
+    int32_t CreatePooledStream(const AudioStreamPoolKey &key, std::shared_ptr<AudioStream> &stream);
+
+    std::mutex poolMutex_;
+    std::condition_variable refillCond_;
+    std::map<AudioStreamPoolKey, PoolEntry> pool_;
+    bool isRunning_ = true;
+    std::thread refillThread_;
+
+    uint64_t hitCount_ = 0;
+    uint64_t missCount_ = 0;
+    uint64_t setupCount_ = 0;
+    uint64_t setupTotalUsec_ = 0;
+    uint64_t setupTimeSavedUsec_ = 0;
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_STREAM_POOL_H
@@ -24,40 +24,118 @@
 #include <audio_manager.h>
 #include <renderer_sink_adapter.h>
 
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
 #include <pulse/rtclock.h>
 #include <pulse/timeval.h>
 #include <pulse/util.h>
 #include <pulse/xmalloc.h>
 
+#include <pulsecore/asyncq.h>
 #include <pulsecore/core-util.h>
 #include <pulsecore/log.h>
 #include <pulsecore/macro.h>
 #include <pulsecore/rtpoll.h>
+#include <pulsecore/sample-util.h>
 #include <pulsecore/thread-mq.h>
 #include <pulsecore/thread.h>
 
 #include "audio_log.h"
+#include "hdi_thread_util.h"
 
 #define DEFAULT_SINK_NAME "hdi_output"
 #define DEFAULT_AUDIO_DEVICE_NAME "Speaker"
 #define DEFAULT_DEVICE_CLASS "primary"
 #define DEFAULT_BUFFER_SIZE 8192
 #define MAX_SINK_VOLUME_LEVEL 1.0
+#define RENDER_STATS_INTERVAL_USEC (5 * PA_USEC_PER_SEC)
+#define PERCENT 100.0
+#define PROP_RENDER_WAKEUPS "hdi.render.wakeups_per_sec"
+#define PROP_RENDER_CPU_LOAD "hdi.render.cpu_load"
+#define PROP_RENDER_BLOCK "hdi.render.block_msec"
+#define PROP_RENDER_QUEUE_DEPTH "hdi.render.queue_depth"
+#define PROP_RENDER_QUEUE_FILL "hdi.render.queue_fill"
+#define PROP_RENDER_QUEUE_PEAK "hdi.render.queue_peak"
+#define PROP_RENDER_RATE_RATIO "hdi.render.rate_ratio"
+#define PROP_RENDER_WRITE_RETRIES "hdi.render.write_retries_per_sec"
+#define PROP_RENDER_WRITE_SLEEPS "hdi.render.write_sleeps_per_sec"
+#define PROP_RENDER_SINK_DROPPED "hdi.render.sink_bytes_dropped"
+#define DEFAULT_RENDER_QUEUE_DEPTH 1
+#define MAX_RENDER_QUEUE_DEPTH 8
+#define HARDWARE_CLOCK_MIN_QUEUE_DEPTH 2
+#define MAX_RENDER_BATCH_MSEC 100
+#define PPM 1000000
+#define MAX_CLOCK_DRIFT_PPM 2000
+#define CLOCK_DLL_BANDWIDTH_HZ 0.25
+#define CLOCK_DLL_RESET_GAP_USEC PA_USEC_PER_SEC
 
 const char *DEVICE_CLASS_A2DP = "a2dp";
 
+struct RenderStats {
+    pa_time_event *event;
+    pa_usec_t timestamp;
+    pa_atomic_t wakeups;
+    pa_atomic_t renderBlockMsec;
+    pa_atomic_t isTimingTidSet;
+    pa_atomic_t isHdiTidSet;
+    pthread_t timingTid;
+    pthread_t hdiTid;
+    uint32_t lastWakeups;
+    pa_usec_t lastCpuUsec;
+    bool isPublished;
+    uint32_t lastQueueFillSum;
+    uint32_t lastQueueFillCount;
+    uint64_t lastWriteRetries;
+    uint64_t lastWriteSleeps;
+};
+
 enum {
-    HDI_INIT,
-    HDI_DEINIT,
-    HDI_START,
-    HDI_STOP,
-    HDI_RENDER,
-    QUIT
+    SLOT_FREE,
+    SLOT_QUEUED,
+    SLOT_TAKEN,
+    SLOT_CANCELLED
+};
+
+struct RenderSlot {
+    pa_memchunk chunk;
+    pa_atomic_t state;
+};
+
+// Rendered chunks on their way from the timing thread to the HDI writer thread. The slots are filled in order by
+// the timing thread, the lock-free queue hands their addresses to the writer. A queued slot belongs to whichever
+// thread moves it out of SLOT_QUEUED first: the writer takes it to write, or a rewind cancels it and releases the
+// data. Either way only the writer returns it to SLOT_FREE, once it has popped the address. There are twice as
+// many slots as the depth, so blocks can be rendered again after a rewind before the writer has seen the cancelled
+// ones. Occupancy counts the live blocks only.
+struct RenderQueue {
+    pa_asyncq *q;
+    struct RenderSlot *slots;
+    uint32_t slotCount;
+    uint32_t depth;
+    uint32_t writeIndex;
+    pa_atomic_t occupancy;
+    pa_atomic_t peak;
+    pa_atomic_t fillSum;
+    pa_atomic_t fillCount;
+    struct RenderSlot quit;
+};
+
+// Delay-locked loop over (frames played, monotonic time) samples of the device
+struct ClockDll {
+    bool isLocked;
+    uint64_t frames;
+    double timeUsec;
+    double usecPerFrame;
+    double nominalUsecPerFrame;
 };
 
 struct Userdata {
     const char *adapterName;
     uint32_t buffer_size;
+    uint32_t deep_buffer_size;
+    pa_usec_t default_block_usec;
     uint32_t fixed_latency;
     uint32_t sink_latency;
     uint32_t render_in_idle_state;
@@ -78,11 +156,19 @@ struct Userdata {
     pa_channel_map map;
     bool isHDISinkStarted;
     struct RendererSinkAdapter *sinkAdapter;
-    pa_asyncmsgq *dq;
-    pa_atomic_t dflag;
+    struct RenderQueue queue;
+    uint32_t renderBatchMsec;
+    uint32_t encoderFrameSamples;
+    bool hardware_clock;
+    struct ClockDll dll;
+    pa_atomic_t dllResetPending;
+    uint64_t writtenFrames;
+    pa_atomic_t rateDriftPpm;
+    struct HdiThreadAttr threadAttr;
     bool test_mode_on;
     uint32_t writeCount;
     uint32_t renderCount;
+    struct RenderStats stats;
 };
 
 static void UserdataFree(struct Userdata *u);
@@ -179,19 +265,82 @@ static ssize_t TestModeRenderWrite(struct Userdata *u, pa_memchunk *pchunk)
     return count;
 }
 
+static pa_usec_t RenderBytesToUsec(struct Userdata *u, size_t bytes)
+{
+    pa_usec_t usec = pa_bytes_to_usec(bytes, &u->sink->sample_spec);
+    if (u->hardware_clock) {
+        // The device plays the block at its own rate, not at the nominal one
+        usec = usec * PPM / (pa_usec_t)(PPM + pa_atomic_load(&u->rateDriftPpm));
+    }
+    return usec;
+}
+
 static void ProcessRenderUseTiming(struct Userdata *u, pa_usec_t now)
 {
     pa_assert(u);
 
     // Fill the buffer up the latency size
-    pa_memchunk chunk;
+    struct RenderSlot *slot = &u->queue.slots[u->queue.writeIndex];
 
     // Change from pa_sink_render to pa_sink_render_full for alignment issue in 3516
-    pa_sink_render_full(u->sink, u->sink->thread_info.max_request, &chunk);
-    pa_assert(chunk.length > 0);
+    pa_sink_render_full(u->sink, u->sink->thread_info.max_request, &slot->chunk);
+    pa_assert(slot->chunk.length > 0);
+
+    // Count the slot before the writer can see it, so occupancy never drops below zero
+    int occupancy = pa_atomic_inc(&u->queue.occupancy) + 1;
+    if (occupancy > pa_atomic_load(&u->queue.peak)) {
+        pa_atomic_store(&u->queue.peak, occupancy);
+    }
+    pa_atomic_store(&slot->state, SLOT_QUEUED);
+    pa_assert_se(pa_asyncq_push(u->queue.q, slot, false) == 0);
+    u->queue.writeIndex = (u->queue.writeIndex + 1) % u->queue.slotCount;
+    u->timestamp += RenderBytesToUsec(u, slot->chunk.length);
+}
 
-    pa_asyncmsgq_post(u->dq, NULL, HDI_RENDER, NULL, 0, &chunk, NULL);
-    u->timestamp += pa_bytes_to_usec(chunk.length, &u->sink->sample_spec);
+// Renders every block that is due while a slot is free. With a deeper queue the timing thread runs up to
+// depth - 1 blocks ahead of real time, so the writer still has data when an HDI write takes longer than a block.
+static void RenderQueueFill(struct Userdata *u, pa_usec_t now)
+{
+    pa_usec_t blockUsec = pa_bytes_to_usec(u->sink->thread_info.max_request, &u->sink->sample_spec);
+    pa_usec_t renderAhead = (u->queue.depth - 1) * blockUsec;
+
+    while (u->timestamp <= now + renderAhead &&
+        pa_atomic_load(&u->queue.occupancy) < (int)u->queue.depth &&
+        pa_atomic_load(&u->queue.slots[u->queue.writeIndex].state) == SLOT_FREE) {
+        ProcessRenderUseTiming(u, now);
+    }
+}
+
+// Takes back the newest blocks the writer has not started on, as far as the requested rewind allows, so volume
+// changes and new streams are heard after the block in flight instead of after the whole queue.
+static void RenderQueueRewind(struct Userdata *u)
+{
+    struct RenderQueue *queue = &u->queue;
+    size_t limit = u->sink->thread_info.rewind_nbytes;
+    size_t rewound = 0;
+    uint32_t index = queue->writeIndex;
+
+    for (uint32_t i = 0; i < queue->slotCount; i++) {
+        index = (index + queue->slotCount - 1) % queue->slotCount;
+        struct RenderSlot *slot = &queue->slots[index];
+
+        // Only whole blocks, a block the writer may take meanwhile cannot be trimmed. The writer takes slots in
+        // order, so once one cannot be cancelled all older ones are gone too.
+        if (rewound + slot->chunk.length > limit ||
+            !pa_atomic_cmpxchg(&slot->state, SLOT_QUEUED, SLOT_CANCELLED)) {
+            break;
+        }
+        rewound += slot->chunk.length;
+        pa_memblock_unref(slot->chunk.memblock);
+        pa_memchunk_reset(&slot->chunk);
+        pa_atomic_dec(&queue->occupancy);
+    }
+
+    if (rewound > 0) {
+        u->timestamp -= PA_MIN(u->timestamp, RenderBytesToUsec(u, rewound));
+        AUDIO_DEBUG_LOG("Rewound %{public}zu of %{public}zu requested bytes", rewound, limit);
+    }
+    pa_sink_process_rewind(u->sink, rewound);
 }
 
 static void ThreadFuncUseTiming(void *userdata)
@@ -201,8 +350,12 @@ static void ThreadFuncUseTiming(void *userdata)
     pa_assert(u);
 
     pa_log_debug("Thread (use timing) starting up");
+    HdiThreadAttrApply(&u->threadAttr, "write-pa");
     pa_thread_mq_install(&u->thread_mq);
 
+    u->stats.timingTid = pthread_self();
+    pa_atomic_store(&u->stats.isTimingTidSet, 1);
+
     u->timestamp = pa_rtclock_now();
 
     while (true) {
@@ -220,23 +373,17 @@ static void ThreadFuncUseTiming(void *userdata)
         }
 
         if (PA_UNLIKELY(u->sink->thread_info.rewind_requested)) {
-            pa_sink_process_rewind(u->sink, 0);
+            RenderQueueRewind(u);
         }
 
         // Render some data and drop it immediately
         if (u->render_in_idle_state && PA_SINK_IS_OPENED(u->sink->thread_info.state)) {
-            if (u->timestamp <= now && pa_atomic_load(&u->dflag) == 0) {
-                pa_atomic_add(&u->dflag, 1);
-                ProcessRenderUseTiming(u, now);
-            }
+            RenderQueueFill(u, now);
 
             pa_usec_t sleep_for_usec = pa_bytes_to_usec(u->sink->thread_info.max_request, &u->sink->sample_spec);
             pa_rtpoll_set_timer_relative(u->rtpoll, sleep_for_usec);
         } else if (!u->render_in_idle_state && PA_SINK_IS_RUNNING(u->sink->thread_info.state)) {
-            if (u->timestamp <= now && pa_atomic_load(&u->dflag) == 0) {
-                pa_atomic_add(&u->dflag, 1);
-                ProcessRenderUseTiming(u, now);
-            }
+            RenderQueueFill(u, now);
 
             pa_usec_t sleep_for_usec = pa_bytes_to_usec(u->sink->thread_info.max_request, &u->sink->sample_spec);
             pa_rtpoll_set_timer_relative(u->rtpoll, sleep_for_usec);
@@ -247,6 +394,7 @@ static void ThreadFuncUseTiming(void *userdata)
         if ((ret = pa_rtpoll_run(u->rtpoll)) < 0) {
             goto fail;
         }
+        pa_atomic_inc(&u->stats.wakeups);
 
         if (ret == 0) {
             goto finish;
@@ -264,37 +412,113 @@ finish:
     AUDIO_INFO_LOG("Thread (use timing) shutting down");
 }
 
-static void ThreadFuncWriteHDI(void *userdata)
+static void ClockDllInit(struct ClockDll *dll, uint32_t rate)
 {
-    struct Userdata *u = userdata;
-    pa_assert(u);
+    dll->isLocked = false;
+    dll->frames = 0;
+    dll->timeUsec = 0;
+    dll->nominalUsecPerFrame = (double)PA_USEC_PER_SEC / rate;
+    dll->usecPerFrame = dll->nominalUsecPerFrame;
+}
 
-    int quit = 0;
+// Second order DLL. The filtered slope is how long the device takes per frame, measured against the monotonic
+// clock, so jitter in when samples are taken averages out while the real device rate is followed.
+static void ClockDllUpdate(struct ClockDll *dll, uint64_t frames, uint64_t timeUsec)
+{
+    if (!dll->isLocked || frames <= dll->frames ||
+        (double)(frames - dll->frames) * dll->usecPerFrame > CLOCK_DLL_RESET_GAP_USEC ||
+        (double)timeUsec - dll->timeUsec > CLOCK_DLL_RESET_GAP_USEC) {
+        // First sample, device position reset or a long pause in either frames or time: restart the phase, keep
+        // the rate learned so far
+        dll->isLocked = true;
+        dll->frames = frames;
+        dll->timeUsec = (double)timeUsec;
+        return;
+    }
 
-    do {
-        int code = 0;
-        pa_memchunk chunk;
+    double deltaFrames = (double)(frames - dll->frames);
+    double predictedUsec = dll->timeUsec + deltaFrames * dll->usecPerFrame;
+    double error = (double)timeUsec - predictedUsec;
+    double omega = 2 * M_PI * CLOCK_DLL_BANDWIDTH_HZ * deltaFrames * dll->usecPerFrame / PA_USEC_PER_SEC;
 
-        pa_assert_se(pa_asyncmsgq_get(u->dq, NULL, &code, NULL, NULL, &chunk, 1) == 0);
+    dll->timeUsec = predictedUsec + M_SQRT2 * omega * error;
+    dll->usecPerFrame += omega * omega * error / deltaFrames;
 
-        switch (code) {
-            case HDI_RENDER:
-                if (RenderWrite(u, &chunk) < 0) {
-                    u->bytes_dropped += chunk.length;
-                    AUDIO_ERR_LOG("RenderWrite failed");
-                }
-                if (pa_atomic_load(&u->dflag) == 1) {
-                    pa_atomic_sub(&u->dflag, 1);
-                }
-                break;
-            case QUIT:
-                quit = 1;
-                break;
-            default:
-                break;
+    double maxDrift = dll->nominalUsecPerFrame * MAX_CLOCK_DRIFT_PPM / PPM;
+    dll->usecPerFrame = PA_CLAMP(dll->usecPerFrame, dll->nominalUsecPerFrame - maxDrift,
+        dll->nominalUsecPerFrame + maxDrift);
+    dll->frames = frames;
+}
+
+// HDI writer thread. Feeds the DLL with the device position when the adapter reports it. Otherwise the
+// completion of a write is used, but only when the next block was already queued: the write then returned as soon
+// as the device made room, not when the timing thread delivered the data.
+static void ClockTrackWrite(struct Userdata *u, size_t bytes, bool isBackToBack)
+{
+    uint64_t frames = 0;
+    uint64_t timeUsec = 0;
+
+    u->writtenFrames += bytes / pa_frame_size(&u->ss);
+    // The IO thread asks for it when the device starts or suspends, the DLL itself belongs to this thread
+    if (pa_atomic_cmpxchg(&u->dllResetPending, 1, 0)) {
+        u->dll.isLocked = false;
+    }
+    if (u->sinkAdapter->RendererSinkGetRenderPosition) {
+        if (u->sinkAdapter->RendererSinkGetRenderPosition(&frames, &timeUsec) != 0) {
+            return;
+        }
+    } else if (isBackToBack) {
+        frames = u->writtenFrames;
+        timeUsec = pa_rtclock_now();
+    } else {
+        return;
+    }
+
+    ClockDllUpdate(&u->dll, frames, timeUsec);
+    pa_atomic_store(&u->rateDriftPpm,
+        (int)lround((u->dll.nominalUsecPerFrame / u->dll.usecPerFrame - 1.0) * PPM));
+}
+
+static void WriteHdiLoop(struct Userdata *u, ssize_t (*renderWrite)(struct Userdata *, pa_memchunk *))
+{
+    u->stats.hdiTid = pthread_self();
+    pa_atomic_store(&u->stats.isHdiTidSet, 1);
+    HdiThreadAttrApply(&u->threadAttr, "write-hdi");
+
+    while (true) {
+        struct RenderSlot *slot = pa_asyncq_pop(u->queue.q, true);
+        pa_atomic_inc(&u->stats.wakeups);
+        if (slot == &u->queue.quit) {
+            break;
+        }
+        if (!pa_atomic_cmpxchg(&slot->state, SLOT_QUEUED, SLOT_TAKEN)) {
+            // Rewound, the timing thread already released the data
+            pa_atomic_store(&slot->state, SLOT_FREE);
+            continue;
         }
-        pa_asyncmsgq_done(u->dq, 0);
-    } while (!quit);
+
+        pa_memchunk *chunk = &slot->chunk;
+        int occupancy = pa_atomic_load(&u->queue.occupancy);
+        pa_atomic_add(&u->queue.fillSum, occupancy);
+        pa_atomic_inc(&u->queue.fillCount);
+        size_t length = chunk->length;
+        if (renderWrite(u, chunk) < 0) {
+            u->bytes_dropped += length;
+            AUDIO_ERR_LOG("RenderWrite failed");
+        } else if (u->hardware_clock) {
+            ClockTrackWrite(u, length, occupancy > 1);
+        }
+        pa_atomic_dec(&u->queue.occupancy);
+        pa_atomic_store(&slot->state, SLOT_FREE);
+    }
+}
+
+static void ThreadFuncWriteHDI(void *userdata)
+{
+    struct Userdata *u = userdata;
+    pa_assert(u);
+
+    WriteHdiLoop(u, RenderWrite);
 }
 
 static void TestModeThreadFuncWriteHDI(void *userdata)
@@ -302,32 +526,48 @@ static void TestModeThreadFuncWriteHDI(void *userdata)
     struct Userdata *u = userdata;
     pa_assert(u);
 
-    int quit = 0;
+    WriteHdiLoop(u, TestModeRenderWrite);
+}
 
-    do {
-        int code = 0;
-        pa_memchunk chunk;
+static int RenderQueueInit(struct RenderQueue *queue, uint32_t depth)
+{
+    // Room for every slot and the quit marker, the asyncq size has to be a power of two
+    queue->slotCount = depth * 2;
+    queue->q = pa_asyncq_new(pa_make_power_of_two(queue->slotCount + 1));
+    if (!queue->q) {
+        return -1;
+    }
+    queue->slots = pa_xnew0(struct RenderSlot, queue->slotCount);
+    for (uint32_t i = 0; i < queue->slotCount; i++) {
+        pa_atomic_store(&queue->slots[i].state, SLOT_FREE);
+    }
+    queue->depth = depth;
+    queue->writeIndex = 0;
+    pa_atomic_store(&queue->occupancy, 0);
+    pa_atomic_store(&queue->peak, 0);
+    pa_atomic_store(&queue->fillSum, 0);
+    pa_atomic_store(&queue->fillCount, 0);
+    pa_memchunk_reset(&queue->quit.chunk);
+    return 0;
+}
 
-        pa_assert_se(pa_asyncmsgq_get(u->dq, NULL, &code, NULL, NULL, &chunk, 1) == 0);
+// Called once both render threads are gone
+static void RenderQueueFree(struct RenderQueue *queue)
+{
+    if (!queue->q) {
+        return;
+    }
 
-        switch (code) {
-            case HDI_RENDER:
-                if (TestModeRenderWrite(u, &chunk) < 0) {
-                    u->bytes_dropped += chunk.length;
-                    AUDIO_ERR_LOG("TestModeRenderWrite failed");
-                }
-                if (pa_atomic_load(&u->dflag) == 1) {
-                    pa_atomic_sub(&u->dflag, 1);
-                }
-                break;
-            case QUIT:
-                quit = 1;
-                break;
-            default:
-                break;
+    struct RenderSlot *slot = NULL;
+    while ((slot = pa_asyncq_pop(queue->q, false)) != NULL) {
+        if (slot != &queue->quit && pa_atomic_load(&slot->state) == SLOT_QUEUED) {
+            pa_memblock_unref(slot->chunk.memblock);
         }
-        pa_asyncmsgq_done(u->dq, 0);
-    } while (!quit);
+    }
+    pa_asyncq_free(queue->q, NULL);
+    pa_xfree(queue->slots);
+    queue->q = NULL;
+    queue->slots = NULL;
 }
 
 static void SinkUpdateRequestedLatencyCb(pa_sink *s)
@@ -340,11 +580,110 @@ static void SinkUpdateRequestedLatencyCb(pa_sink *s)
 
     u->block_usec = pa_sink_get_requested_latency_within_thread(s);
 
+    // Streams that do not ask for a latency get the default block, the top of the range is only used when
+    // every connected stream asked for deep buffering
     if (u->block_usec == (pa_usec_t) - 1)
-        u->block_usec = s->thread_info.max_latency;
+        u->block_usec = u->default_block_usec;
 
     nbytes = pa_usec_to_bytes(u->block_usec, &s->sample_spec);
     pa_sink_set_max_request_within_thread(s, nbytes);
+    pa_sink_set_max_rewind_within_thread(s, nbytes * u->queue.depth);
+    pa_atomic_store(&u->stats.renderBlockMsec, (int)(u->block_usec / PA_USEC_PER_MSEC));
+}
+
+static pa_usec_t GetThreadCpuUsec(pthread_t tid)
+{
+    clockid_t clockId;
+    struct timespec ts;
+
+    if (pthread_getcpuclockid(tid, &clockId) != 0 || clock_gettime(clockId, &ts) != 0) {
+        return 0;
+    }
+
+    return (pa_usec_t)ts.tv_sec * PA_USEC_PER_SEC + (pa_usec_t)ts.tv_nsec / PA_NSEC_PER_USEC;
+}
+
+// Adapter counters start over when the sink is initialized again, count from zero then instead of underflowing
+static uint64_t CounterDelta(uint64_t current, uint64_t last)
+{
+    return (current >= last) ? (current - last) : current;
+}
+
+// Called from main context. Publishes wakeups per second and CPU load of the render threads as sink properties,
+// along with the write retries and pacing sleeps per second and the bytes the sink discarded when the adapter counts
+// them.
+static void RenderStatsTimeCb(pa_mainloop_api *api, pa_time_event *e, const struct timeval *t, void *userdata)
+{
+    struct Userdata *u = userdata;
+    pa_assert(u);
+
+    pa_usec_t now = pa_rtclock_now();
+    pa_usec_t elapsed = now - u->stats.timestamp;
+    uint32_t wakeups = (uint32_t)pa_atomic_load(&u->stats.wakeups);
+    pa_usec_t cpuUsec = 0;
+    if (pa_atomic_load(&u->stats.isTimingTidSet)) {
+        cpuUsec += GetThreadCpuUsec(u->stats.timingTid);
+    }
+    if (pa_atomic_load(&u->stats.isHdiTidSet)) {
+        cpuUsec += GetThreadCpuUsec(u->stats.hdiTid);
+    }
+
+    uint32_t fillSum = (uint32_t)pa_atomic_load(&u->queue.fillSum);
+    uint32_t fillCount = (uint32_t)pa_atomic_load(&u->queue.fillCount);
+    uint64_t writeRetries = 0;
+    uint64_t writeSleeps = 0;
+    bool hasWriteStats = u->sinkAdapter->RendererSinkGetWriteStats &&
+        u->sinkAdapter->RendererSinkGetWriteStats(&writeRetries, &writeSleeps) == 0;
+    uint64_t sinkDropped = 0;
+    bool hasSinkDropped = u->sinkAdapter->RendererSinkGetDroppedBytes &&
+        u->sinkAdapter->RendererSinkGetDroppedBytes(&sinkDropped) == 0;
+
+    uint32_t wakeupDelta = wakeups - u->stats.lastWakeups;
+    uint32_t fillCountDelta = fillCount - u->stats.lastQueueFillCount;
+    pa_usec_t cpuDelta = (cpuUsec > u->stats.lastCpuUsec) ? (cpuUsec - u->stats.lastCpuUsec) : 0;
+
+    // Skip the property update, and the subscription events it causes, while the sink stays idle
+    if (elapsed > 0 && (wakeupDelta > 0 || u->stats.isPublished)) {
+        pa_proplist *pl = pa_proplist_new();
+        pa_proplist_setf(pl, PROP_RENDER_WAKEUPS, "%.1f", (double)wakeupDelta * PA_USEC_PER_SEC / elapsed);
+        pa_proplist_setf(pl, PROP_RENDER_CPU_LOAD, "%.2f%%", (double)cpuDelta * PERCENT / elapsed);
+        pa_proplist_setf(pl, PROP_RENDER_BLOCK, "%d", pa_atomic_load(&u->stats.renderBlockMsec));
+        // Average occupancy the writer found when taking a chunk, that chunk included. Close to 1 the writer keeps
+        // waiting for the timing thread, close to the depth it has reserve for slow HDI writes.
+        pa_proplist_setf(pl, PROP_RENDER_QUEUE_DEPTH, "%u", u->queue.depth);
+        pa_proplist_setf(pl, PROP_RENDER_QUEUE_FILL, "%.2f",
+            (fillCountDelta == 0) ? 0.0 : (double)(fillSum - u->stats.lastQueueFillSum) / fillCountDelta);
+        pa_proplist_setf(pl, PROP_RENDER_QUEUE_PEAK, "%d", pa_atomic_load(&u->queue.peak));
+        if (u->hardware_clock) {
+            pa_proplist_setf(pl, PROP_RENDER_RATE_RATIO, "%.6f",
+                1.0 + (double)pa_atomic_load(&u->rateDriftPpm) / PPM);
+        }
+        if (hasWriteStats) {
+            pa_proplist_setf(pl, PROP_RENDER_WRITE_RETRIES, "%.1f",
+                (double)CounterDelta(writeRetries, u->stats.lastWriteRetries) * PA_USEC_PER_SEC / elapsed);
+            pa_proplist_setf(pl, PROP_RENDER_WRITE_SLEEPS, "%.1f",
+                (double)CounterDelta(writeSleeps, u->stats.lastWriteSleeps) * PA_USEC_PER_SEC / elapsed);
+        }
+        if (hasSinkDropped) {
+            pa_proplist_setf(pl, PROP_RENDER_SINK_DROPPED, "%" PRIu64, sinkDropped);
+        }
+        pa_sink_update_proplist(u->sink, PA_UPDATE_REPLACE, pl);
+        pa_proplist_free(pl);
+        u->stats.isPublished = (wakeupDelta > 0);
+    }
+
+    u->stats.lastWakeups = wakeups;
+    u->stats.lastCpuUsec = cpuUsec;
+    u->stats.lastQueueFillSum = fillSum;
+    u->stats.lastQueueFillCount = fillCount;
+    if (hasWriteStats) {
+        u->stats.lastWriteRetries = writeRetries;
+        u->stats.lastWriteSleeps = writeSleeps;
+    }
+    // Racing with the timing thread may lose one peak update, which only affects this statistic
+    pa_atomic_store(&u->queue.peak, pa_atomic_load(&u->queue.occupancy));
+    u->stats.timestamp = now;
+    pa_core_rttime_restart(u->core, e, now + RENDER_STATS_INTERVAL_USEC);
 }
 
 static int SinkProcessMsg(pa_msgobject *o, int code, void *data, int64_t offset,
@@ -367,8 +706,9 @@ static int SinkProcessMsg(pa_msgobject *o, int code, void *data, int64_t offset,
                 if (u->sinkAdapter->RendererSinkGetLatency(&hdiLatency) == 0) {
                     latency = (PA_USEC_PER_MSEC * hdiLatency);
                 } else {
+                    // Everything rendered ahead of real time is still queued for the HDI writer
                     pa_usec_t now = pa_rtclock_now();
-                    latency = (now - u->timestamp);
+                    latency = (u->timestamp > now) ? (u->timestamp - now) : 0;
                 }
 
                 *((uint64_t *)data) = latency;
@@ -405,6 +745,7 @@ static int SinkSetStateInIoThreadCb(pa_sink *s, pa_sink_state_t newState,
         }
 
         u->timestamp = pa_rtclock_now();
+        pa_atomic_store(&u->dllResetPending, 1);
         if (u->isHDISinkStarted) {
             return 0;
         }
@@ -430,6 +771,7 @@ static int SinkSetStateInIoThreadCb(pa_sink *s, pa_sink_state_t newState,
                            u->bytes_dropped);
             u->bytes_dropped = 0;
         }
+        pa_atomic_store(&u->dllResetPending, 1);
 
         if (u->isHDISinkStarted) {
             u->sinkAdapter->RendererSinkStop();
@@ -552,6 +894,8 @@ static int32_t PrepareDevice(struct Userdata *u, const char* filePath)
     sample_attrs.channel = u->ss.channels;
     sample_attrs.volume = MAX_SINK_VOLUME_LEVEL;
     sample_attrs.filePath = filePath;
+    sample_attrs.batchMsec = u->renderBatchMsec;
+    sample_attrs.encoderFrameSamples = u->encoderFrameSamples;
 
     ret = u->sinkAdapter->RendererSinkInit(&sample_attrs);
     if (ret != 0) {
@@ -670,8 +1014,51 @@ pa_sink *PaHdiSinkNew(pa_module *m, pa_modargs *ma, const char *driver)
         AUDIO_INFO_LOG("No test_mode_on arg. Normal mode it is.");
     }
 
-    pa_atomic_store(&u->dflag, 0);
-    u->dq = pa_asyncmsgq_new(0);
+    u->hardware_clock = false;
+    if (pa_modargs_get_value_boolean(ma, "hardware_clock", &u->hardware_clock) < 0) {
+        AUDIO_ERR_LOG("Failed to parse hardware_clock argument.");
+        goto fail;
+    }
+    pa_atomic_store(&u->rateDriftPpm, 0);
+
+    uint32_t renderQueueDepth = DEFAULT_RENDER_QUEUE_DEPTH;
+    if (pa_modargs_get_value_u32(ma, "render_queue_depth", &renderQueueDepth) < 0) {
+        AUDIO_ERR_LOG("Failed to parse render_queue_depth argument.");
+        goto fail;
+    }
+    renderQueueDepth = PA_CLAMP(renderQueueDepth, 1, MAX_RENDER_QUEUE_DEPTH);
+    // Without a reported position the DLL only learns from back to back writes, which a single slot never has
+    if (u->hardware_clock && !u->sinkAdapter->RendererSinkGetRenderPosition &&
+        renderQueueDepth < HARDWARE_CLOCK_MIN_QUEUE_DEPTH) {
+        AUDIO_WARNING_LOG("hardware_clock needs render_queue_depth %{public}d, raised from %{public}u",
+            HARDWARE_CLOCK_MIN_QUEUE_DEPTH, renderQueueDepth);
+        renderQueueDepth = HARDWARE_CLOCK_MIN_QUEUE_DEPTH;
+    }
+    if (RenderQueueInit(&u->queue, renderQueueDepth) < 0) {
+        AUDIO_ERR_LOG("Failed to create render queue.");
+        goto fail;
+    }
+    AUDIO_INFO_LOG("Render queue depth: %{public}u", renderQueueDepth);
+
+    u->renderBatchMsec = 0;
+    if (pa_modargs_get_value_u32(ma, "render_batch_msec", &u->renderBatchMsec) < 0) {
+        AUDIO_ERR_LOG("Failed to parse render_batch_msec argument.");
+        goto fail;
+    }
+    u->renderBatchMsec = PA_MIN(u->renderBatchMsec, MAX_RENDER_BATCH_MSEC);
+
+    u->encoderFrameSamples = 0;
+    if (pa_modargs_get_value_u32(ma, "encoder_frame_samples", &u->encoderFrameSamples) < 0) {
+        AUDIO_ERR_LOG("Failed to parse encoder_frame_samples argument.");
+        goto fail;
+    }
+
+    if (HdiThreadAttrParse(ma, &u->threadAttr) < 0) {
+        goto fail;
+    }
+    if (u->threadAttr.memLock) {
+        HdiThreadLockMemory();
+    }
 
     u->sink = PaHdiSinkInit(u, ma, driver);
     if (!u->sink) {
@@ -679,6 +1066,13 @@ pa_sink *PaHdiSinkNew(pa_module *m, pa_modargs *ma, const char *driver)
         goto fail;
     }
 
+    ClockDllInit(&u->dll, u->ss.rate);
+    pa_atomic_store(&u->dllResetPending, 0);
+    if (u->hardware_clock) {
+        AUDIO_INFO_LOG("Rendering paced by the device clock, position %{public}s",
+            u->sinkAdapter->RendererSinkGetRenderPosition ? "reported" : "from write completion");
+    }
+
     u->sink->parent.process_msg = SinkProcessMsg;
     u->sink->set_state_in_io_thread = SinkSetStateInIoThreadCb;
     if (!u->fixed_latency) {
@@ -696,15 +1090,32 @@ pa_sink *PaHdiSinkNew(pa_module *m, pa_modargs *ma, const char *driver)
         goto fail;
     }
 
+    u->deep_buffer_size = u->buffer_size;
+    if (pa_modargs_get_value_u32(ma, "deep_buffer_size", &u->deep_buffer_size) < 0) {
+        AUDIO_ERR_LOG("Failed to parse deep_buffer_size argument.");
+        goto fail;
+    }
+    // A render cycle is a single memblock, which cannot grow past the mempool block size
+    u->deep_buffer_size = PA_MIN(u->deep_buffer_size,
+        pa_frame_align(pa_mempool_block_size_max(m->core->mempool), &u->sink->sample_spec));
+    u->deep_buffer_size = PA_MAX(u->deep_buffer_size, u->buffer_size);
+
     u->block_usec = pa_bytes_to_usec(u->buffer_size, &u->sink->sample_spec);
+    u->default_block_usec = u->block_usec;
+    pa_atomic_store(&u->stats.renderBlockMsec, (int)(u->block_usec / PA_USEC_PER_MSEC));
 
     if (u->fixed_latency) {
-        pa_sink_set_fixed_latency(u->sink, u->block_usec);
+        pa_sink_set_fixed_latency(u->sink, u->block_usec * u->queue.depth);
     } else {
-        pa_sink_set_latency_range(u->sink, 0, u->block_usec);
+        // Deep buffer streams may raise the render block up to deep_buffer_size
+        pa_sink_set_latency_range(u->sink, 0, pa_bytes_to_usec(u->deep_buffer_size, &u->sink->sample_spec));
+        AUDIO_INFO_LOG("Sink latency range up to %{public}u bytes, default block %{public}u bytes",
+            u->deep_buffer_size, u->buffer_size);
     }
 
     pa_sink_set_max_request(u->sink, u->buffer_size);
+    // Queued blocks the writer has not taken yet can be rewound
+    pa_sink_set_max_rewind(u->sink, u->buffer_size * u->queue.depth);
 
     paThreadName = "write-pa";
     if (!(u->thread = pa_thread_new(paThreadName, ThreadFuncUseTiming, u))) {
@@ -732,6 +1143,10 @@ pa_sink *PaHdiSinkNew(pa_module *m, pa_modargs *ma, const char *driver)
     // Start modules in suspended state
     pa_sink_suspend(u->sink, true, PA_SUSPEND_IDLE);
 
+    u->stats.timestamp = pa_rtclock_now();
+    u->stats.event = pa_core_rttime_new(u->core, u->stats.timestamp + RENDER_STATS_INTERVAL_USEC,
+        RenderStatsTimeCb, u);
+
     // register for sink callbacks
     pa_module_hook_connect(m, &m->core->hooks[PA_CORE_HOOK_SINK_INPUT_UNLINK], PA_HOOK_NORMAL,
         (pa_hook_cb_t) SinkStreamDisconnectCb, u);
@@ -751,6 +1166,9 @@ static void UserdataFree(struct Userdata *u)
 {
     pa_assert(u);
 
+    if (u->stats.event)
+        u->core->mainloop->time_free(u->stats.event);
+
     if (u->sink)
         pa_sink_unlink(u->sink);
 
@@ -760,10 +1178,12 @@ static void UserdataFree(struct Userdata *u)
     }
 
     if (u->thread_hdi) {
-        pa_asyncmsgq_post(u->dq, NULL, QUIT, NULL, 0, NULL, NULL);
+        pa_asyncq_push(u->queue.q, &u->queue.quit, true);
         pa_thread_free(u->thread_hdi);
     }
 
+    RenderQueueFree(&u->queue);
+
     pa_thread_mq_done(&u->thread_mq);
 
     if (u->sink)
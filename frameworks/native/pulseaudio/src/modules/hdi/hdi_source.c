@@ -24,22 +24,28 @@
 #include <pulse/util.h>
 #include <pulse/xmalloc.h>
 
+#include <pulsecore/asyncq.h>
 #include <pulsecore/core.h>
 #include <pulsecore/core-rtclock.h>
 #include <pulsecore/core-util.h>
+#include <pulsecore/fdsem.h>
 #include <pulsecore/log.h>
 #include <pulsecore/macro.h>
+#include <pulsecore/memblock.h>
 #include <pulsecore/memchunk.h>
 #include <pulsecore/modargs.h>
 #include <pulsecore/module.h>
+#include <pulsecore/mutex.h>
 #include <pulsecore/rtpoll.h>
 #include <pulsecore/thread.h>
 #include <pulsecore/thread-mq.h>
 
 #include <signal.h>
+#include <unistd.h>
 
 #include "capturer_source_adapter.h"
 #include "audio_log.h"
+#include "hdi_thread_util.h"
 
 #define DEFAULT_SOURCE_NAME "hdi_input"
 #define DEFAULT_DEVICE_CLASS "primary"
@@ -54,6 +60,53 @@
 #define MIN_LATENCY_USEC 500
 #define AUDIO_POINT_NUM  1024
 #define AUDIO_FRAME_NUM_IN_BUF 30
+#define CAPTURE_POOL_SIZE 8
+#define CAPTURE_STATS_INTERVAL_USEC (5 * PA_USEC_PER_SEC)
+#define PROP_CAPTURE_POOL_SIZE "hdi.capture.pool_size"
+#define PROP_CAPTURE_POOL_HITS "hdi.capture.pool_hits"
+#define PROP_CAPTURE_POOL_ALLOCS "hdi.capture.pool_allocs"
+#define PROP_CAPTURE_OVERRUNS "hdi.capture.overruns"
+#define CAPTURE_RING_SIZE 8
+
+// Capture blocks recycled by the reader thread. A pooled block is reused once the source outputs dropped their
+// references to it. Hits count reads into a recycled block, allocs every block taken from the mempool instead.
+struct CapturePool {
+    pa_memblock *blocks[CAPTURE_POOL_SIZE];
+    uint32_t next;
+    pa_atomic_t hits;
+    pa_atomic_t allocs;
+    pa_time_event *statsEvent;
+    uint32_t lastHits;
+    uint32_t lastAllocs;
+    bool isPublished;
+};
+
+// Captured chunks on their way from the reader thread to the IO thread. The reader fills the slots in order and
+// hands their addresses over through the lock-free queue, posting the fdsem to wake the IO thread. The IO thread
+// releases a slot by decrementing occupancy once the chunk is posted. Audio the reader lost to a failed read or a
+// full ring is counted in skippedUsec, so the IO thread timestamp still follows the device.
+struct CaptureRing {
+    pa_asyncq *q;
+    pa_memchunk slots[CAPTURE_RING_SIZE];
+    uint32_t writeIndex;
+    pa_atomic_t occupancy;
+    pa_atomic_t overruns;
+    pa_atomic_t skippedUsec;
+    uint32_t lastOverruns;
+    pa_fdsem *fdsem;
+    pa_rtpoll_item *rtpollItem;
+};
+
+// The reader thread blocks on HDI reads. The mutex only guards starting and stopping it, never the data path.
+struct CaptureReader {
+    pa_thread *thread;
+    pa_mutex *mutex;
+    pa_cond *cond;
+    bool isReading;
+    bool isBusy;
+    bool quit;
+    pa_usec_t timestamp;
+};
 
 struct Userdata {
     pa_core *core;
@@ -70,14 +123,25 @@ struct Userdata {
     SourceAttr attrs;
     bool IsCapturerStarted;
     struct CapturerSourceAdapter *sourceAdapter;
+    struct HdiThreadAttr threadAttr;
+    struct CapturePool pool;
+    struct CaptureRing ring;
+    struct CaptureReader reader;
+    bool isReaderActive;
 };
 
 static int pa_capturer_init(struct Userdata *u);
 static void pa_capturer_exit(struct Userdata *u);
+static void capture_reader_set_reading(struct Userdata *u, bool isReading);
+static void capture_reader_free(struct Userdata *u);
+static void capture_ring_free(struct Userdata *u);
 
 static void userdata_free(struct Userdata *u)
 {
     pa_assert(u);
+    if (u->pool.statsEvent)
+        u->core->mainloop->time_free(u->pool.statsEvent);
+
     if (u->source)
         pa_source_unlink(u->source);
 
@@ -86,8 +150,16 @@ static void userdata_free(struct Userdata *u)
         pa_thread_free(u->thread);
     }
 
+    capture_reader_free(u);
+    capture_ring_free(u);
+
     pa_thread_mq_done(&u->thread_mq);
 
+    for (uint32_t i = 0; i < CAPTURE_POOL_SIZE; i++) {
+        if (u->pool.blocks[i])
+            pa_memblock_unref(u->pool.blocks[i]);
+    }
+
     if (u->source)
         pa_source_unref(u->source);
 
@@ -134,6 +206,7 @@ static int source_set_state_in_io_thread_cb(pa_source *s, pa_source_state_t newS
     if ((s->thread_info.state == PA_SOURCE_SUSPENDED || s->thread_info.state == PA_SOURCE_INIT) &&
         PA_SOURCE_IS_OPENED(newState)) {
         u->timestamp = pa_rtclock_now();
+        pa_atomic_store(&u->ring.skippedUsec, 0); // The reader is stopped while the source is not opened
         if (newState == PA_SOURCE_RUNNING && !u->IsCapturerStarted) {
             if (u->sourceAdapter->CapturerSourceStart()) {
                 AUDIO_ERR_LOG("HDI capturer start failed");
@@ -145,6 +218,8 @@ static int source_set_state_in_io_thread_cb(pa_source *s, pa_source_state_t newS
     } else if (s->thread_info.state == PA_SOURCE_IDLE) {
         if (newState == PA_SOURCE_SUSPENDED) {
             if (u->IsCapturerStarted) {
+                // The reader must be out of CapturerSourceFrame before the device stops
+                capture_reader_set_reading(u, false);
                 u->sourceAdapter->CapturerSourceStop();
                 u->IsCapturerStarted = false;
                 AUDIO_DEBUG_LOG("Stopped HDI capturer");
@@ -163,20 +238,86 @@ static int source_set_state_in_io_thread_cb(pa_source *s, pa_source_state_t newS
     return 0;
 }
 
-static int get_capturer_frame_from_hdi(pa_memchunk *chunk, const struct Userdata *u)
+/* Called from the reader thread. Returns a referenced block of at least buffer_size bytes. */
+static pa_memblock *capture_pool_get(struct Userdata *u)
+{
+    struct CapturePool *pool = &u->pool;
+
+    for (uint32_t i = 0; i < CAPTURE_POOL_SIZE; i++) {
+        uint32_t index = (pool->next + i) % CAPTURE_POOL_SIZE;
+        pa_memblock *block = pool->blocks[index];
+
+        if (block == NULL) {
+            block = pa_memblock_new(u->core->mempool, u->buffer_size);
+            pool->blocks[index] = block;
+            pa_atomic_inc(&pool->allocs);
+        } else if (pa_memblock_is_read_only(block)) {
+            // Still queued in a source output or exported to a client
+            continue;
+        } else {
+            pa_atomic_inc(&pool->hits);
+        }
+        pool->next = (index + 1) % CAPTURE_POOL_SIZE;
+        return pa_memblock_ref(block);
+    }
+
+    // Every pooled block is still in use, fall back to a one-off block
+    pa_atomic_inc(&pool->allocs);
+    return pa_memblock_new(u->core->mempool, u->buffer_size);
+}
+
+/* Called from main context. Publishes the capture pool statistics as source properties. */
+static void capture_stats_time_cb(pa_mainloop_api *api, pa_time_event *e, const struct timeval *t, void *userdata)
+{
+    struct Userdata *u = userdata;
+    pa_assert(u);
+
+    uint32_t hits = (uint32_t)pa_atomic_load(&u->pool.hits);
+    uint32_t allocs = (uint32_t)pa_atomic_load(&u->pool.allocs);
+    bool isChanged = (hits != u->pool.lastHits) || (allocs != u->pool.lastAllocs);
+
+    // Skip the property update, and the subscription events it causes, while capture stays idle
+    if (isChanged || !u->pool.isPublished) {
+        pa_proplist *pl = pa_proplist_new();
+        pa_proplist_setf(pl, PROP_CAPTURE_POOL_SIZE, "%d", CAPTURE_POOL_SIZE);
+        pa_proplist_setf(pl, PROP_CAPTURE_POOL_HITS, "%u", hits);
+        pa_proplist_setf(pl, PROP_CAPTURE_POOL_ALLOCS, "%u", allocs);
+        pa_source_update_proplist(u->source, PA_UPDATE_REPLACE, pl);
+        pa_proplist_free(pl);
+        u->pool.isPublished = true;
+    }
+
+    uint32_t overruns = (uint32_t)pa_atomic_load(&u->ring.overruns);
+    if (overruns != u->ring.lastOverruns) {
+        AUDIO_ERR_LOG("HDI Source: %{public}u captured chunks dropped, the IO thread fell behind",
+            overruns - u->ring.lastOverruns);
+        pa_proplist *pl = pa_proplist_new();
+        pa_proplist_setf(pl, PROP_CAPTURE_OVERRUNS, "%u", overruns);
+        pa_source_update_proplist(u->source, PA_UPDATE_REPLACE, pl);
+        pa_proplist_free(pl);
+        u->ring.lastOverruns = overruns;
+    }
+
+    u->pool.lastHits = hits;
+    u->pool.lastAllocs = allocs;
+    pa_core_rttime_restart(u->core, e, pa_rtclock_now() + CAPTURE_STATS_INTERVAL_USEC);
+}
+
+/* Called from the reader thread. Reads up to chunk->length bytes into a referenced block, the caller sizes the
+ * read from the time elapsed since the last one. */
+static int get_capturer_frame_from_hdi(pa_memchunk *chunk, struct Userdata *u)
 {
     uint64_t requestBytes;
     uint64_t replyBytes = 0;
     void *p = NULL;
 
-    chunk->length = u->buffer_size;
-    AUDIO_DEBUG_LOG("HDI Source: chunk.length = u->buffer_size: %{public}zu", chunk->length);
-    chunk->memblock = pa_memblock_new(u->core->mempool, chunk->length);
+    chunk->memblock = capture_pool_get(u);
     pa_assert(chunk->memblock);
     p = pa_memblock_acquire(chunk->memblock);
     pa_assert(p);
 
-    requestBytes = pa_memblock_get_length(chunk->memblock);
+    requestBytes = PA_MIN(chunk->length, pa_memblock_get_length(chunk->memblock));
+    AUDIO_DEBUG_LOG("HDI Source: request bytes: %{public}" PRIu64, requestBytes);
     u->sourceAdapter->CapturerSourceFrame((char *)p, (uint64_t)requestBytes, &replyBytes);
 
     pa_memblock_release(chunk->memblock);
@@ -198,21 +339,191 @@ static int get_capturer_frame_from_hdi(pa_memchunk *chunk, const struct Userdata
 
     chunk->index = 0;
     chunk->length = replyBytes;
-    pa_source_post(u->source, chunk);
-    pa_memblock_unref(chunk->memblock);
 
     return 0;
 }
 
+/* Called from the reader thread. Waits for the next period, then reads what accumulated and queues it. A real-time
+ * file source blocks until its block is due by itself, it is read a buffer at a time without waiting here. */
+static void capture_reader_read(struct Userdata *u)
+{
+    pa_memchunk chunk;
+    pa_usec_t now = pa_rtclock_now();
+    pa_usec_t skipped = 0;
+
+    if (u->attrs.fileRealtime) {
+        chunk.length = pa_frame_align(u->buffer_size, &u->source->sample_spec);
+        skipped = pa_bytes_to_usec(chunk.length, &u->source->sample_spec);
+    } else {
+        pa_usec_t due = u->reader.timestamp + u->block_usec;
+        if (now < due) {
+            usleep((useconds_t)(due - now));
+            now = pa_rtclock_now();
+        }
+        // Read what accumulated since the last read, never more than a buffer
+        chunk.length = PA_MIN(pa_usec_to_bytes(now - u->reader.timestamp, &u->source->sample_spec),
+            pa_frame_align(u->buffer_size, &u->source->sample_spec));
+        skipped = now - u->reader.timestamp;
+    }
+    if (chunk.length == 0) {
+        return;
+    }
+
+    if (get_capturer_frame_from_hdi(&chunk, u) != 0) {
+        // Skip the period rather than retry at once
+        pa_atomic_add(&u->ring.skippedUsec, (int)skipped);
+        u->reader.timestamp = now;
+        pa_fdsem_post(u->ring.fdsem);
+        if (u->attrs.fileRealtime) {
+            usleep((useconds_t)skipped); // Nothing else waits before the next attempt
+        }
+        return;
+    }
+    u->reader.timestamp += pa_bytes_to_usec(chunk.length, &u->source->sample_spec);
+
+    // Slots are released in order, the one at writeIndex is free whenever the ring is not full
+    if (pa_atomic_load(&u->ring.occupancy) >= CAPTURE_RING_SIZE) {
+        pa_atomic_inc(&u->ring.overruns);
+        pa_atomic_add(&u->ring.skippedUsec, (int)pa_bytes_to_usec(chunk.length, &u->source->sample_spec));
+        pa_memblock_unref(chunk.memblock);
+        return;
+    }
+    pa_memchunk *slot = &u->ring.slots[u->ring.writeIndex];
+    *slot = chunk;
+    pa_atomic_inc(&u->ring.occupancy);
+    pa_assert_se(pa_asyncq_push(u->ring.q, slot, false) == 0);
+    u->ring.writeIndex = (u->ring.writeIndex + 1) % CAPTURE_RING_SIZE;
+    pa_fdsem_post(u->ring.fdsem);
+}
+
+static void capture_reader_thread_func(void *userdata)
+{
+    struct Userdata *u = userdata;
+    pa_assert(u);
+
+    HdiThreadAttrApply(&u->threadAttr, "read-hdi");
+
+    pa_mutex_lock(u->reader.mutex);
+    while (!u->reader.quit) {
+        if (!u->reader.isReading) {
+            u->reader.isBusy = false;
+            pa_cond_signal(u->reader.cond, 1);
+            pa_cond_wait(u->reader.cond, u->reader.mutex);
+            continue;
+        }
+
+        u->reader.isBusy = true;
+        pa_mutex_unlock(u->reader.mutex);
+        capture_reader_read(u);
+        pa_mutex_lock(u->reader.mutex);
+    }
+    u->reader.isBusy = false;
+    pa_cond_signal(u->reader.cond, 1);
+    pa_mutex_unlock(u->reader.mutex);
+}
+
+/* Called from the IO thread. Stopping waits for a read in progress to return. */
+static void capture_reader_set_reading(struct Userdata *u, bool isReading)
+{
+    if (u->isReaderActive == isReading) {
+        return;
+    }
+
+    pa_mutex_lock(u->reader.mutex);
+    u->reader.isReading = isReading;
+    u->reader.timestamp = pa_rtclock_now();
+    pa_cond_signal(u->reader.cond, 1);
+    while (!isReading && u->reader.isBusy) {
+        pa_cond_wait(u->reader.cond, u->reader.mutex);
+    }
+    pa_mutex_unlock(u->reader.mutex);
+    u->isReaderActive = isReading;
+}
+
+static int capture_reader_init(struct Userdata *u)
+{
+    u->ring.q = pa_asyncq_new(CAPTURE_RING_SIZE);
+    u->ring.fdsem = pa_fdsem_new();
+    if (!u->ring.q || !u->ring.fdsem) {
+        return -1;
+    }
+    u->ring.rtpollItem = pa_rtpoll_item_new_fdsem(u->rtpoll, PA_RTPOLL_NORMAL, u->ring.fdsem);
+
+    u->reader.mutex = pa_mutex_new(false, false);
+    u->reader.cond = pa_cond_new();
+    if (!(u->reader.thread = pa_thread_new("read-hdi", capture_reader_thread_func, u))) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Called once the IO thread is gone */
+static void capture_reader_free(struct Userdata *u)
+{
+    if (u->reader.thread) {
+        pa_mutex_lock(u->reader.mutex);
+        u->reader.quit = true;
+        pa_cond_signal(u->reader.cond, 1);
+        pa_mutex_unlock(u->reader.mutex);
+        pa_thread_free(u->reader.thread);
+        u->reader.thread = NULL;
+    }
+    if (u->reader.cond) {
+        pa_cond_free(u->reader.cond);
+    }
+    if (u->reader.mutex) {
+        pa_mutex_free(u->reader.mutex);
+    }
+}
+
+static void capture_ring_free(struct Userdata *u)
+{
+    if (u->ring.q) {
+        pa_memchunk *chunk = NULL;
+        while ((chunk = pa_asyncq_pop(u->ring.q, false)) != NULL) {
+            pa_memblock_unref(chunk->memblock);
+        }
+        pa_asyncq_free(u->ring.q, NULL);
+    }
+    if (u->ring.rtpollItem) {
+        pa_rtpoll_item_free(u->ring.rtpollItem);
+    }
+    if (u->ring.fdsem) {
+        pa_fdsem_free(u->ring.fdsem);
+    }
+}
+
+/* Called from the IO thread. Posts everything the reader queued, the timestamp follows the posted and lost data. */
+static void capture_ring_post(struct Userdata *u)
+{
+    pa_memchunk *chunk = NULL;
+    int skippedUsec = pa_atomic_load(&u->ring.skippedUsec);
+
+    if (skippedUsec != 0) {
+        pa_atomic_sub(&u->ring.skippedUsec, skippedUsec);
+        u->timestamp += (pa_usec_t)skippedUsec;
+    }
+
+    while ((chunk = pa_asyncq_pop(u->ring.q, false)) != NULL) {
+        if (PA_SOURCE_IS_OPENED(u->source->thread_info.state)) {
+            pa_source_post(u->source, chunk);
+        }
+        u->timestamp += pa_bytes_to_usec(chunk->length, &u->source->sample_spec);
+        pa_memblock_unref(chunk->memblock);
+        pa_atomic_dec(&u->ring.occupancy);
+    }
+}
+
 static void thread_func(void *userdata)
 {
     struct Userdata *u = userdata;
-    bool timer_elapsed = false;
 
     pa_assert(u);
 
-    if (u->core->realtime_scheduling)
+    // An explicit rt_priority takes precedence over the daemon wide realtime setting
+    if (u->threadAttr.rtPriority == 0 && u->core->realtime_scheduling)
         pa_thread_make_realtime(u->core->realtime_priority);
+    HdiThreadAttrApply(&u->threadAttr, "hdi-source-record");
 
     pa_thread_mq_install(&u->thread_mq);
     u->timestamp = pa_rtclock_now();
@@ -221,31 +532,11 @@ static void thread_func(void *userdata)
     while (true) {
         int ret = 0;
 
-        if (PA_SOURCE_IS_OPENED(u->source->thread_info.state) && u->IsCapturerStarted) {
-            pa_memchunk chunk;
-            pa_usec_t now;
-
-            now = pa_rtclock_now();
-            AUDIO_DEBUG_LOG("HDI Source: now: %{public}" PRIu64 " timer_elapsed: %{public}d", now, timer_elapsed);
-
-            if (timer_elapsed) {
-                chunk.length = pa_usec_to_bytes(now - u->timestamp, &u->source->sample_spec);
-                if (chunk.length > 0) {
-                    ret = get_capturer_frame_from_hdi(&chunk, u);
-                    if (ret != 0) {
-                        break;
-                    }
-
-                    u->timestamp += pa_bytes_to_usec(chunk.length, &u->source->sample_spec);
-                    AUDIO_DEBUG_LOG("HDI Source: new u->timestamp : %{public}" PRIu64, u->timestamp);
-                }
-            }
-
-            pa_rtpoll_set_timer_absolute(u->rtpoll, u->timestamp + u->block_usec);
-        } else {
-            pa_rtpoll_set_timer_disabled(u->rtpoll);
-            AUDIO_DEBUG_LOG("HDI Source: pa_rtpoll_set_timer_disabled done ");
-        }
+        // The reader thread does the blocking HDI reads, this thread only posts what it queued and stays free for
+        // messages, state changes and latency queries. It is woken through the ring fdsem, not by a timer.
+        capture_reader_set_reading(u, PA_SOURCE_IS_OPENED(u->source->thread_info.state) && u->IsCapturerStarted);
+        capture_ring_post(u);
+        pa_rtpoll_set_timer_disabled(u->rtpoll);
 
         /* Hmm, nothing to do. Let's sleep */
         if ((ret = pa_rtpoll_run(u->rtpoll)) < 0) {
@@ -258,9 +549,8 @@ static void thread_func(void *userdata)
             return;
         }
 
-        timer_elapsed = pa_rtpoll_timer_elapsed(u->rtpoll);
-
         if (ret == 0) {
+            capture_reader_set_reading(u, false);
             return;
         }
     }
@@ -510,6 +800,23 @@ pa_source *pa_hdi_source_new(pa_module *m, pa_modargs *ma, const char *driver)
     u->attrs.format = ConvertToHDIAudioFormat(ss.format);
     u->attrs.isBigEndian = GetEndianInfo(ss.format);
     u->attrs.adapterName = pa_modargs_get_value(ma, "adapter_name", DEFAULT_DEVICE_CLASS);
+    u->attrs.fileRealtime = false;
+    if (pa_modargs_get_value_boolean(ma, "file_realtime", &u->attrs.fileRealtime) < 0) {
+        AUDIO_ERR_LOG("Failed to parse file_realtime argument");
+        goto fail;
+    }
+    u->attrs.fileJitterUsec = 0;
+    if (pa_modargs_get_value_u32(ma, "file_jitter_usec", &u->attrs.fileJitterUsec) < 0) {
+        AUDIO_ERR_LOG("Failed to parse file_jitter_usec argument");
+        goto fail;
+    }
+
+    if (HdiThreadAttrParse(ma, &u->threadAttr) < 0) {
+        goto fail;
+    }
+    if (u->threadAttr.memLock) {
+        HdiThreadLockMemory();
+    }
 
     AUDIO_DEBUG_LOG("AudioDeviceCreateCapture format: %{public}d, isBigEndian: %{public}d channel: %{public}d,"
         "sampleRate: %{public}d", u->attrs.format, u->attrs.isBigEndian, u->attrs.channel, u->attrs.sampleRate);
@@ -527,6 +834,11 @@ pa_source *pa_hdi_source_new(pa_module *m, pa_modargs *ma, const char *driver)
         goto fail;
     }
 
+    if (capture_reader_init(u) != 0) {
+        AUDIO_ERR_LOG("Failed to create read-hdi thread!");
+        goto fail;
+    }
+
     thread_name = "hdi-source-record";
     if (!(u->thread = pa_thread_new(thread_name, thread_func, u))) {
         AUDIO_ERR_LOG("Failed to create hdi-source-record thread!");
@@ -537,6 +849,9 @@ pa_source *pa_hdi_source_new(pa_module *m, pa_modargs *ma, const char *driver)
     // Start modules in suspended state
     pa_source_suspend(u->source, true, PA_SUSPEND_IDLE);
 
+    u->pool.statsEvent = pa_core_rttime_new(u->core, pa_rtclock_now() + CAPTURE_STATS_INTERVAL_USEC,
+        capture_stats_time_cb, u);
+
     // register for source callbacks
     pa_module_hook_connect(m, &m->core->hooks[PA_CORE_HOOK_SOURCE_OUTPUT_UNLINK], PA_HOOK_NORMAL,
         (pa_hook_cb_t) SourceStreamDisconnectCb, u);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <linux/capability.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <pulsecore/core-util.h>
+#include <pulsecore/macro.h>
+
+#include "audio_log.h"
+#include "hdi_thread_util.h"
+
+#define CPU_AFFINITY_BITS 32
+
+int HdiThreadAttrParse(pa_modargs *ma, struct HdiThreadAttr *attr)
+{
+    pa_assert(ma);
+    pa_assert(attr);
+
+    attr->rtPriority = 0;
+    attr->cpuAffinity = 0;
+    attr->memLock = false;
+
+    if (pa_modargs_get_value_u32(ma, "rt_priority", &attr->rtPriority) < 0) {
+        AUDIO_ERR_LOG("Failed to parse rt_priority argument.");
+        return -1;
+    }
+
+    if (pa_modargs_get_value_u32(ma, "cpu_affinity", &attr->cpuAffinity) < 0) {
+        AUDIO_ERR_LOG("Failed to parse cpu_affinity argument.");
+        return -1;
+    }
+
+    if (pa_modargs_get_value_boolean(ma, "mlock", &attr->memLock) < 0) {
+        AUDIO_ERR_LOG("Failed to parse mlock argument.");
+        return -1;
+    }
+
+    int maxPriority = sched_get_priority_max(SCHED_RR);
+    if (maxPriority > 0) {
+        attr->rtPriority = PA_MIN(attr->rtPriority, (uint32_t)maxPriority);
+    }
+    return 0;
+}
+
+void HdiThreadAttrApply(const struct HdiThreadAttr *attr, const char *threadName)
+{
+    pa_assert(attr);
+
+    if (attr->rtPriority > 0 && pa_thread_make_realtime((int)attr->rtPriority) < 0) {
+        AUDIO_ERR_LOG("%{public}s: failed to set real-time priority %{public}u", threadName, attr->rtPriority);
+    }
+
+    if (attr->cpuAffinity != 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (uint32_t cpu = 0; cpu < CPU_AFFINITY_BITS; cpu++) {
+            if (attr->cpuAffinity & (1u << cpu)) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (ret != 0) {
+            AUDIO_ERR_LOG("%{public}s: failed to set cpu affinity 0x%{public}x: %{public}s", threadName,
+                attr->cpuAffinity, strerror(ret));
+        }
+    }
+
+    AUDIO_INFO_LOG("%{public}s: rt priority %{public}u, cpu affinity 0x%{public}x", threadName,
+        attr->rtPriority, attr->cpuAffinity);
+}
+
+static bool HasIpcLockCapability(void)
+{
+    struct __user_cap_header_struct header = { .version = _LINUX_CAPABILITY_VERSION_3, .pid = 0 };
+    struct __user_cap_data_struct data[_LINUX_CAPABILITY_U32S_3];
+    memset(data, 0, sizeof(data));
+
+    if (syscall(SYS_capget, &header, data) != 0) {
+        return false;
+    }
+    return (data[CAP_TO_INDEX(CAP_IPC_LOCK)].effective & CAP_TO_MASK(CAP_IPC_LOCK)) != 0;
+}
+
+// Future pages count against RLIMIT_MEMLOCK too, past it every allocation of the server would fail with ENOMEM
+static bool CanLockFutureMemory(void)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY) {
+        return true;
+    }
+    return HasIpcLockCapability();
+}
+
+// Module init runs on the main thread only, the flag needs no atomics
+void HdiThreadLockMemory(void)
+{
+    static bool isLocked = false;
+
+    if (isLocked) {
+        return;
+    }
+
+    bool lockFuture = CanLockFutureMemory();
+    int flags = lockFuture ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT;
+    // Fails once the process is larger than RLIMIT_MEMLOCK without CAP_IPC_LOCK, playback goes on unlocked
+    if (mlockall(flags) != 0) {
+        AUDIO_ERR_LOG("mlockall failed: %{public}s", strerror(errno));
+        return;
+    }
+    isLocked = true;
+    AUDIO_INFO_LOG("Locked audio server memory, future pages %{public}s", lockFuture ? "locked" : "not locked");
+}
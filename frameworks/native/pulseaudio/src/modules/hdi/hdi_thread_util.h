@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HDI_THREAD_UTIL_H
+#define HDI_THREAD_UTIL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <pulsecore/modargs.h>
+
+// Scheduling of the HDI module threads, from the rt_priority, cpu_affinity and mlock module arguments
+struct HdiThreadAttr {
+    uint32_t rtPriority;    // 0 keeps the default scheduling
+    uint32_t cpuAffinity;   // bit mask of the CPUs the threads may run on, 0 leaves them unrestricted
+    bool memLock;
+};
+
+int HdiThreadAttrParse(pa_modargs *ma, struct HdiThreadAttr *attr);
+
+// Called by each module thread on itself before it enters its loop
+void HdiThreadAttrApply(const struct HdiThreadAttr *attr, const char *threadName);
+
+// Locks the current pages of the process, so the render and capture paths never page fault. Future pages are only
+// locked when RLIMIT_MEMLOCK is unlimited or the process has CAP_IPC_LOCK.
+void HdiThreadLockMemory(void);
+
+#endif // HDI_THREAD_UTIL_H
@@ -37,6 +37,14 @@ PA_MODULE_USAGE(
         "channels=<number of channels> "
         "channel_map=<channel map> "
         "buffer_size=<custom buffer size>"
+        "deep_buffer_size=<largest render block for deep buffer streams>"
+        "render_queue_depth=<rendered blocks queued for the HDI writer>"
+        "render_batch_msec=<audio gathered per device write, a2dp only>"
+        "encoder_frame_samples=<samples per frame of the a2dp codec, batches are whole frames>"
+        "hardware_clock=<pace rendering by the device clock>"
+        "rt_priority=<real-time priority of the render threads>"
+        "cpu_affinity=<cpu mask of the render threads>"
+        "mlock=<lock the server memory>"
         "file_path=<file path for data writing>"
         "adapter_name=<primary>"
         "fixed_latency=<latency measure>"
@@ -55,6 +63,14 @@ static const char * const VALID_MODARGS[] = {
     "channels",
     "channel_map",
     "buffer_size",
+    "deep_buffer_size",
+    "render_queue_depth",
+    "render_batch_msec",
+    "encoder_frame_samples",
+    "hardware_clock",
+    "rt_priority",
+    "cpu_affinity",
+    "mlock",
     "file_path",
     "adapter_name",
     "fixed_latency",
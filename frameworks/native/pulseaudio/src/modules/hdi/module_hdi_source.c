@@ -40,8 +40,13 @@ PA_MODULE_USAGE(
         "channel_map=<channel map>"
         "buffer_size=<custom buffer size>"
         "file_path=<file path for data reading>"
+        "file_realtime=<deliver file data at the sample rate>"
+        "file_jitter_usec=<largest random delay of a paced file read>"
         "adapter_name=<primary1>"
         "open_mic_speaker<open mic>"
+        "rt_priority=<real-time priority of the capture thread>"
+        "cpu_affinity=<cpu mask of the capture thread>"
+        "mlock=<lock the server memory>"
     );
 
 static const char * const VALID_MODARGS[] = {
@@ -54,8 +59,13 @@ static const char * const VALID_MODARGS[] = {
     "channel_map",
     "buffer_size",
     "file_path",
+    "file_realtime",
+    "file_jitter_usec",
     "adapter_name",
     "open_mic_speaker",
+    "rt_priority",
+    "cpu_affinity",
+    "mlock",
     NULL
 };
 
@@ -87,6 +87,14 @@ public:
      * @param length Indicates requested buffer length.
      */
     virtual void OnReadData(size_t length) = 0;
+
+    /**
+     * Called when reading captured data into an enqueued buffer fails. The read is retried unless the stream has
+     * died, in which case capturing stops.
+     *
+     * @param errorCode Indicates the error code of the failed read.
+     */
+    virtual void OnReadError(int32_t errorCode) {}
 };
 
 /**
@@ -235,6 +243,27 @@ public:
      */
     virtual int32_t Read(uint8_t &buffer, size_t userSize, bool isBlockingRead) const = 0;
 
+    /**
+     * @brief Obtains the captured audio data in the stream's shared memory without copying it, blocking until
+     * data is available. The buffer is read only and must be returned by {@link ReleaseReadBuffer} before the
+     * next read. It is no longer valid once the capturer is stopped.
+     * * This API cannot be used if capture mode is CAPTURE_MODE_CALLBACK.
+     *
+     * @param bufDesc Indicates the buffer descriptor filled with the buffer address and the data size in bytes.
+     * @return Returns {@link SUCCESS} if the buffer is successfully obtained; returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t AcquireReadBuffer(BufferDesc &bufDesc) const = 0;
+
+    /**
+     * @brief Releases the buffer obtained by {@link AcquireReadBuffer}, the data in it is consumed.
+     * * This API cannot be used if capture mode is CAPTURE_MODE_CALLBACK.
+     *
+     * @return Returns {@link SUCCESS} if the buffer is successfully released; returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t ReleaseReadBuffer() const = 0;
+
     /**
      * @brief Obtains the audio capture state.
      *
@@ -252,6 +281,15 @@ public:
      */
     virtual bool GetAudioTime(Timestamp &timestamp, Timestamp::Timestampbase base) const = 0;
 
+    /**
+     * @brief Obtains the xrun, blocking time and callback timing statistics of the stream.
+     *
+     * @param stats Indicates the {@link AudioStreamStatistics} reference into which the statistics will be written.
+     * @return Returns {@link SUCCESS} if the statistics are successfully obtained, returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t GetStatistics(AudioStreamStatistics &stats) const = 0;
+
     virtual bool Pause() const = 0;
 
     /**
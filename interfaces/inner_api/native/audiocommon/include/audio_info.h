@@ -19,6 +19,7 @@
 #include <stdint.h>
 #endif // __MUSL__
 
+#include <array>
 #include <cmath>
 #include <limits>
 #include <string>
@@ -251,6 +252,10 @@ enum AudioSampleFormat {
     SAMPLE_S16LE = 1,
     SAMPLE_S24LE = 2,
     SAMPLE_S32LE = 3,
+    /**
+     * Converted on the client and carried to the device as S16LE, precision is limited to 16 bits and samples
+     * outside [-1.0, 1.0] are clipped
+     */
     SAMPLE_F32LE = 4,
     INVALID_WIDTH = -1
 };
@@ -461,6 +466,21 @@ struct AudioStreamInfo {
     AudioChannel channels;
 };
 
+/**
+ * Bits of AudioRendererInfo::rendererFlags
+ */
+enum AudioRendererFlag {
+    RENDERER_FLAG_NONE = 0,
+    /**
+     * Smallest buffering the sink accepts, data goes to the server without client side caching or silence prebuf
+     */
+    RENDERER_FLAG_LOW_LATENCY = 1,
+    /**
+     * Large server side buffer with rare wakeups for long-form playback, ignored with RENDERER_FLAG_LOW_LATENCY
+     */
+    RENDERER_FLAG_DEEP_BUFFER = 2
+};
+
 struct AudioRendererInfo {
     ContentType contentType = CONTENT_TYPE_UNKNOWN;
     StreamUsage streamUsage = STREAM_USAGE_UNKNOWN;
@@ -524,7 +544,8 @@ const std::vector<AudioSampleFormat> AUDIO_SUPPORTED_FORMATS {
     SAMPLE_U8,
     SAMPLE_S16LE,
     SAMPLE_S24LE,
-    SAMPLE_S32LE
+    SAMPLE_S32LE,
+    SAMPLE_F32LE
 };
 
 const std::vector<AudioChannel> RENDERER_SUPPORTED_CHANNELS {
@@ -576,6 +597,36 @@ struct BufferQueueState {
     uint32_t currentIndex;
 };
 
+constexpr size_t STATISTICS_JITTER_BUCKETS = 6;
+
+/**
+ * Health counters of a renderer or capturer stream since it was created.
+ * Blocking time covers Write calls of a renderer and Read calls of a capturer. callbackJitter counts the
+ * pulseaudio data requests by how far their interval strayed from the stream period: below 1, 2, 5, 10
+ * and 20 ms, and 20 ms or more.
+ */
+struct AudioStreamStatistics {
+    uint32_t underrunCount = 0;
+    uint32_t overrunCount = 0;
+    uint64_t maxBlockingTimeUsec = 0;
+    uint64_t avgBlockingTimeUsec = 0;
+    uint64_t bytesDropped = 0;
+    uint32_t bufferFillPercent = 0;
+    std::array<uint32_t, STATISTICS_JITTER_BUCKETS> callbackJitter = {};
+};
+
+/**
+ * Counters of the opt-in renderer stream pool. A hit is a renderer created from a pooled stream, a miss one
+ * created with pooled options while no stream was ready. Every hit saves the average stream setup time.
+ */
+struct AudioStreamPoolStats {
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+    uint32_t pooledCount = 0;
+    uint64_t avgSetupTimeUsec = 0;
+    uint64_t setupTimeSavedUsec = 0;
+};
+
 enum AudioRenderMode {
     RENDER_MODE_NORMAL,
     RENDER_MODE_CALLBACK
@@ -93,6 +93,27 @@ public:
      * @param length Indicates requested buffer length.
      */
     virtual void OnWriteData(size_t length) = 0;
+
+    /**
+     * Called when writing an enqueued buffer fails. The unwritten part is retried unless the stream has died, in
+     * which case the buffer is handed back and rendering stops.
+     *
+     * @param errorCode Indicates the error code of the failed write.
+     */
+    virtual void OnWriteError(int32_t errorCode) {}
+};
+
+class AudioRendererOperationCallback {
+public:
+    virtual ~AudioRendererOperationCallback() = default;
+
+    /**
+     * Called on the audio client notification thread when DrainAsync, FlushAsync, PauseAsync or StopAsync
+     * completes.
+     *
+     * @param success Indicates whether the audio server carried out the operation.
+     */
+    virtual void OnOperationComplete(bool success) = 0;
 };
 
 /**
@@ -161,6 +182,25 @@ public:
     static std::unique_ptr<AudioRenderer> Create(const std::string cachePath,
         const AudioRendererOptions &rendererOptions, const AppInfo &appInfo);
 
+    /**
+     * @brief Keeps prepared streams ready for a renderer configuration. Create with the same options then
+     * takes one of them instead of setting up a new stream. Meant for short sounds such as key clicks and
+     * notifications, each pooled stream holds server resources while it waits.
+     *
+     * @param rendererOptions The audio renderer configuration the pooled streams are created with.
+     * @param count The number of streams to keep ready, 0 stops pooling the configuration.
+     * @return Returns {@link SUCCESS} if the pool size is set; returns {@link ERR_INVALID_PARAM} if the
+     * configuration is invalid.
+     */
+    static int32_t SetStreamPoolSize(const AudioRendererOptions &rendererOptions, uint32_t count);
+
+    /**
+     * @brief Obtains the hit rate and setup time statistics of the renderer stream pool.
+     *
+     * @param stats Indicates the {@link AudioStreamPoolStats} reference into which the statistics will be written.
+     */
+    static void GetStreamPoolStats(AudioStreamPoolStats &stats);
+
     /**
      * @brief Sets audio renderer parameters.
      *
@@ -241,6 +281,28 @@ public:
      */
     virtual int32_t Write(uint8_t *buffer, size_t bufferSize) = 0;
 
+    /**
+     * @brief Obtains a buffer in the stream's shared memory to render audio data into directly.
+     * The buffer must be returned by {@link CommitWriteBuffer} before the next write.
+     * * This API cannot be used if render mode is RENDER_MODE_CALLBACK.
+     *
+     * @param bufDesc Indicates the buffer descriptor filled with the buffer address and its size in bytes.
+     * @return Returns {@link SUCCESS} if the buffer is successfully obtained; returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t AcquireWriteBuffer(BufferDesc &bufDesc) const = 0;
+
+    /**
+     * @brief Commits the audio data rendered into the buffer obtained by {@link AcquireWriteBuffer}.
+     * * This API cannot be used if render mode is RENDER_MODE_CALLBACK.
+     *
+     * @param length Indicates the size of the audio data in bytes, a multiple of the frame size.
+     * <b>0</b> releases the buffer without rendering.
+     * @return Returns {@link SUCCESS} if the data is successfully committed; returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t CommitWriteBuffer(size_t length) const = 0;
+
     /**
      * @brief Obtains the audio renderer state.
      *
@@ -267,6 +329,15 @@ public:
      */
     virtual int32_t GetLatency(uint64_t &latency) const = 0;
 
+    /**
+     * @brief Obtains the xrun, blocking time and callback timing statistics of the stream.
+     *
+     * @param stats Indicates the {@link AudioStreamStatistics} reference into which the statistics will be written.
+     * @return Returns {@link SUCCESS} if the statistics are successfully obtained, returns an error code
+     * defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t GetStatistics(AudioStreamStatistics &stats) const = 0;
+
     /**
      * @brief drain renderer buffer.
      *
@@ -295,6 +366,20 @@ public:
      */
     virtual bool Stop() const = 0;
 
+    /**
+     * @brief Drains, flushes, pauses or stops audio rendering without waiting for the audio server. The calls
+     * return once the request is sent, the callback reports its completion. Requests still pending when the
+     * renderer is released complete with <b>false</b>.
+     *
+     * @param callback Indicates the callback notified when the operation completes, may be nullptr.
+     * @return Returns {@link SUCCESS} if the request is sent, the callback is not invoked otherwise; returns
+     * an error code defined in {@link audio_errors.h} otherwise.
+     */
+    virtual int32_t DrainAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const = 0;
+    virtual int32_t FlushAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const = 0;
+    virtual int32_t PauseAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const = 0;
+    virtual int32_t StopAsync(const std::shared_ptr<AudioRendererOperationCallback> &callback) const = 0;
+
     /**
      * @brief Releases a local <b>AudioRenderer</b> object.
      *
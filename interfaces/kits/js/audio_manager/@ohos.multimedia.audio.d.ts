@@ -475,6 +475,29 @@ declare namespace audio {
     RENDER_RATE_HALF = 2
   }
 
+  /**
+   * Enum for audio renderer flags, combined into AudioRendererInfo.rendererFlags
+   * @since 8
+   * @syscap SystemCapability.Multimedia.Audio
+   */
+  enum AudioRendererFlag {
+    /**
+     * Default buffering
+     * @since 8
+     */
+    RENDERER_FLAG_NONE = 0,
+    /**
+     * Low latency, smallest buffering the output device accepts
+     * @since 8
+     */
+    RENDERER_FLAG_LOW_LATENCY = 1,
+    /**
+     * Deep buffer, large buffering with rare wakeups for long-form playback
+     * @since 8
+     */
+    RENDERER_FLAG_DEEP_BUFFER = 2
+  }
+
   /**
    * Enumerates audio interruption event types.
    * @since 7
@@ -34,6 +34,12 @@ static const std::map<std::string, AudioRendererRate> rendererRateMap = {
     {"RENDER_RATE_HALF", RENDER_RATE_HALF}
 };
 
+static const std::map<std::string, AudioRendererFlag> rendererFlagMap = {
+    {"RENDERER_FLAG_NONE", RENDERER_FLAG_NONE},
+    {"RENDERER_FLAG_LOW_LATENCY", RENDERER_FLAG_LOW_LATENCY},
+    {"RENDERER_FLAG_DEEP_BUFFER", RENDERER_FLAG_DEEP_BUFFER}
+};
+
 class AudioRendererNapi {
 public:
     AudioRendererNapi();
@@ -132,6 +138,7 @@ private:
 
     static napi_status AddNamedProperty(napi_env env, napi_value object, const std::string name, int32_t enumValue);
     static napi_value CreateAudioRendererRateObject(napi_env env);
+    static napi_value CreateAudioRendererFlagObject(napi_env env);
     static napi_value CreateInterruptEventTypeObject(napi_env env);
     static napi_value CreateInterruptForceTypeObject(napi_env env);
     static napi_value CreateInterruptHintTypeObject(napi_env env);
@@ -139,6 +146,7 @@ private:
     static napi_value CreateAudioSampleFormatObject(napi_env env);
 
     static napi_ref audioRendererRate_;
+    static napi_ref audioRendererFlag_;
     static napi_ref interruptEventType_;
     static napi_ref interruptForceType_;
     static napi_ref interruptHintType_;
@@ -18,11 +18,11 @@
 
 #include <pulse/pulseaudio.h>
 #include <audio_info.h>
-#include <audio_timer.h>
 #include <audio_errors.h>
 #include <vector>
 #include <pwd.h>
 #include <map>
+#include <mutex>
 #include "securec.h"
 #include "audio_log.h"
 #include "nocopyable.h"
@@ -54,6 +54,19 @@ typedef struct {
 typedef struct {
     std::string name;
     pa_sample_spec sampleSpec;
+    std::string renderWakeups;
+    std::string renderCpuLoad;
+    std::string renderBlockMsec;
+    std::string renderQueueDepth;
+    std::string renderQueueFill;
+    std::string renderQueuePeak;
+    std::string renderRateRatio;
+    std::string renderWriteRetries;
+    std::string renderWriteSleeps;
+    std::string renderSinkDropped;
+    std::string capturePoolSize;
+    std::string capturePoolHits;
+    std::string capturePoolAllocs;
 } SinkSourceInfo;
 
 typedef struct {
@@ -64,6 +77,11 @@ typedef struct {
     std::string applicationName;
     std::string processId;
     pa_sample_spec sampleSpec;
+    std::string statsUnderruns;
+    std::string statsOverruns;
+    std::string statsBytesDropped;
+    std::string statsBlockingUsec;
+    std::string statsJitter;
 }InputOutputInfo;
 
 typedef struct {
@@ -87,7 +105,7 @@ typedef struct {
     PolicyData policyData;
 } AudioData;
 
-class AudioServiceDump : public AudioTimer {
+class AudioServiceDump {
 public:
     DISALLOW_COPY_AND_MOVE(AudioServiceDump);
 
@@ -96,7 +114,6 @@ public:
     int32_t Initialize();
     void AudioDataDump(PolicyData &policyData, std::string &dumpString);
     static bool IsStreamSupported(AudioStreamType streamType);
-    virtual void OnTimeOut();
 
 private:
     pa_threaded_mainloop *mainLoop;
@@ -79,11 +79,21 @@ public:
     std::string format;
     std::string channels;
     std::string bufferSize;
+    std::string deepBufferSize;
+    std::string renderQueueDepth;
+    std::string renderBatchMsec;
+    std::string encoderFrameSamples;
+    std::string hardwareClock;
+    std::string rtPriority;
+    std::string cpuAffinity;
+    std::string memLock;
     std::string fixedLatency;
     std::string sinkLatency;
     std::string renderInIdleState;
     std::string OpenMicSpeaker;
     std::string fileName;
+    std::string fileRealtime;
+    std::string fileJitterUsec;
     std::list<AudioModuleInfo> ports;
 };
 } // namespace AudioStandard
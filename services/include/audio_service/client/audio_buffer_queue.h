@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_BUFFER_QUEUE_H
+#define AUDIO_BUFFER_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "audio_info.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Bounded lock-free multi-producer/multi-consumer queue.
+ *
+ * Every cell carries a sequence number that tells whether it is ready to be filled or drained in the
+ * current lap, so pushers and poppers on different threads only contend on their own index.
+ */
+template <typename T>
+class AudioLockFreeQueue {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    explicit AudioLockFreeQueue(size_t minCapacity)
+    {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+
+        cells_ = std::make_unique<Cell[]>(capacity);
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        for (size_t i = 0; i < capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~AudioLockFreeQueue() = default;
+
+    AudioLockFreeQueue(const AudioLockFreeQueue &) = delete;
+    AudioLockFreeQueue &operator=(const AudioLockFreeQueue &) = delete;
+
+    bool Push(T item)
+    {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T &item)
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->item);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Snapshot only, may be stale by the time the caller looks at it
+    size_t GetSize() const
+    {
+        size_t enqueuePos = enqueuePos_.load(std::memory_order_acquire);
+        size_t dequeuePos = dequeuePos_.load(std::memory_order_acquire);
+        return (enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0;
+    }
+
+    bool IsEmpty() const
+    {
+        return GetSize() == 0;
+    }
+
+    size_t GetCapacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence {0};
+        T item {};
+    };
+
+    std::unique_ptr<Cell[]> cells_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos_ {0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos_ {0};
+};
+
+// Free and filled buffer queues of the callback render and capture modes
+using AudioBufferQueue = AudioLockFreeQueue<BufferDesc>;
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_BUFFER_QUEUE_H
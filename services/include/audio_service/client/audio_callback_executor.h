@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_CALLBACK_EXECUTOR_H
+#define AUDIO_CALLBACK_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "audio_buffer_queue.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Process wide executor for client notifications such as OnMarkReached and OnPeriodReached.
+ *
+ * Tasks are posted from the pulseaudio mainloop and application threads through a bounded lock-free
+ * queue and run in order on one dispatcher thread, so a slow listener can never stall audio processing. No task
+ * is dropped: when the backlog is full it spills into an unbounded queue, and later tasks follow it there until
+ * the dispatcher catches up. The mutex is only taken to spill or to wake an idle dispatcher.
+ */
+class AudioCallbackExecutor {
+public:
+    using Task = std::function<void()>;
+
+    static AudioCallbackExecutor &GetInstance();
+
+    /**
+    * Queues a task to be run on the dispatcher thread, spilling into an unbounded overflow queue when the backlog
+    * is full
+    *
+    * @param task the notification to run
+    */
+    void PostReliable(Task task);
+
+private:
+    AudioCallbackExecutor();
+    ~AudioCallbackExecutor();
+
+    AudioCallbackExecutor(const AudioCallbackExecutor &) = delete;
+    AudioCallbackExecutor &operator=(const AudioCallbackExecutor &) = delete;
+
+    void DispatchLoop();
+    void WakeDispatcher();
+    bool PopOverflow(Task &task);
+
+    static constexpr size_t MAX_PENDING_TASKS = 64;
+
+    AudioLockFreeQueue<Task> taskQ_ {MAX_PENDING_TASKS};
+    std::atomic<bool> isRunning_ {true};
+    std::atomic<bool> isOverflowing_ {false}; // set while overflowQ_ holds tasks
+    std::atomic<bool> isSleeping_ {false};
+    std::mutex dispatchMutex_;
+    std::deque<Task> overflowQ_; // guarded by dispatchMutex_
+    std::condition_variable dispatchCond_;
+    std::thread dispatchThread_;
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_CALLBACK_EXECUTOR_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_FORMAT_CONVERTER_H
+#define AUDIO_FORMAT_CONVERTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "audio_info.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Interleaved PCM sample format converter for U8, S16LE, S24LE (packed), S32LE and F32LE.
+ *
+ * S16 and S32 to and from F32 run through SSE2/AVX2 or NEON (ARMv7 and AArch64) kernels, everything else
+ * goes through a float scratch buffer with scalar loops. Narrowing to U8 or S16 can add TPDF dither, which
+ * keeps a generator state, so an instance must not be shared between threads.
+ */
+class AudioFormatConverter {
+public:
+    static constexpr size_t SCRATCH_SAMPLES = 1024;
+
+    AudioFormatConverter() = default;
+    ~AudioFormatConverter() = default;
+
+    AudioFormatConverter(const AudioFormatConverter &) = delete;
+    AudioFormatConverter &operator=(const AudioFormatConverter &) = delete;
+
+    static bool IsSupported(AudioSampleFormat format);
+    static size_t GetSampleSize(AudioSampleFormat format);
+
+    void SetDitherEnabled(bool enabled);
+    bool IsDitherEnabled() const;
+
+    /**
+     * Converts sampleCount samples (frames * channels) from src to dst. The buffers must not overlap.
+     *
+     * @return Returns {@link SUCCESS}, or {@link ERR_INVALID_PARAM} / {@link ERR_NOT_SUPPORTED} on bad input.
+     */
+    int32_t Convert(const uint8_t *src, AudioSampleFormat srcFormat, uint8_t *dst, AudioSampleFormat dstFormat,
+        size_t sampleCount);
+
+private:
+    static void ToFloat(const uint8_t *src, AudioSampleFormat format, float *dst, size_t count);
+    static void FromFloat(const float *src, AudioSampleFormat format, uint8_t *dst, size_t count);
+    static bool ConvertDirect(const uint8_t *src, AudioSampleFormat srcFormat, uint8_t *dst,
+        AudioSampleFormat dstFormat, size_t count);
+    bool NeedsDither(AudioSampleFormat srcFormat, AudioSampleFormat dstFormat) const;
+    void AddDither(float *samples, size_t count, float lsb);
+
+    bool isDitherEnabled_ = false;
+    uint32_t ditherSeed_ = 1;
+    std::array<float, SCRATCH_SAMPLES> scratch_ = {};
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_FORMAT_CONVERTER_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_PA_CONTEXT_H
+#define AUDIO_PA_CONTEXT_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <pulse/pulseaudio.h>
+#include <pulse/thread-mainloop.h>
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Process wide pulseaudio connection shared by all AudioServiceClient instances.
+ *
+ * One threaded mainloop and one connected context serve every stream of the process. Each client
+ * holds a reference while it is initialized; the last reference stops the mainloop and disconnects.
+ * If the connection has failed (e.g. the server restarted), the next Acquire creates a new one.
+ * No application callback runs on the mainloop thread: data requests, state changes, marks, periods and
+ * operation completions are handed to the AudioCallbackExecutor, so a slow listener of one stream cannot
+ * stall the data callbacks of the others.
+ */
+class AudioPaContext {
+public:
+    /**
+    * Obtains the shared connection, connecting it on first use
+    *
+    * @param cachePath application cache path used to hand the auth cookie to pulseaudio, may be empty
+    * @return Returns the connected context; returns {@code nullptr} on failure.
+    */
+    static std::shared_ptr<AudioPaContext> Acquire(const std::string &cachePath);
+
+    ~AudioPaContext();
+
+    pa_threaded_mainloop *GetMainLoop() const
+    {
+        return mainLoop_;
+    }
+
+    pa_mainloop_api *GetApi() const
+    {
+        return api_;
+    }
+
+    pa_context *GetContext() const
+    {
+        return context_;
+    }
+
+private:
+    AudioPaContext() = default;
+    AudioPaContext(const AudioPaContext &) = delete;
+    AudioPaContext &operator=(const AudioPaContext &) = delete;
+
+    bool Connect(const std::string &cachePath);
+    bool IsReady();
+    void Release();
+    static void PAContextStateCb(pa_context *context, void *userdata);
+
+    static std::mutex instanceMutex_;
+    static std::weak_ptr<AudioPaContext> instance_;
+
+    pa_threaded_mainloop *mainLoop_ = nullptr;
+    pa_mainloop_api *api_ = nullptr;
+    pa_context *context_ = nullptr;
+    bool isMainLoopStarted_ = false;
+    bool isContextConnected_ = false;
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_PA_CONTEXT_H
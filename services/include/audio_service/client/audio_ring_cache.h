@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_RING_CACHE_H
+#define AUDIO_RING_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "securec.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Lock-free single-producer/single-consumer byte ring.
+ *
+ * The capacity is rounded up to a power of two so that the read and write indices can run freely and
+ * be masked on access. Each index lives on its own cache line, so the producer (application write thread)
+ * and the consumer (pulseaudio mainloop thread) never share a line they both modify.
+ */
+class AudioRingCache {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    AudioRingCache() = default;
+    ~AudioRingCache() = default;
+
+    AudioRingCache(const AudioRingCache &) = delete;
+    AudioRingCache &operator=(const AudioRingCache &) = delete;
+
+    bool Init(size_t minCapacity)
+    {
+        if (minCapacity == 0) {
+            return false;
+        }
+
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+
+        buffer_ = std::make_unique<uint8_t[]>(capacity);
+        if (buffer_ == nullptr) {
+            return false;
+        }
+
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        Reset();
+        return true;
+    }
+
+    // Only safe when neither the producer nor the consumer is active
+    void Reset()
+    {
+        writeIndex_.store(0, std::memory_order_relaxed);
+        readIndex_.store(0, std::memory_order_relaxed);
+    }
+
+    bool IsValid() const
+    {
+        return buffer_ != nullptr;
+    }
+
+    size_t GetCapacity() const
+    {
+        return capacity_;
+    }
+
+    size_t GetReadableSize() const
+    {
+        return writeIndex_.load(std::memory_order_acquire) - readIndex_.load(std::memory_order_acquire);
+    }
+
+    size_t GetWritableSize() const
+    {
+        return capacity_ - GetReadableSize();
+    }
+
+    // Producer side. Returns the number of bytes copied into the ring, which may be less than length.
+    size_t Write(const uint8_t *data, size_t length)
+    {
+        if (buffer_ == nullptr || data == nullptr) {
+            return 0;
+        }
+
+        size_t writeIndex = writeIndex_.load(std::memory_order_relaxed);
+        size_t readIndex = readIndex_.load(std::memory_order_acquire);
+        size_t len = std::min(length, capacity_ - (writeIndex - readIndex));
+        if (len == 0) {
+            return 0;
+        }
+
+        size_t offset = writeIndex & mask_;
+        size_t first = std::min(len, capacity_ - offset);
+        if (memcpy_s(buffer_.get() + offset, capacity_ - offset, data, first)) {
+            return 0;
+        }
+        if ((len > first) && memcpy_s(buffer_.get(), capacity_, data + first, len - first)) {
+            return 0;
+        }
+
+        writeIndex_.store(writeIndex + len, std::memory_order_release);
+        return len;
+    }
+
+    // Consumer side. Returns the number of bytes copied out of the ring, which may be less than length.
+    size_t Read(uint8_t *data, size_t length)
+    {
+        if (buffer_ == nullptr || data == nullptr) {
+            return 0;
+        }
+
+        size_t readIndex = readIndex_.load(std::memory_order_relaxed);
+        size_t writeIndex = writeIndex_.load(std::memory_order_acquire);
+        size_t len = std::min(length, writeIndex - readIndex);
+        if (len == 0) {
+            return 0;
+        }
+
+        size_t offset = readIndex & mask_;
+        size_t first = std::min(len, capacity_ - offset);
+        if (memcpy_s(data, length, buffer_.get() + offset, first)) {
+            return 0;
+        }
+        if ((len > first) && memcpy_s(data + first, length - first, buffer_.get(), len - first)) {
+            return 0;
+        }
+
+        readIndex_.store(readIndex + len, std::memory_order_release);
+        return len;
+    }
+
+    // Consumer side. Discards up to length bytes without copying them.
+    size_t Skip(size_t length)
+    {
+        size_t readIndex = readIndex_.load(std::memory_order_relaxed);
+        size_t writeIndex = writeIndex_.load(std::memory_order_acquire);
+        size_t len = std::min(length, writeIndex - readIndex);
+
+        readIndex_.store(readIndex + len, std::memory_order_release);
+        return len;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> writeIndex_ {0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> readIndex_ {0};
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_RING_CACHE_H
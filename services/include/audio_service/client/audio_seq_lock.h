@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_SEQ_LOCK_H
+#define AUDIO_SEQ_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+#include "securec.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Sequence lock around a small trivially copyable value.
+ *
+ * One writer publishes a new value without blocking; any number of readers copy it lock-free and retry
+ * if a write raced with the copy. The value is stored as atomic words so that racing copies are defined.
+ */
+template <typename T>
+class AudioSeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "AudioSeqLock requires a trivially copyable type");
+
+public:
+    AudioSeqLock() = default;
+    ~AudioSeqLock() = default;
+
+    AudioSeqLock(const AudioSeqLock &) = delete;
+    AudioSeqLock &operator=(const AudioSeqLock &) = delete;
+
+    // Writer side, callers must serialize writes
+    void Write(const T &value)
+    {
+        uint64_t words[WORD_COUNT] = {0};
+        if (memcpy_s(words, sizeof(words), &value, sizeof(T))) {
+            return;
+        }
+
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + SEQUENCE_STEP, std::memory_order_release);
+    }
+
+    // Returns false if nothing has been published yet or the writer kept racing with the reader
+    bool Read(T &value) const
+    {
+        uint64_t words[WORD_COUNT];
+        for (int32_t retry = 0; retry < MAX_READ_RETRY; ++retry) {
+            uint32_t sequence = sequence_.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t i = 0; i < WORD_COUNT; ++i) {
+                words[i] = data_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            if (sequence == 0 || memcpy_s(&value, sizeof(T), words, sizeof(T))) {
+                return false;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Marks the value as never published, only safe when no write is in progress
+    void Reset()
+    {
+        sequence_.store(0, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    static constexpr uint32_t SEQUENCE_STEP = 2;
+    static constexpr int32_t MAX_READ_RETRY = 16;
+
+    std::atomic<uint32_t> sequence_ {0};
+    std::atomic<uint64_t> data_[WORD_COUNT] = {};
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_SEQ_LOCK_H
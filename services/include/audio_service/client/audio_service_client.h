@@ -18,8 +18,12 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -31,7 +35,11 @@
 #include <pulse/thread-mainloop.h>
 #include <audio_error.h>
 #include <audio_info.h>
-#include <audio_timer.h>
+#include <audio_callback_executor.h>
+#include <audio_pa_context.h>
+#include <audio_ring_cache.h>
+#include <audio_seq_lock.h>
+#include <audio_stream_stats.h>
 
 #include "audio_capturer.h"
 #include "audio_policy_manager.h"
@@ -52,18 +60,21 @@ typedef pa_sink_info          SinkDeviceInfo;
 typedef pa_source_info        SourceDeviceInfo;
 typedef pa_client_info        ClientInfo;
 
+// Stream timing published by the mainloop thread, read lock-free by GetCurrentTimeStamp and GetAudioLatency
+struct StreamTimingSnapshot {
+    uint64_t timeStamp; // write index in usec for playback, stream time in usec for record
+    uint64_t latency; // pulseaudio latency in usec
+    uint64_t publishTime; // monotonic time of the update in usec
+    uint64_t isRunning; // non zero when the stream is not corked, the timing can be interpolated
+};
+
 struct StreamBuffer {
     uint8_t *buffer; // the virtual address of stream
     uint32_t bufferLen; // stream length in bytes
 };
 
-struct AudioCache {
-    std::unique_ptr<uint8_t[]> buffer;
-    uint32_t readIndex;
-    uint32_t writeIndex;
-    uint32_t totalCacheSize;
-    bool isFull;
-};
+// Completion of an asynchronous stream operation, runs on the AudioCallbackExecutor thread
+using StreamOperationCallback = std::function<void(bool success)>;
 
 /**
  * @brief Enumerates the stream states of the current device.
@@ -124,7 +135,7 @@ public:
     virtual void OnEventCb(AudioServiceEventTypes error) const = 0;
 };
 
-class AudioServiceClient : public AudioTimer {
+class AudioServiceClient {
 public:
     static constexpr char PA_RUNTIME_DIR[] = "/data/data/.pulse_dir/runtime";
     static constexpr char PA_STATE_DIR[] = "/data/data/.pulse_dir/state";
@@ -196,6 +207,19 @@ public:
     */
     int32_t PauseStream();
 
+    /**
+    * Asynchronous variants of DrainStream, FlushStream, PauseStream and StopStream. They return as soon as
+    * the request is sent to the server, the callback is invoked when it completes. Operations still pending
+    * when the stream is released complete with {@code false}.
+    *
+    * @param callback invoked with the result of the operation, not invoked if the request fails to be sent
+    * @return Returns {@code 0} if the request is sent; returns {@code -1} otherwise.
+    */
+    int32_t DrainStreamAsync(const StreamOperationCallback &callback);
+    int32_t FlushStreamAsync(const StreamOperationCallback &callback);
+    int32_t PauseStreamAsync(const StreamOperationCallback &callback);
+    int32_t StopStreamAsync(const StreamOperationCallback &callback);
+
     /**
     * Update the stream type
     *
@@ -243,6 +267,23 @@ public:
     */
     size_t WriteStreamInCb(const StreamBuffer &stream, int32_t &pError);
 
+    /**
+    * Obtains a buffer inside the stream's shared memory block, so audio data can be rendered
+    * without an intermediate copy. Data cached by WriteStream is pushed to the sink first.
+    *
+    * @param stream filled with the buffer address and the writable size in bytes, frame aligned
+    * @return Returns {@code 0} if success; returns {@code -1} failure.
+    */
+    int32_t AcquireWriteStreamBuffer(StreamBuffer &stream);
+
+    /**
+    * Commits audio data rendered into the buffer obtained by AcquireWriteStreamBuffer
+    *
+    * @param length indicates the size of valid audio data in bytes, 0 discards the buffer
+    * @return Returns {@code 0} if success; returns {@code -1} failure.
+    */
+    int32_t CommitWriteStreamBuffer(size_t length);
+
     /**
     * Reads audio data of the stream created using CreateStream from active source device
     *
@@ -253,6 +294,22 @@ public:
     */
     int32_t ReadStream(StreamBuffer &stream, bool isBlocking);
 
+    /**
+    * Lends the captured fragment at the head of the stream without copying it. Blocks until data is available.
+    * The buffer is read only and stays valid until ReleaseReadStreamBuffer or StopStream.
+    *
+    * @param stream filled with the fragment address and its size in bytes
+    * @return Returns {@code 0} if success; returns {@code -1} failure.
+    */
+    int32_t AcquireReadStreamBuffer(StreamBuffer &stream);
+
+    /**
+    * Drops the fragment lent by AcquireReadStreamBuffer
+    *
+    * @return Returns {@code 0} if success; returns {@code -1} failure.
+    */
+    int32_t ReleaseReadStreamBuffer();
+
     /**
     * Release the resources allocated using CreateStream
     *
@@ -276,6 +333,14 @@ public:
     */
     int32_t GetAudioLatency(uint64_t &latency);
 
+    /**
+    * Provides xrun, blocking time and callback timing statistics of the stream created using CreateStream
+    *
+    * @param stats will be filled up with the statistics collected since the stream was created
+    * @return Returns {@code 0} if success; returns {@code -1} otherwise.
+    */
+    int32_t GetStreamStatistics(AudioStreamStatistics &stats);
+
     /**
     * Provides the playback/record stream parameters created using CreateStream
     *
@@ -438,6 +503,40 @@ public:
      */
     AudioRendererRate GetStreamRenderRate();
 
+    /**
+     * @brief Selects low latency buffering for a playback stream. Must be called before the stream is created.
+     *
+     * In low latency mode the smallest buffering accepted by the sink is requested, writes go to the server
+     * directly instead of through the client cache, and no silence is prebuffered on the first write.
+     *
+     * @param isLowLatency Whether the stream uses low latency buffering.
+     */
+    void SetLowLatencyMode(bool isLowLatency);
+
+    /**
+     * @brief Checks whether the stream uses low latency buffering
+     *
+     * @return Returns true if low latency mode is selected
+     */
+    bool IsLowLatencyMode() const;
+
+    /**
+     * @brief Selects deep buffering for long-form playback. Must be called before the stream is created.
+     *
+     * In deep buffer mode a multi-hundred-millisecond buffer is requested and data is handed over in large
+     * chunks, so the client and the sink wake up rarely. Ignored when low latency mode is selected.
+     *
+     * @param isDeepBuffer Whether the stream uses deep buffering.
+     */
+    void SetDeepBufferMode(bool isDeepBuffer);
+
+    /**
+     * @brief Checks whether the stream uses deep buffering
+     *
+     * @return Returns true if deep buffer mode is selected
+     */
+    bool IsDeepBufferMode() const;
+
     /**
      * @brief Set the buffer duration in msec
      *
@@ -482,6 +581,21 @@ public:
     int32_t SaveWriteCallback(const std::weak_ptr<AudioRendererWriteCallback> &callback);
     int32_t SetAudioCaptureMode(AudioCaptureMode captureMode);
     int32_t SaveReadCallback(const std::weak_ptr<AudioCapturerReadCallback> &callback);
+
+    /**
+     * @brief Reports a failed callback mode write or read to the registered app callback.
+     *
+     * @return none
+     */
+    void ReportWriteError(int32_t errorCode);
+    void ReportReadError(int32_t errorCode);
+
+    /**
+     * @brief Checks whether the context and the stream are still usable, a failed one never recovers.
+     *
+     * @return Returns true if data can still be written or read
+     */
+    bool IsStreamUsable();
     AudioCaptureMode GetAudioCaptureMode();
     /**
      * @brief Set the applicationcache path to access the application resources
@@ -497,12 +611,18 @@ public:
      */
     bool VerifyClientPermission(const std::string &permissionName, uint32_t appTokenId, int32_t appUid);
 
-    // Audio timer callback
-    virtual void OnTimeOut();
-
     void SetClientID(int32_t clientPid, int32_t clientUid);
 
 private:
+    // An asynchronous operation in flight, owned by pendingOperations_ and passed to pulseaudio as userdata
+    struct PendingStreamOperation {
+        AudioServiceClient *client = nullptr;
+        pa_operation *operation = nullptr;
+        State targetState = INVALID; // entered on success, for cork operations
+        StreamOperationCallback callback;
+    };
+
+    std::shared_ptr<AudioPaContext> paContext_ = nullptr;
     pa_threaded_mainloop *mainLoop;
     pa_mainloop_api *api;
     pa_context *context;
@@ -516,26 +636,39 @@ private:
     std::mutex rendererMarkReachedMutex_;
     std::mutex rendererPeriodReachedMutex_;
 
-    AudioCache acache;
+    AudioRingCache ringCache_;
+    size_t cacheThreshold_ = 0;
+    std::atomic<bool> isCacheStarved_ {false};
+    std::atomic<bool> isCacheWriterWaiting_ {false};
+    std::mutex cacheWaitMutex_;
+    std::condition_variable cacheWaitCond_;
+    void *acquiredWriteBuffer_ = nullptr;
+    size_t acquiredWriteBufferLen_ = 0;
+    bool isReadBufferAcquired_ = false;
+    AudioSeqLock<StreamTimingSnapshot> timingSnapshot_;
+    AudioStreamStatsCollector streamStats_;
+    pa_usec_t callbackPeriodUsec_ = 0;
+    pa_usec_t lastStatsPublishUsec_ = 0;
+    // Guarded by the mainloop lock
+    std::list<std::unique_ptr<PendingStreamOperation>> pendingOperations_;
+    PendingStreamOperation *cacheDrainOperation_ = nullptr; // async drain waiting for the ring cache to empty
     const void *internalReadBuffer;
     size_t internalRdBufLen;
     size_t internalRdBufIndex;
     size_t setBufferSize;
     int32_t streamCmdStatus;
-    int32_t updatePropStatus;
     int32_t streamDrainStatus;
     int32_t streamFlushStatus;
-    bool isMainLoopStarted;
-    bool isContextConnected;
     bool isStreamConnected;
 
     std::unique_ptr<uint8_t[]> preBuf_ {nullptr};
     uint32_t sinkLatencyInMsec_ {0};
+    bool isLowLatency_ = false;
+    bool isDeepBuffer_ = false;
 
     int32_t clientPid_ = 0;
     int32_t clientUid_ = 0;
 
-    std::string appCookiePath = "";
     std::string cachePath_ = "";
 
     float mVolumeFactor;
@@ -543,11 +676,14 @@ private:
     AudioStreamType mStreamType;
     AudioSystemManager *mAudioSystemMgr;
 
-    pa_cvolume cvolume;
     uint32_t streamIndex;
     uint32_t sessionID;
     uint32_t volumeChannels;
-    bool streamInfoUpdated;
+    pa_volume_t targetPaVolume_ = PA_VOLUME_NORM;
+    pa_operation *volumeOperation_ = nullptr;
+    bool isVolumeUpdatePending_ = false;
+    bool isReadTimedOut_ = false;
+    pa_time_event *readTimeoutEvent_ = nullptr;
 
     AudioRendererRate renderRate;
     AudioRenderMode renderMode_;
@@ -570,8 +706,10 @@ private:
     std::shared_ptr<CapturerPositionCallback> mCapturePositionCb;
     std::shared_ptr<CapturerPeriodPositionCallback> mCapturePeriodPositionCb;
 
-    std::vector<std::unique_ptr<std::thread>> mPositionCBThreads;
-    std::vector<std::unique_ptr<std::thread>> mPeriodPositionCBThreads;
+    // Notifications raised but not yet delivered, one queued task on the callback executor delivers all of them
+    std::shared_ptr<std::atomic<uint64_t>> pendingPeriods_ = std::make_shared<std::atomic<uint64_t>>(0);
+    std::shared_ptr<std::atomic<uint64_t>> pendingWriteRequests_ = std::make_shared<std::atomic<uint64_t>>(0);
+    std::shared_ptr<std::atomic<uint64_t>> pendingReadRequests_ = std::make_shared<std::atomic<uint64_t>>(0);
 
     std::weak_ptr<AudioStreamCallback> streamCallback_;
     State state_;
@@ -597,11 +735,30 @@ private:
     int32_t InitializeAudioCache();
     size_t WriteToAudioCache(const StreamBuffer &stream);
     int32_t DrainAudioCache();
+    size_t FlushRingCacheToPA(size_t maxLength);
+    void KickRingCacheDrain();
+    bool WaitRingCacheWritable();
+    void NotifyRingCacheWritable();
 
     int32_t UpdateReadBuffer(uint8_t *buffer, size_t &length, size_t &readSize);
     int32_t PaWriteStream(const uint8_t *buffer, size_t &length);
     void HandleRenderPositionCallbacks(size_t bytesWritten);
     void HandleCapturePositionCallbacks(size_t bytesRead);
+    static void PostCountedNotification(const std::shared_ptr<std::atomic<uint64_t>> &pending,
+        const std::function<void()> &notify, uint64_t count);
+    void PostStateChange(State state);
+    void PublishTimingSnapshot();
+    void RecordDataCallback();
+    PendingStreamOperation *AddPendingOperation(State targetState, const StreamOperationCallback &callback);
+    void CompletePendingOperation(PendingStreamOperation *pending, bool success);
+    void CancelPendingOperations();
+    void SendDrainOperation(PendingStreamOperation *pending);
+    void ContinueCacheDrain();
+    int32_t CorkStreamAsync(State targetState, const StreamOperationCallback &callback);
+    void PublishStreamStatistics();
+    int32_t QueryAudioLatency(pa_usec_t &paLatency);
+    float GetAppliedVolume();
+    int32_t UpdatePaVolume();
 
     void WriteStateChangedSysEvents();
 
@@ -645,24 +802,28 @@ private:
     // For setting some environment variables required while running from hap
     void SetEnv();
     int32_t CorkStream();
+    bool WaitForReadData();
+    void EndReadWait();
+    int32_t PeekReadFragment(bool isBlocking);
 
     // Callbacks to be implemented
     static void PAStreamStateCb(pa_stream *stream, void *userdata);
     static void PAStreamUnderFlowCb(pa_stream *stream, void *userdata);
-    static void PAContextStateCb(pa_context *context, void *userdata);
+    static void PAStreamOverFlowCb(pa_stream *stream, void *userdata);
     static void PAStreamReadCb(pa_stream *stream, size_t length, void *userdata);
     static void PAStreamStartSuccessCb(pa_stream *stream, int32_t success, void *userdata);
     static void PAStreamStopSuccessCb(pa_stream *stream, int32_t success, void *userdata);
     static void PAStreamPauseSuccessCb(pa_stream *stream, int32_t success, void *userdata);
-    static void PAStreamUpdatePropSuccessCb(pa_stream *stream, int32_t success, void *userdata);
     static void PAStreamWriteCb(pa_stream *stream, size_t length, void *userdata);
     static void PAStreamDrainSuccessCb(pa_stream *stream, int32_t success, void *userdata);
     static void PAStreamFlushSuccessCb(pa_stream *stream, int32_t success, void *userdata);
     static void PAStreamLatencyUpdateCb(pa_stream *stream, void *userdata);
     static void PAStreamSetBufAttrSuccessCb(pa_stream *stream, int32_t success, void *userdata);
+    static void PAStreamAsyncSuccessCb(pa_stream *stream, int32_t success, void *userdata);
 
-    static void GetSinkInputInfoCb(pa_context *c, const pa_sink_input_info *i, int eol, void *userdata);
-    static void SetPaVolume(const AudioServiceClient &client);
+    static void PAStreamVolumeUpdateCb(pa_context *c, int success, void *userdata);
+    static void PAReadTimeoutCb(pa_mainloop_api *mainLoopApi, pa_time_event *event, const struct timeval *tv,
+        void *userdata);
 };
 } // namespace AudioStandard
 } // namespace OHOS
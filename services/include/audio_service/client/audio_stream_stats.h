@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_STREAM_STATS_H
+#define AUDIO_STREAM_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "audio_info.h"
+
+namespace OHOS {
+namespace AudioStandard {
+/**
+ * Collects the counters behind AudioStreamStatistics.
+ *
+ * Xrun and callback events arrive on the pulseaudio mainloop thread, blocking times on the application thread
+ * that writes or reads (serialized by the client data mutex), and the snapshot is taken from any thread. All
+ * counters are relaxed atomics, a snapshot may mix values from slightly different moments.
+ */
+class AudioStreamStatsCollector {
+public:
+    // Upper bounds of the callback jitter buckets, the last bucket takes everything above
+    static constexpr std::array<uint64_t, STATISTICS_JITTER_BUCKETS - 1> JITTER_BUCKET_LIMITS_USEC = {
+        1000, 2000, 5000, 10000, 20000
+    };
+
+    AudioStreamStatsCollector() = default;
+    ~AudioStreamStatsCollector() = default;
+
+    AudioStreamStatsCollector(const AudioStreamStatsCollector &) = delete;
+    AudioStreamStatsCollector &operator=(const AudioStreamStatsCollector &) = delete;
+
+    void Reset()
+    {
+        underrunCount_.store(0, std::memory_order_relaxed);
+        overrunCount_.store(0, std::memory_order_relaxed);
+        blockingCount_.store(0, std::memory_order_relaxed);
+        blockingTotalUsec_.store(0, std::memory_order_relaxed);
+        maxBlockingUsec_.store(0, std::memory_order_relaxed);
+        bytesDropped_.store(0, std::memory_order_relaxed);
+        for (auto &bucket : callbackJitter_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        lastCallbackUsec_ = 0;
+    }
+
+    void AddUnderrun()
+    {
+        underrunCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AddOverrun()
+    {
+        overrunCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AddDroppedBytes(uint64_t bytes)
+    {
+        bytesDropped_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // Single writer, the caller holds the client data mutex
+    void AddBlockingTime(uint64_t usec)
+    {
+        blockingCount_.fetch_add(1, std::memory_order_relaxed);
+        blockingTotalUsec_.fetch_add(usec, std::memory_order_relaxed);
+        if (usec > maxBlockingUsec_.load(std::memory_order_relaxed)) {
+            maxBlockingUsec_.store(usec, std::memory_order_relaxed);
+        }
+    }
+
+    // Mainloop thread only. Buckets how far the interval since the previous callback strayed from the period.
+    void AddCallback(uint64_t nowUsec, uint64_t periodUsec)
+    {
+        if (lastCallbackUsec_ != 0 && nowUsec > lastCallbackUsec_) {
+            uint64_t interval = nowUsec - lastCallbackUsec_;
+            uint64_t jitter = (interval > periodUsec) ? (interval - periodUsec) : (periodUsec - interval);
+            size_t bucket = 0;
+            while (bucket < JITTER_BUCKET_LIMITS_USEC.size() && jitter >= JITTER_BUCKET_LIMITS_USEC[bucket]) {
+                bucket++;
+            }
+            callbackJitter_[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+        lastCallbackUsec_ = nowUsec;
+    }
+
+    // Mainloop thread only. Callbacks pause while the stream is corked, that gap is not jitter.
+    void RestartCallbackClock()
+    {
+        lastCallbackUsec_ = 0;
+    }
+
+    void GetStatistics(AudioStreamStatistics &stats) const
+    {
+        stats.underrunCount = underrunCount_.load(std::memory_order_relaxed);
+        stats.overrunCount = overrunCount_.load(std::memory_order_relaxed);
+        stats.bytesDropped = bytesDropped_.load(std::memory_order_relaxed);
+        stats.maxBlockingTimeUsec = maxBlockingUsec_.load(std::memory_order_relaxed);
+        uint64_t count = blockingCount_.load(std::memory_order_relaxed);
+        stats.avgBlockingTimeUsec = (count == 0) ? 0 : (blockingTotalUsec_.load(std::memory_order_relaxed) / count);
+        for (size_t i = 0; i < STATISTICS_JITTER_BUCKETS; i++) {
+            stats.callbackJitter[i] = callbackJitter_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<uint32_t> underrunCount_ {0};
+    std::atomic<uint32_t> overrunCount_ {0};
+    std::atomic<uint64_t> blockingCount_ {0};
+    std::atomic<uint64_t> blockingTotalUsec_ {0};
+    std::atomic<uint64_t> maxBlockingUsec_ {0};
+    std::atomic<uint64_t> bytesDropped_ {0};
+    std::array<std::atomic<uint32_t>, STATISTICS_JITTER_BUCKETS> callbackJitter_ = {};
+    uint64_t lastCallbackUsec_ = 0;
+};
+} // namespace AudioStandard
+} // namespace OHOS
+#endif // AUDIO_STREAM_STATS_H
@@ -19,6 +19,74 @@ using namespace std;
 
 namespace OHOS {
 namespace AudioStandard {
+namespace {
+// Render statistics published by the HDI sink as sink properties
+const char *PROP_RENDER_WAKEUPS = "hdi.render.wakeups_per_sec";
+const char *PROP_RENDER_CPU_LOAD = "hdi.render.cpu_load";
+const char *PROP_RENDER_BLOCK = "hdi.render.block_msec";
+const char *PROP_RENDER_QUEUE_DEPTH = "hdi.render.queue_depth";
+const char *PROP_RENDER_QUEUE_FILL = "hdi.render.queue_fill";
+const char *PROP_RENDER_QUEUE_PEAK = "hdi.render.queue_peak";
+const char *PROP_RENDER_RATE_RATIO = "hdi.render.rate_ratio";
+const char *PROP_RENDER_WRITE_RETRIES = "hdi.render.write_retries_per_sec";
+const char *PROP_RENDER_WRITE_SLEEPS = "hdi.render.write_sleeps_per_sec";
+const char *PROP_RENDER_SINK_DROPPED = "hdi.render.sink_bytes_dropped";
+// Capture block pool statistics published by the HDI source as source properties
+const char *PROP_CAPTURE_POOL_SIZE = "hdi.capture.pool_size";
+const char *PROP_CAPTURE_POOL_HITS = "hdi.capture.pool_hits";
+const char *PROP_CAPTURE_POOL_ALLOCS = "hdi.capture.pool_allocs";
+
+// Stream statistics published by the audio client as stream properties
+const char *PROP_STATS_UNDERRUNS = "stream.stats.underruns";
+const char *PROP_STATS_OVERRUNS = "stream.stats.overruns";
+const char *PROP_STATS_BYTES_DROPPED = "stream.stats.bytes_dropped";
+const char *PROP_STATS_BLOCKING_USEC = "stream.stats.blocking_usec";
+const char *PROP_STATS_JITTER = "stream.stats.jitter";
+
+void ReadStreamStatistics(const pa_proplist *propList, InputOutputInfo &info)
+{
+    const char *underruns = pa_proplist_gets(propList, PROP_STATS_UNDERRUNS);
+    const char *overruns = pa_proplist_gets(propList, PROP_STATS_OVERRUNS);
+    const char *bytesDropped = pa_proplist_gets(propList, PROP_STATS_BYTES_DROPPED);
+    const char *blocking = pa_proplist_gets(propList, PROP_STATS_BLOCKING_USEC);
+    const char *jitter = pa_proplist_gets(propList, PROP_STATS_JITTER);
+    if (underruns != nullptr && overruns != nullptr && bytesDropped != nullptr && blocking != nullptr &&
+        jitter != nullptr) {
+        info.statsUnderruns = underruns;
+        info.statsOverruns = overruns;
+        info.statsBytesDropped = bytesDropped;
+        info.statsBlockingUsec = blocking;
+        info.statsJitter = jitter;
+    }
+}
+
+void StreamStatisticsDump(std::string &dumpString, const InputOutputInfo &info)
+{
+    if (info.statsUnderruns.empty()) {
+        return;
+    }
+    AppendFormat(dumpString, "Underruns: %s Overruns: %s Bytes Dropped: %s\n", info.statsUnderruns.c_str(),
+        info.statsOverruns.c_str(), info.statsBytesDropped.c_str());
+    AppendFormat(dumpString, "Blocking Time (avg/max): %s us\n", info.statsBlockingUsec.c_str());
+    AppendFormat(dumpString, "Callback Jitter (<1/<2/<5/<10/<20/>=20 ms): %s\n", info.statsJitter.c_str());
+}
+
+void StreamStatisticsTotalDump(std::string &dumpString, const std::vector<InputOutputInfo> &streams)
+{
+    uint64_t underruns = 0;
+    uint64_t overruns = 0;
+    uint64_t bytesDropped = 0;
+    for (auto &info : streams) {
+        underruns += strtoull(info.statsUnderruns.c_str(), nullptr, 0);
+        overruns += strtoull(info.statsOverruns.c_str(), nullptr, 0);
+        bytesDropped += strtoull(info.statsBytesDropped.c_str(), nullptr, 0);
+    }
+    AppendFormat(dumpString, "Total Underruns: %llu Overruns: %llu Bytes Dropped: %llu\n\n",
+        static_cast<unsigned long long>(underruns), static_cast<unsigned long long>(overruns),
+        static_cast<unsigned long long>(bytesDropped));
+}
+}
+
 AudioServiceDump::AudioServiceDump() : mainLoop(nullptr),
                                        api(nullptr),
                                        context(nullptr),
@@ -120,13 +188,6 @@ int32_t AudioServiceDump::Initialize()
     return AUDIO_DUMP_SUCCESS;
 }
 
-void AudioServiceDump::OnTimeOut()
-{
-    pa_threaded_mainloop_lock(mainLoop);
-    pa_threaded_mainloop_signal(mainLoop, 0);
-    pa_threaded_mainloop_unlock(mainLoop);
-}
-
 bool AudioServiceDump::IsEndWith(const std::string &mainStr, const std::string &toMatch)
 {
     if (mainStr.size() >= toMatch.size() &&
@@ -295,6 +356,7 @@ void AudioServiceDump::PlaybackStreamDump(std::string &dumpString)
     dumpString += "Playback Streams\n";
 
     AppendFormat(dumpString, "%d  Playback stream (s) available:\n\n", audioData_.streamData.sinkInputs.size());
+    StreamStatisticsTotalDump(dumpString, audioData_.streamData.sinkInputs);
 
     for (auto it = audioData_.streamData.sinkInputs.begin(); it != audioData_.streamData.sinkInputs.end(); it++) {
         InputOutputInfo sinkInputInfo = *it;
@@ -309,6 +371,7 @@ void AudioServiceDump::PlaybackStreamDump(std::string &dumpString)
         dumpString += "Status:";
         dumpString += (sinkInputInfo.corked) ? "STOPPED/PAUSED" : "RUNNING";
         AppendFormat(dumpString, "\nStream Start Time: %s\n", (sinkInputInfo.sessionStartTime).c_str());
+        StreamStatisticsDump(dumpString, sinkInputInfo);
         dumpString += "\n";
     }
 }
@@ -318,6 +381,7 @@ void AudioServiceDump::RecordStreamDump(std::string &dumpString)
     char s[PA_SAMPLE_SPEC_SNPRINT_MAX];
     dumpString += "Record Streams \n";
     AppendFormat(dumpString, "%d  Record stream (s) available:\n\n", audioData_.streamData.sourceOutputs.size());
+    StreamStatisticsTotalDump(dumpString, audioData_.streamData.sourceOutputs);
 
     for (auto it = audioData_.streamData.sourceOutputs.begin(); it != audioData_.streamData.sourceOutputs.end(); it++) {
         InputOutputInfo sourceOutputInfo = *it;
@@ -331,6 +395,7 @@ void AudioServiceDump::RecordStreamDump(std::string &dumpString)
         dumpString += "Status:";
         dumpString += (sourceOutputInfo.corked) ? "STOPPED/PAUSED" : "RUNNING";
         AppendFormat(dumpString, "\nStream Start Time: %s\n", (sourceOutputInfo.sessionStartTime).c_str());
+        StreamStatisticsDump(dumpString, sourceOutputInfo);
         dumpString += "\n";
     }
 }
@@ -347,7 +412,13 @@ void AudioServiceDump::HDFModulesDump(std::string &dumpString)
 
         AppendFormat(dumpString, "Module Name: %s\n", (sourceInfo.name).c_str());
         char *hdfOutSampleSpec = pa_sample_spec_snprint(s, sizeof(s), &(sourceInfo.sampleSpec));
-        AppendFormat(dumpString, "Module Configuration: %s\n\n", hdfOutSampleSpec);
+        AppendFormat(dumpString, "Module Configuration: %s\n", hdfOutSampleSpec);
+        if (!sourceInfo.capturePoolSize.empty()) {
+            AppendFormat(dumpString, "Capture Block Pool: size %s, recycled %s, allocated %s\n",
+                sourceInfo.capturePoolSize.c_str(), sourceInfo.capturePoolHits.c_str(),
+                sourceInfo.capturePoolAllocs.c_str());
+        }
+        dumpString += "\n";
     }
 
     dumpString += "HDF Output Modules\n";
@@ -357,7 +428,28 @@ void AudioServiceDump::HDFModulesDump(std::string &dumpString)
         SinkSourceInfo sinkInfo = *it;
         AppendFormat(dumpString, "Module Name: %s\n", (sinkInfo.name).c_str());
         char *hdfInSampleSpec = pa_sample_spec_snprint(s, sizeof(s), &(sinkInfo.sampleSpec));
-        AppendFormat(dumpString, "Module Configuration: %s\n\n", hdfInSampleSpec);
+        AppendFormat(dumpString, "Module Configuration: %s\n", hdfInSampleSpec);
+        if (!sinkInfo.renderWakeups.empty()) {
+            AppendFormat(dumpString, "Render Block: %s ms\n", sinkInfo.renderBlockMsec.c_str());
+            AppendFormat(dumpString, "Render Wakeups: %s /s\n", sinkInfo.renderWakeups.c_str());
+            AppendFormat(dumpString, "Render CPU Load: %s\n", sinkInfo.renderCpuLoad.c_str());
+            if (!sinkInfo.renderQueueDepth.empty()) {
+                AppendFormat(dumpString, "Render Queue: depth %s, average fill %s, peak %s\n",
+                    sinkInfo.renderQueueDepth.c_str(), sinkInfo.renderQueueFill.c_str(),
+                    sinkInfo.renderQueuePeak.c_str());
+            }
+            if (!sinkInfo.renderRateRatio.empty()) {
+                AppendFormat(dumpString, "Device Clock Rate Ratio: %s\n", sinkInfo.renderRateRatio.c_str());
+            }
+            if (!sinkInfo.renderWriteRetries.empty()) {
+                AppendFormat(dumpString, "Render Write Pacing: %s retries/s, %s sleeps/s\n",
+                    sinkInfo.renderWriteRetries.c_str(), sinkInfo.renderWriteSleeps.c_str());
+            }
+            if (!sinkInfo.renderSinkDropped.empty()) {
+                AppendFormat(dumpString, "Sink Bytes Dropped: %s\n", sinkInfo.renderSinkDropped.c_str());
+            }
+        }
+        dumpString += "\n";
     }
 }
 
@@ -558,6 +650,36 @@ void AudioServiceDump::PASinkInfoCallback(pa_context *c, const pa_sink_info *i,
         if (IsValidModule(sinkName)) {
             (sinkInfo.name).assign(sinkName);
             sinkInfo.sampleSpec = i->sample_spec;
+            const char *wakeups = pa_proplist_gets(i->proplist, PROP_RENDER_WAKEUPS);
+            const char *cpuLoad = pa_proplist_gets(i->proplist, PROP_RENDER_CPU_LOAD);
+            const char *block = pa_proplist_gets(i->proplist, PROP_RENDER_BLOCK);
+            if (wakeups != nullptr && cpuLoad != nullptr && block != nullptr) {
+                sinkInfo.renderWakeups = wakeups;
+                sinkInfo.renderCpuLoad = cpuLoad;
+                sinkInfo.renderBlockMsec = block;
+            }
+            const char *queueDepth = pa_proplist_gets(i->proplist, PROP_RENDER_QUEUE_DEPTH);
+            const char *queueFill = pa_proplist_gets(i->proplist, PROP_RENDER_QUEUE_FILL);
+            const char *queuePeak = pa_proplist_gets(i->proplist, PROP_RENDER_QUEUE_PEAK);
+            if (queueDepth != nullptr && queueFill != nullptr && queuePeak != nullptr) {
+                sinkInfo.renderQueueDepth = queueDepth;
+                sinkInfo.renderQueueFill = queueFill;
+                sinkInfo.renderQueuePeak = queuePeak;
+            }
+            const char *rateRatio = pa_proplist_gets(i->proplist, PROP_RENDER_RATE_RATIO);
+            if (rateRatio != nullptr) {
+                sinkInfo.renderRateRatio = rateRatio;
+            }
+            const char *writeRetries = pa_proplist_gets(i->proplist, PROP_RENDER_WRITE_RETRIES);
+            const char *writeSleeps = pa_proplist_gets(i->proplist, PROP_RENDER_WRITE_SLEEPS);
+            if (writeRetries != nullptr && writeSleeps != nullptr) {
+                sinkInfo.renderWriteRetries = writeRetries;
+                sinkInfo.renderWriteSleeps = writeSleeps;
+            }
+            const char *sinkDropped = pa_proplist_gets(i->proplist, PROP_RENDER_SINK_DROPPED);
+            if (sinkDropped != nullptr) {
+                sinkInfo.renderSinkDropped = sinkDropped;
+            }
             asDump->audioData_.streamData.sinkDevices.push_back(sinkInfo);
         }
     }
@@ -621,6 +743,7 @@ void AudioServiceDump::PASinkInputInfoCallback(pa_context *c, const pa_sink_inpu
             string sessionStartTime(sessionstarttime);
             (sinkInputInfo.sessionStartTime).assign(sessionStartTime);
         }
+        ReadStreamStatistics(i->proplist, sinkInputInfo);
     }
     asDump->audioData_.streamData.sinkInputs.push_back(sinkInputInfo);
 }
@@ -652,6 +775,14 @@ void AudioServiceDump::PASourceInfoCallback(pa_context *c, const pa_source_info
         if (IsValidModule(sourceName)) {
             (sourceInfo.name).assign(sourceName);
             sourceInfo.sampleSpec = i->sample_spec;
+            const char *poolSize = pa_proplist_gets(i->proplist, PROP_CAPTURE_POOL_SIZE);
+            const char *poolHits = pa_proplist_gets(i->proplist, PROP_CAPTURE_POOL_HITS);
+            const char *poolAllocs = pa_proplist_gets(i->proplist, PROP_CAPTURE_POOL_ALLOCS);
+            if (poolSize != nullptr && poolHits != nullptr && poolAllocs != nullptr) {
+                sourceInfo.capturePoolSize = poolSize;
+                sourceInfo.capturePoolHits = poolHits;
+                sourceInfo.capturePoolAllocs = poolAllocs;
+            }
             asDump->audioData_.streamData.sourceDevices.push_back(sourceInfo);
         }
     }
@@ -715,6 +846,7 @@ void AudioServiceDump::PASourceOutputInfoCallback(pa_context *c, const pa_source
             string sessionStartTime(sessionstarttime);
             (sourceOutputInfo.sessionStartTime).assign(sessionStartTime);
         }
+        ReadStreamStatistics(i->proplist, sourceOutputInfo);
     }
     asDump->audioData_.streamData.sourceOutputs.push_back(sourceOutputInfo);
 }
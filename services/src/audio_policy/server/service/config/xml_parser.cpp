@@ -180,6 +180,46 @@ void XMLParser::ParsePort(xmlNode &node, AudioModuleInfo &moduleInfo)
                 moduleInfo.bufferSize = value;
             }
 
+            value = ExtractPropertyValue("deep_buffer_size", *portNode);
+            if (!value.empty()) {
+                moduleInfo.deepBufferSize = value;
+            }
+
+            value = ExtractPropertyValue("render_queue_depth", *portNode);
+            if (!value.empty()) {
+                moduleInfo.renderQueueDepth = value;
+            }
+
+            value = ExtractPropertyValue("render_batch_msec", *portNode);
+            if (!value.empty()) {
+                moduleInfo.renderBatchMsec = value;
+            }
+
+            value = ExtractPropertyValue("encoder_frame_samples", *portNode);
+            if (!value.empty()) {
+                moduleInfo.encoderFrameSamples = value;
+            }
+
+            value = ExtractPropertyValue("hardware_clock", *portNode);
+            if (!value.empty()) {
+                moduleInfo.hardwareClock = value;
+            }
+
+            value = ExtractPropertyValue("rt_priority", *portNode);
+            if (!value.empty()) {
+                moduleInfo.rtPriority = value;
+            }
+
+            value = ExtractPropertyValue("cpu_affinity", *portNode);
+            if (!value.empty()) {
+                moduleInfo.cpuAffinity = value;
+            }
+
+            value = ExtractPropertyValue("mlock", *portNode);
+            if (!value.empty()) {
+                moduleInfo.memLock = value;
+            }
+
             value = ExtractPropertyValue("fixed_latency", *portNode);
             if (!value.empty()) {
                 moduleInfo.fixedLatency = value;
@@ -200,6 +240,16 @@ void XMLParser::ParsePort(xmlNode &node, AudioModuleInfo &moduleInfo)
                 moduleInfo.fileName = value;
             }
 
+            value = ExtractPropertyValue("file_realtime", *portNode);
+            if (!value.empty()) {
+                moduleInfo.fileRealtime = value;
+            }
+
+            value = ExtractPropertyValue("file_jitter_usec", *portNode);
+            if (!value.empty()) {
+                moduleInfo.fileJitterUsec = value;
+            }
+
             portInfoList.push_back(moduleInfo);
         }
         portNode = portNode->next;
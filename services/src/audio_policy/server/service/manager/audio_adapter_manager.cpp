@@ -282,6 +282,21 @@ void UpdateCommonArgs(const AudioModuleInfo &audioModuleInfo, std::string &args)
         args.append(" open_mic_speaker=");
         args.append(audioModuleInfo.OpenMicSpeaker);
     }
+
+    if (!audioModuleInfo.rtPriority.empty()) {
+        args.append(" rt_priority=");
+        args.append(audioModuleInfo.rtPriority);
+    }
+
+    if (!audioModuleInfo.cpuAffinity.empty()) {
+        args.append(" cpu_affinity=");
+        args.append(audioModuleInfo.cpuAffinity);
+    }
+
+    if (!audioModuleInfo.memLock.empty()) {
+        args.append(" mlock=");
+        args.append(audioModuleInfo.memLock);
+    }
 }
 
 // Private Members
@@ -314,6 +329,26 @@ std::string AudioAdapterManager::GetModuleArgs(const AudioModuleInfo &audioModul
             args.append(" sink_latency=");
             args.append(audioModuleInfo.sinkLatency);
         }
+        if (!audioModuleInfo.deepBufferSize.empty()) {
+            args.append(" deep_buffer_size=");
+            args.append(audioModuleInfo.deepBufferSize);
+        }
+        if (!audioModuleInfo.renderQueueDepth.empty()) {
+            args.append(" render_queue_depth=");
+            args.append(audioModuleInfo.renderQueueDepth);
+        }
+        if (!audioModuleInfo.renderBatchMsec.empty()) {
+            args.append(" render_batch_msec=");
+            args.append(audioModuleInfo.renderBatchMsec);
+        }
+        if (!audioModuleInfo.encoderFrameSamples.empty()) {
+            args.append(" encoder_frame_samples=");
+            args.append(audioModuleInfo.encoderFrameSamples);
+        }
+        if (!audioModuleInfo.hardwareClock.empty()) {
+            args.append(" hardware_clock=");
+            args.append(audioModuleInfo.hardwareClock);
+        }
         if (testModeOn_) {
             args.append(" test_mode_on=");
             args.append("1");
@@ -339,6 +374,14 @@ std::string AudioAdapterManager::GetModuleArgs(const AudioModuleInfo &audioModul
             args.append(" file_path=");
             args.append(audioModuleInfo.fileName);
         }
+        if (!audioModuleInfo.fileRealtime.empty()) {
+            args.append(" file_realtime=");
+            args.append(audioModuleInfo.fileRealtime);
+        }
+        if (!audioModuleInfo.fileJitterUsec.empty()) {
+            args.append(" file_jitter_usec=");
+            args.append(audioModuleInfo.fileJitterUsec);
+        }
     } else if (audioModuleInfo.lib == PIPE_SINK) {
         if (!audioModuleInfo.fileName.empty()) {
             args = "file=";
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_callback_executor.h"
+
+#include <pthread.h>
+
+#include "audio_log.h"
+
+namespace OHOS {
+namespace AudioStandard {
+AudioCallbackExecutor &AudioCallbackExecutor::GetInstance()
+{
+    static AudioCallbackExecutor executor;
+    return executor;
+}
+
+AudioCallbackExecutor::AudioCallbackExecutor()
+{
+    dispatchThread_ = std::thread(&AudioCallbackExecutor::DispatchLoop, this);
+    pthread_setname_np(dispatchThread_.native_handle(), "OS_AudioCbExec");
+}
+
+AudioCallbackExecutor::~AudioCallbackExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        isRunning_ = false;
+    }
+    dispatchCond_.notify_one();
+    if (dispatchThread_.joinable()) {
+        dispatchThread_.join();
+    }
+}
+
+void AudioCallbackExecutor::PostReliable(Task task)
+{
+    // Queue behind earlier spilled tasks so notifications keep their order
+    if (!isOverflowing_ && taskQ_.Push(task)) {
+        WakeDispatcher();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        overflowQ_.push_back(std::move(task));
+        isOverflowing_ = true;
+    }
+    dispatchCond_.notify_one();
+}
+
+void AudioCallbackExecutor::WakeDispatcher()
+{
+    // Pairs with the fence in DispatchLoop: either the dispatcher sees the task before it sleeps, or this sees it
+    // asleep and the mutex makes sure it is waiting before the notification
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!isSleeping_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+    }
+    dispatchCond_.notify_one();
+}
+
+bool AudioCallbackExecutor::PopOverflow(Task &task)
+{
+    std::lock_guard<std::mutex> lock(dispatchMutex_);
+    if (overflowQ_.empty()) {
+        isOverflowing_ = false;
+        return false;
+    }
+    task = std::move(overflowQ_.front());
+    overflowQ_.pop_front();
+    return true;
+}
+
+void AudioCallbackExecutor::DispatchLoop()
+{
+    AUDIO_INFO_LOG("AudioCallbackExecutor: dispatch thread start");
+    Task task;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(dispatchMutex_);
+            isSleeping_ = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            dispatchCond_.wait(lock, [this] { return !isRunning_ || !taskQ_.IsEmpty() || !overflowQ_.empty(); });
+            isSleeping_ = false;
+            if (!isRunning_) {
+                break;
+            }
+        }
+
+        while (taskQ_.Pop(task)) {
+            if (task) {
+                task();
+            }
+            task = nullptr;
+        }
+
+        while (PopOverflow(task)) {
+            task();
+            task = nullptr;
+        }
+    }
+    AUDIO_INFO_LOG("AudioCallbackExecutor: dispatch thread end");
+}
+} // namespace AudioStandard
+} // namespace OHOS
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_format_converter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define AUDIO_CONVERTER_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define AUDIO_CONVERTER_AVX2
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_CONVERTER_NEON
+#endif
+
+#include "audio_errors.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace AudioStandard {
+namespace {
+constexpr float U8_SCALE = 128.0f;
+constexpr float S16_SCALE = 32768.0f;
+constexpr float S24_SCALE = 8388608.0f;
+constexpr float S32_SCALE = 2147483648.0f;
+constexpr float U8_MAX_FLOAT = 255.0f;
+constexpr float S16_MAX_FLOAT = 32767.0f;
+constexpr float S24_MAX_FLOAT = 8388607.0f;
+// Largest float below 2^31, anything above it overflows the conversion to int32
+constexpr float S32_MAX_FLOAT = 2147483520.0f;
+
+constexpr size_t U8_SAMPLE_SIZE = 1;
+constexpr size_t S16_SAMPLE_SIZE = 2;
+constexpr size_t S24_SAMPLE_SIZE = 3;
+constexpr size_t S32_SAMPLE_SIZE = 4;
+constexpr size_t F32_SAMPLE_SIZE = 4;
+constexpr uint32_t BYTE_MASK = 0xFF;
+constexpr uint32_t BYTE_SHIFT_1 = 8;
+constexpr uint32_t BYTE_SHIFT_2 = 16;
+constexpr uint32_t BYTE_SHIFT_3 = 24;
+
+constexpr uint32_t DITHER_LCG_MUL = 1664525u;
+constexpr uint32_t DITHER_LCG_ADD = 1013904223u;
+constexpr uint32_t DITHER_RAND_SHIFT = 8;
+constexpr float DITHER_RAND_NORM = 1.0f / 16777216.0f;
+
+using S16ToFloatFunc = void (*)(const int16_t *src, float *dst, size_t count);
+using FloatToS16Func = void (*)(const float *src, int16_t *dst, size_t count);
+using S32ToFloatFunc = void (*)(const int32_t *src, float *dst, size_t count);
+using FloatToS32Func = void (*)(const float *src, int32_t *dst, size_t count);
+
+struct ConvertKernels {
+    S16ToFloatFunc s16ToFloat;
+    FloatToS16Func floatToS16;
+    S32ToFloatFunc s32ToFloat;
+    FloatToS32Func floatToS32;
+};
+
+inline int32_t RoundAndClamp(float value, float minValue, float maxValue)
+{
+    return static_cast<int32_t>(std::lrint(std::min(std::max(value, minValue), maxValue)));
+}
+
+void S16ToFloatScalar(const int16_t *src, float *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = src[i] * (1.0f / S16_SCALE);
+    }
+}
+
+void FloatToS16Scalar(const float *src, int16_t *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = static_cast<int16_t>(RoundAndClamp(src[i] * S16_SCALE, -S16_SCALE, S16_MAX_FLOAT));
+    }
+}
+
+void S32ToFloatScalar(const int32_t *src, float *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = src[i] * (1.0f / S32_SCALE);
+    }
+}
+
+void FloatToS32Scalar(const float *src, int32_t *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = RoundAndClamp(src[i] * S32_SCALE, -S32_SCALE, S32_MAX_FLOAT);
+    }
+}
+
+#ifdef AUDIO_CONVERTER_SSE2
+constexpr size_t SSE_FLOATS = 4;
+constexpr size_t SSE_S16_BLOCK = 8;
+constexpr int32_t S16_SIGN_SHIFT = 16;
+
+void S16ToFloatSse2(const int16_t *src, float *dst, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+    size_t i = 0;
+    for (; i + SSE_S16_BLOCK <= count; i += SSE_S16_BLOCK) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        // Interleave each sample with itself and shift down to sign extend into 32 bits
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), S16_SIGN_SHIFT);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), S16_SIGN_SHIFT);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + SSE_FLOATS, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    S16ToFloatScalar(src + i, dst + i, count - i);
+}
+
+void FloatToS16Sse2(const float *src, int16_t *dst, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    const __m128 minValue = _mm_set1_ps(-S16_SCALE);
+    const __m128 maxValue = _mm_set1_ps(S16_MAX_FLOAT);
+    size_t i = 0;
+    for (; i + SSE_S16_BLOCK <= count; i += SSE_S16_BLOCK) {
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(src + i + SSE_FLOATS), scale);
+        lo = _mm_min_ps(_mm_max_ps(lo, minValue), maxValue);
+        hi = _mm_min_ps(_mm_max_ps(hi, minValue), maxValue);
+        __m128i out = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), out);
+    }
+    FloatToS16Scalar(src + i, dst + i, count - i);
+}
+
+void S32ToFloatSse2(const int32_t *src, float *dst, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / S32_SCALE);
+    size_t i = 0;
+    for (; i + SSE_FLOATS <= count; i += SSE_FLOATS) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(in), scale));
+    }
+    S32ToFloatScalar(src + i, dst + i, count - i);
+}
+
+void FloatToS32Sse2(const float *src, int32_t *dst, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(S32_SCALE);
+    const __m128 minValue = _mm_set1_ps(-S32_SCALE);
+    const __m128 maxValue = _mm_set1_ps(S32_MAX_FLOAT);
+    size_t i = 0;
+    for (; i + SSE_FLOATS <= count; i += SSE_FLOATS) {
+        __m128 in = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+        in = _mm_min_ps(_mm_max_ps(in, minValue), maxValue);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_cvtps_epi32(in));
+    }
+    FloatToS32Scalar(src + i, dst + i, count - i);
+}
+#endif
+
+#ifdef AUDIO_CONVERTER_AVX2
+constexpr size_t AVX_FLOATS = 8;
+constexpr size_t AVX_S16_BLOCK = 16;
+// Restores sample order after _mm256_packs_epi32, which packs within each 128-bit lane
+constexpr int32_t AVX_PACK_ORDER = 0xD8;
+
+__attribute__((target("avx2"))) void S16ToFloatAvx2(const int16_t *src, float *dst, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+    size_t i = 0;
+    for (; i + AVX_S16_BLOCK <= count; i += AVX_S16_BLOCK) {
+        __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + AVX_FLOATS)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + i + AVX_FLOATS, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    S16ToFloatSse2(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2"))) void FloatToS16Avx2(const float *src, int16_t *dst, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+    const __m256 minValue = _mm256_set1_ps(-S16_SCALE);
+    const __m256 maxValue = _mm256_set1_ps(S16_MAX_FLOAT);
+    size_t i = 0;
+    for (; i + AVX_S16_BLOCK <= count; i += AVX_S16_BLOCK) {
+        __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+        __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(src + i + AVX_FLOATS), scale);
+        lo = _mm256_min_ps(_mm256_max_ps(lo, minValue), maxValue);
+        hi = _mm256_min_ps(_mm256_max_ps(hi, minValue), maxValue);
+        __m256i out = _mm256_packs_epi32(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi));
+        out = _mm256_permute4x64_epi64(out, AVX_PACK_ORDER);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), out);
+    }
+    FloatToS16Sse2(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2"))) void S32ToFloatAvx2(const int32_t *src, float *dst, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / S32_SCALE);
+    size_t i = 0;
+    for (; i + AVX_FLOATS <= count; i += AVX_FLOATS) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(in), scale));
+    }
+    S32ToFloatSse2(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2"))) void FloatToS32Avx2(const float *src, int32_t *dst, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(S32_SCALE);
+    const __m256 minValue = _mm256_set1_ps(-S32_SCALE);
+    const __m256 maxValue = _mm256_set1_ps(S32_MAX_FLOAT);
+    size_t i = 0;
+    for (; i + AVX_FLOATS <= count; i += AVX_FLOATS) {
+        __m256 in = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+        in = _mm256_min_ps(_mm256_max_ps(in, minValue), maxValue);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_cvtps_epi32(in));
+    }
+    FloatToS32Sse2(src + i, dst + i, count - i);
+}
+#endif
+
+#ifdef AUDIO_CONVERTER_NEON
+constexpr size_t NEON_FLOATS = 4;
+constexpr size_t NEON_S16_BLOCK = 8;
+
+#if defined(__aarch64__)
+inline int32x4_t RoundToS32Neon(float32x4_t value)
+{
+    // Rounds to nearest even and saturates to int32
+    return vcvtnq_s32_f32(value);
+}
+#else
+// Floats of at least 2^23 have no fraction bits
+constexpr float NEON_INTEGRAL_FLOAT = 8388608.0f;
+constexpr uint32_t NEON_SIGN_MASK = 0x80000000u;
+
+inline int32x4_t RoundToS32Neon(float32x4_t value)
+{
+    // ARMv7 NEON only truncates. Adding and removing 2^23 with the sign of the value makes the float adder
+    // round to nearest even, the same as lrint in the scalar loops. vcvtq then saturates like vcvtnq.
+    uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(value), vdupq_n_u32(NEON_SIGN_MASK));
+    float32x4_t magic = vreinterpretq_f32_u32(vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(NEON_INTEGRAL_FLOAT))));
+    float32x4_t rounded = vsubq_f32(vaddq_f32(value, magic), magic);
+    uint32x4_t hasFraction = vcltq_f32(vabsq_f32(value), vdupq_n_f32(NEON_INTEGRAL_FLOAT));
+    return vcvtq_s32_f32(vbslq_f32(hasFraction, rounded, value));
+}
+#endif
+
+void S16ToFloatNeon(const int16_t *src, float *dst, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0f / S16_SCALE);
+    size_t i = 0;
+    for (; i + NEON_S16_BLOCK <= count; i += NEON_S16_BLOCK) {
+        int16x8_t in = vld1q_s16(src + i);
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scale));
+        vst1q_f32(dst + i + NEON_FLOATS, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scale));
+    }
+    S16ToFloatScalar(src + i, dst + i, count - i);
+}
+
+void FloatToS16Neon(const float *src, int16_t *dst, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(S16_SCALE);
+    size_t i = 0;
+    for (; i + NEON_S16_BLOCK <= count; i += NEON_S16_BLOCK) {
+        // vqmovn saturates to int16, which matches clamping before the rounding in the scalar loop
+        int32x4_t lo = RoundToS32Neon(vmulq_f32(vld1q_f32(src + i), scale));
+        int32x4_t hi = RoundToS32Neon(vmulq_f32(vld1q_f32(src + i + NEON_FLOATS), scale));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    FloatToS16Scalar(src + i, dst + i, count - i);
+}
+
+void S32ToFloatNeon(const int32_t *src, float *dst, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0f / S32_SCALE);
+    size_t i = 0;
+    for (; i + NEON_FLOATS <= count; i += NEON_FLOATS) {
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+    }
+    S32ToFloatScalar(src + i, dst + i, count - i);
+}
+
+void FloatToS32Neon(const float *src, int32_t *dst, size_t count)
+{
+    const float32x4_t scale = vdupq_n_f32(S32_SCALE);
+    const float32x4_t minValue = vdupq_n_f32(-S32_SCALE);
+    const float32x4_t maxValue = vdupq_n_f32(S32_MAX_FLOAT);
+    size_t i = 0;
+    for (; i + NEON_FLOATS <= count; i += NEON_FLOATS) {
+        // Clamp like the scalar loop, saturation alone would give INT32_MAX rather than S32_MAX_FLOAT for +1.0
+        float32x4_t in = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), scale), minValue), maxValue);
+        vst1q_s32(dst + i, RoundToS32Neon(in));
+    }
+    FloatToS32Scalar(src + i, dst + i, count - i);
+}
+#endif
+
+ConvertKernels SelectKernels()
+{
+#if defined(AUDIO_CONVERTER_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return { S16ToFloatAvx2, FloatToS16Avx2, S32ToFloatAvx2, FloatToS32Avx2 };
+    }
+#endif
+#if defined(AUDIO_CONVERTER_SSE2)
+    return { S16ToFloatSse2, FloatToS16Sse2, S32ToFloatSse2, FloatToS32Sse2 };
+#elif defined(AUDIO_CONVERTER_NEON)
+    return { S16ToFloatNeon, FloatToS16Neon, S32ToFloatNeon, FloatToS32Neon };
+#else
+    return { S16ToFloatScalar, FloatToS16Scalar, S32ToFloatScalar, FloatToS32Scalar };
+#endif
+}
+
+const ConvertKernels &GetKernels()
+{
+    static const ConvertKernels kernels = SelectKernels();
+    return kernels;
+}
+} // namespace
+
+bool AudioFormatConverter::IsSupported(AudioSampleFormat format)
+{
+    return GetSampleSize(format) != 0;
+}
+
+size_t AudioFormatConverter::GetSampleSize(AudioSampleFormat format)
+{
+    switch (format) {
+        case SAMPLE_U8:
+            return U8_SAMPLE_SIZE;
+        case SAMPLE_S16LE:
+            return S16_SAMPLE_SIZE;
+        case SAMPLE_S24LE:
+            return S24_SAMPLE_SIZE;
+        case SAMPLE_S32LE:
+            return S32_SAMPLE_SIZE;
+        case SAMPLE_F32LE:
+            return F32_SAMPLE_SIZE;
+        default:
+            return 0;
+    }
+}
+
+void AudioFormatConverter::SetDitherEnabled(bool enabled)
+{
+    isDitherEnabled_ = enabled;
+}
+
+bool AudioFormatConverter::IsDitherEnabled() const
+{
+    return isDitherEnabled_;
+}
+
+void AudioFormatConverter::ToFloat(const uint8_t *src, AudioSampleFormat format, float *dst, size_t count)
+{
+    switch (format) {
+        case SAMPLE_U8:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = (static_cast<float>(src[i]) - U8_SCALE) * (1.0f / U8_SCALE);
+            }
+            break;
+        case SAMPLE_S16LE:
+            GetKernels().s16ToFloat(reinterpret_cast<const int16_t *>(src), dst, count);
+            break;
+        case SAMPLE_S24LE:
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t *sample = src + i * S24_SAMPLE_SIZE;
+                // Place the 24 bits at the top of an int32 so that the sign comes for free
+                uint32_t value = (static_cast<uint32_t>(sample[0]) << BYTE_SHIFT_1) |
+                    (static_cast<uint32_t>(sample[1]) << BYTE_SHIFT_2) |
+                    (static_cast<uint32_t>(sample[2]) << BYTE_SHIFT_3);
+                dst[i] = static_cast<int32_t>(value) * (1.0f / S32_SCALE);
+            }
+            break;
+        case SAMPLE_S32LE:
+            GetKernels().s32ToFloat(reinterpret_cast<const int32_t *>(src), dst, count);
+            break;
+        case SAMPLE_F32LE:
+            (void)memcpy_s(dst, count * F32_SAMPLE_SIZE, src, count * F32_SAMPLE_SIZE);
+            break;
+        default:
+            break;
+    }
+}
+
+void AudioFormatConverter::FromFloat(const float *src, AudioSampleFormat format, uint8_t *dst, size_t count)
+{
+    switch (format) {
+        case SAMPLE_U8:
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<uint8_t>(RoundAndClamp(src[i] * U8_SCALE + U8_SCALE, 0.0f, U8_MAX_FLOAT));
+            }
+            break;
+        case SAMPLE_S16LE:
+            GetKernels().floatToS16(src, reinterpret_cast<int16_t *>(dst), count);
+            break;
+        case SAMPLE_S24LE:
+            for (size_t i = 0; i < count; i++) {
+                uint32_t value = static_cast<uint32_t>(RoundAndClamp(src[i] * S24_SCALE, -S24_SCALE, S24_MAX_FLOAT));
+                uint8_t *sample = dst + i * S24_SAMPLE_SIZE;
+                sample[0] = static_cast<uint8_t>(value & BYTE_MASK);
+                sample[1] = static_cast<uint8_t>((value >> BYTE_SHIFT_1) & BYTE_MASK);
+                sample[2] = static_cast<uint8_t>((value >> BYTE_SHIFT_2) & BYTE_MASK);
+            }
+            break;
+        case SAMPLE_S32LE:
+            GetKernels().floatToS32(src, reinterpret_cast<int32_t *>(dst), count);
+            break;
+        case SAMPLE_F32LE:
+            (void)memcpy_s(dst, count * F32_SAMPLE_SIZE, src, count * F32_SAMPLE_SIZE);
+            break;
+        default:
+            break;
+    }
+}
+
+bool AudioFormatConverter::ConvertDirect(const uint8_t *src, AudioSampleFormat srcFormat, uint8_t *dst,
+    AudioSampleFormat dstFormat, size_t count)
+{
+    const ConvertKernels &kernels = GetKernels();
+    if (srcFormat == SAMPLE_S16LE && dstFormat == SAMPLE_F32LE) {
+        kernels.s16ToFloat(reinterpret_cast<const int16_t *>(src), reinterpret_cast<float *>(dst), count);
+    } else if (srcFormat == SAMPLE_F32LE && dstFormat == SAMPLE_S16LE) {
+        kernels.floatToS16(reinterpret_cast<const float *>(src), reinterpret_cast<int16_t *>(dst), count);
+    } else if (srcFormat == SAMPLE_S32LE && dstFormat == SAMPLE_F32LE) {
+        kernels.s32ToFloat(reinterpret_cast<const int32_t *>(src), reinterpret_cast<float *>(dst), count);
+    } else if (srcFormat == SAMPLE_F32LE && dstFormat == SAMPLE_S32LE) {
+        kernels.floatToS32(reinterpret_cast<const float *>(src), reinterpret_cast<int32_t *>(dst), count);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool AudioFormatConverter::NeedsDither(AudioSampleFormat srcFormat, AudioSampleFormat dstFormat) const
+{
+    if (!isDitherEnabled_ || (dstFormat != SAMPLE_U8 && dstFormat != SAMPLE_S16LE)) {
+        return false;
+    }
+    return (srcFormat == SAMPLE_F32LE) || (GetSampleSize(srcFormat) > GetSampleSize(dstFormat));
+}
+
+void AudioFormatConverter::AddDither(float *samples, size_t count, float lsb)
+{
+    // Triangular PDF noise of +-1 LSB, the difference of two uniform values, decorrelates the rounding error
+    uint32_t seed = ditherSeed_;
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * DITHER_LCG_MUL + DITHER_LCG_ADD;
+        float first = (seed >> DITHER_RAND_SHIFT) * DITHER_RAND_NORM;
+        seed = seed * DITHER_LCG_MUL + DITHER_LCG_ADD;
+        float second = (seed >> DITHER_RAND_SHIFT) * DITHER_RAND_NORM;
+        samples[i] += (first - second) * lsb;
+    }
+    ditherSeed_ = seed;
+}
+
+int32_t AudioFormatConverter::Convert(const uint8_t *src, AudioSampleFormat srcFormat, uint8_t *dst,
+    AudioSampleFormat dstFormat, size_t sampleCount)
+{
+    if (src == nullptr || dst == nullptr) {
+        return ERR_INVALID_PARAM;
+    }
+    if (!IsSupported(srcFormat) || !IsSupported(dstFormat)) {
+        return ERR_NOT_SUPPORTED;
+    }
+    if (sampleCount == 0) {
+        return SUCCESS;
+    }
+
+    size_t srcSampleSize = GetSampleSize(srcFormat);
+    size_t dstSampleSize = GetSampleSize(dstFormat);
+    if (srcFormat == dstFormat) {
+        size_t length = sampleCount * srcSampleSize;
+        return memcpy_s(dst, length, src, length) ? ERR_INVALID_PARAM : SUCCESS;
+    }
+
+    bool isDither = NeedsDither(srcFormat, dstFormat);
+    if (!isDither && ConvertDirect(src, srcFormat, dst, dstFormat, sampleCount)) {
+        return SUCCESS;
+    }
+
+    float lsb = 1.0f / ((dstFormat == SAMPLE_U8) ? U8_SCALE : S16_SCALE);
+    for (size_t done = 0; done < sampleCount;) {
+        size_t count = std::min(SCRATCH_SAMPLES, sampleCount - done);
+        ToFloat(src + done * srcSampleSize, srcFormat, scratch_.data(), count);
+        if (isDither) {
+            AddDither(scratch_.data(), count, lsb);
+        }
+        FromFloat(scratch_.data(), dstFormat, dst + done * dstSampleSize, count);
+        done += count;
+    }
+    return SUCCESS;
+}
+} // namespace AudioStandard
+} // namespace OHOS
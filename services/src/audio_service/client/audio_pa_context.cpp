@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_pa_context.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "audio_log.h"
+#include "audio_system_manager.h"
+
+using namespace std;
+
+namespace OHOS {
+namespace AudioStandard {
+namespace {
+const string PATH_SEPARATOR = "/";
+const string COOKIE_FILE_NAME = "cookie";
+}
+
+mutex AudioPaContext::instanceMutex_;
+weak_ptr<AudioPaContext> AudioPaContext::instance_;
+
+shared_ptr<AudioPaContext> AudioPaContext::Acquire(const string &cachePath)
+{
+    lock_guard<mutex> lock(instanceMutex_);
+    shared_ptr<AudioPaContext> paContext = instance_.lock();
+    if (paContext != nullptr && paContext->IsReady()) {
+        return paContext;
+    }
+
+    paContext = shared_ptr<AudioPaContext>(new(std::nothrow) AudioPaContext());
+    if (paContext == nullptr || !paContext->Connect(cachePath)) {
+        AUDIO_ERR_LOG("AudioPaContext: connect to audio server failed");
+        return nullptr;
+    }
+
+    AUDIO_INFO_LOG("AudioPaContext: new connection to audio server ready");
+    instance_ = paContext;
+    return paContext;
+}
+
+AudioPaContext::~AudioPaContext()
+{
+    Release();
+}
+
+void AudioPaContext::PAContextStateCb(pa_context *context, void *userdata)
+{
+    pa_threaded_mainloop *mainLoop = (pa_threaded_mainloop *)userdata;
+    AUDIO_INFO_LOG("Current Context State: %{private}d", pa_context_get_state(context));
+
+    switch (pa_context_get_state(context)) {
+        case PA_CONTEXT_READY:
+        case PA_CONTEXT_TERMINATED:
+        case PA_CONTEXT_FAILED:
+            pa_threaded_mainloop_signal(mainLoop, 0);
+            break;
+
+        case PA_CONTEXT_UNCONNECTED:
+        case PA_CONTEXT_CONNECTING:
+        case PA_CONTEXT_AUTHORIZING:
+        case PA_CONTEXT_SETTING_NAME:
+        default:
+            break;
+    }
+}
+
+bool AudioPaContext::IsReady()
+{
+    if (mainLoop_ == nullptr || context_ == nullptr) {
+        return false;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop_);
+    bool isReady = (pa_context_get_state(context_) == PA_CONTEXT_READY);
+    pa_threaded_mainloop_unlock(mainLoop_);
+    return isReady;
+}
+
+bool AudioPaContext::Connect(const string &cachePath)
+{
+    mainLoop_ = pa_threaded_mainloop_new();
+    if (mainLoop_ == nullptr) {
+        return false;
+    }
+
+    api_ = pa_threaded_mainloop_get_api(mainLoop_);
+    if (api_ == nullptr) {
+        return false;
+    }
+
+    context_ = pa_context_new(api_, "AudioServiceClient");
+    if (context_ == nullptr) {
+        return false;
+    }
+
+    pa_context_set_state_callback(context_, PAContextStateCb, mainLoop_);
+
+    string appCookiePath = "";
+    if (!cachePath.empty()) {
+        AUDIO_DEBUG_LOG("abilityContext not null");
+        int32_t size = 0;
+
+        const char *cookieData = AudioSystemManager::GetInstance()->RetrieveCookie(size);
+        if (size <= 0) {
+            AUDIO_ERR_LOG("Error retrieving cookie");
+            return false;
+        }
+
+        appCookiePath = cachePath + PATH_SEPARATOR + COOKIE_FILE_NAME;
+
+        ofstream cookieCache(appCookiePath.c_str(), std::ofstream::binary);
+        cookieCache.write(cookieData, size);
+        cookieCache.flush();
+        cookieCache.close();
+
+        pa_context_load_cookie_from_file(context_, appCookiePath.c_str());
+    }
+
+    bool isReady = false;
+    if (pa_context_connect(context_, nullptr, PA_CONTEXT_NOFAIL, nullptr) < 0) {
+        AUDIO_ERR_LOG("context connect error: %{public}s", pa_strerror(pa_context_errno(context_)));
+    } else {
+        isContextConnected_ = true;
+        pa_threaded_mainloop_lock(mainLoop_);
+        if (pa_threaded_mainloop_start(mainLoop_) >= 0) {
+            isMainLoopStarted_ = true;
+            while (true) {
+                pa_context_state_t state = pa_context_get_state(context_);
+                if (state == PA_CONTEXT_READY) {
+                    isReady = true;
+                    break;
+                }
+                if (!PA_CONTEXT_IS_GOOD(state)) {
+                    AUDIO_ERR_LOG("context bad state error: %{public}s", pa_strerror(pa_context_errno(context_)));
+                    break;
+                }
+                pa_threaded_mainloop_wait(mainLoop_);
+            }
+        }
+        pa_threaded_mainloop_unlock(mainLoop_);
+    }
+
+    if (!appCookiePath.empty()) {
+        remove(appCookiePath.c_str());
+    }
+    return isReady;
+}
+
+void AudioPaContext::Release()
+{
+    if (mainLoop_ && isMainLoopStarted_) {
+        pa_threaded_mainloop_stop(mainLoop_);
+    }
+
+    if (context_) {
+        pa_context_set_state_callback(context_, nullptr, nullptr);
+        if (isContextConnected_) {
+            pa_context_disconnect(context_);
+        }
+        pa_context_unref(context_);
+    }
+
+    if (mainLoop_) {
+        pa_threaded_mainloop_free(mainLoop_);
+    }
+
+    isMainLoopStarted_ = false;
+    isContextConnected_ = false;
+    mainLoop_ = nullptr;
+    api_ = nullptr;
+    context_ = nullptr;
+}
+} // namespace AudioStandard
+} // namespace OHOS
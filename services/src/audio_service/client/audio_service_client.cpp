@@ -15,6 +15,7 @@
 
 #include "audio_service_client.h"
 
+#include <bitset>
 #include <fstream>
 
 #include "iservice_registry.h"
@@ -38,10 +39,25 @@ const uint32_t T_LENGTH_FACTOR = 4;
 const uint64_t MIN_BUF_DURATION_IN_USEC = 92880;
 const uint32_t LATENCY_THRESHOLD = 35;
 const int32_t NO_OF_PREBUF_TIMES = 6;
+const pa_usec_t STATS_PUBLISH_INTERVAL_IN_USEC = 5 * PA_USEC_PER_SEC;
+const char *STATS_PROP_UNDERRUNS = "stream.stats.underruns";
+const char *STATS_PROP_OVERRUNS = "stream.stats.overruns";
+const char *STATS_PROP_BYTES_DROPPED = "stream.stats.bytes_dropped";
+const char *STATS_PROP_BLOCKING_USEC = "stream.stats.blocking_usec";
+const char *STATS_PROP_JITTER = "stream.stats.jitter";
+
+const uint32_t RING_CACHE_SIZE_FACTOR = 2;
+const uint32_t LOW_LATENCY_IN_MSEC = 5;
+const uint32_t LOW_LATENCY_T_LENGTH_FACTOR = 2;
+const uint32_t DEEP_BUFFER_IN_MSEC = 400;
+const uint32_t DEEP_BUFFER_MIN_REQ_DIVISOR = 2;
+const uint32_t RING_CACHE_WAIT_TIMEOUT_IN_MS = 500;
+// A session ID is the process ID with a stream serial in the low bits. Process IDs, at most 22 bits, are unique among
+// the live processes and serials among the live streams of a process, so the IDs of live streams never collide.
+const uint32_t SESSION_ID_SERIAL_BITS = 9;
+const uint32_t SESSION_ID_SERIAL_COUNT = 1u << SESSION_ID_SERIAL_BITS;
 
 
-const string PATH_SEPARATOR = "/";
-const string COOKIE_FILE_NAME = "cookie";
 
 static int32_t CheckReturnIfinvalid(bool expr, const int32_t retVal)
 {
@@ -71,6 +87,49 @@ static int32_t CheckPaStatusIfinvalid(pa_threaded_mainloop *mainLoop, pa_context
     return retVal;
 }
 
+// Adds the time spent until the end of the scope to the blocking time statistics
+class BlockingTimeRecorder {
+public:
+    explicit BlockingTimeRecorder(AudioStreamStatsCollector &stats) : stats_(stats), startUsec_(pa_rtclock_now()) {}
+    ~BlockingTimeRecorder()
+    {
+        stats_.AddBlockingTime(pa_rtclock_now() - startUsec_);
+    }
+
+private:
+    AudioStreamStatsCollector &stats_;
+    pa_usec_t startUsec_;
+};
+
+static std::mutex g_sessionSerialMutex;
+static std::bitset<SESSION_ID_SERIAL_COUNT> g_sessionSerialsInUse; // guarded by g_sessionSerialMutex
+static uint32_t g_nextSessionSerial = 1; // guarded by g_sessionSerialMutex
+
+// Serials go round robin and skip the ones in use, so a released ID is reused as late as possible. Returns 0 when
+// every serial of the process is taken.
+static uint32_t AcquireSessionID()
+{
+    std::lock_guard<std::mutex> lock(g_sessionSerialMutex);
+    for (uint32_t i = 1; i < SESSION_ID_SERIAL_COUNT; i++) {
+        uint32_t serial = g_nextSessionSerial;
+        g_nextSessionSerial = (g_nextSessionSerial % (SESSION_ID_SERIAL_COUNT - 1)) + 1;
+        if (!g_sessionSerialsInUse.test(serial)) {
+            g_sessionSerialsInUse.set(serial);
+            return (static_cast<uint32_t>(getpid()) << SESSION_ID_SERIAL_BITS) | serial;
+        }
+    }
+    return 0;
+}
+
+static void ReleaseSessionID(uint32_t sessionID)
+{
+    if (sessionID == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_sessionSerialMutex);
+    g_sessionSerialsInUse.reset(sessionID & (SESSION_ID_SERIAL_COUNT - 1));
+}
+
 AudioStreamParams AudioServiceClient::ConvertFromPAAudioParams(pa_sample_spec paSampleSpec)
 {
     AudioStreamParams audioParams;
@@ -151,10 +210,7 @@ void AudioServiceClient::PAStreamStartSuccessCb(pa_stream *stream, int32_t succe
 
     asClient->state_ = RUNNING;
     asClient->WriteStateChangedSysEvents();
-    std::shared_ptr<AudioStreamCallback> streamCb = asClient->streamCallback_.lock();
-    if (streamCb != nullptr) {
-        streamCb->OnStateChange(asClient->state_);
-    }
+    asClient->PostStateChange(asClient->state_);
     asClient->streamCmdStatus = success;
     pa_threaded_mainloop_signal(mainLoop, 0);
 }
@@ -171,10 +227,7 @@ void AudioServiceClient::PAStreamStopSuccessCb(pa_stream *stream, int32_t succes
 
     asClient->state_ = STOPPED;
     asClient->WriteStateChangedSysEvents();
-    std::shared_ptr<AudioStreamCallback> streamCb = asClient->streamCallback_.lock();
-    if (streamCb != nullptr) {
-        streamCb->OnStateChange(asClient->state_);
-    }
+    asClient->PostStateChange(asClient->state_);
     asClient->streamCmdStatus = success;
     pa_threaded_mainloop_signal(mainLoop, 0);
 }
@@ -191,28 +244,11 @@ void AudioServiceClient::PAStreamPauseSuccessCb(pa_stream *stream, int32_t succe
 
     asClient->state_ = PAUSED;
     asClient->WriteStateChangedSysEvents();
-    std::shared_ptr<AudioStreamCallback> streamCb = asClient->streamCallback_.lock();
-    if (streamCb != nullptr) {
-        streamCb->OnStateChange(asClient->state_);
-    }
+    asClient->PostStateChange(asClient->state_);
     asClient->streamCmdStatus = success;
     pa_threaded_mainloop_signal(mainLoop, 0);
 }
 
-void AudioServiceClient::PAStreamUpdatePropSuccessCb(pa_stream *stream, int32_t success, void *userdata)
-{
-    if (!userdata) {
-        AUDIO_ERR_LOG("AudioServiceClient::PAStreamUpdatePropSuccessCb: userdata is null");
-        return;
-    }
-
-    AudioServiceClient *asClient = static_cast<AudioServiceClient *>(userdata);
-    pa_threaded_mainloop *mainLoop = static_cast<pa_threaded_mainloop *>(asClient->mainLoop);
-
-    asClient->updatePropStatus = success;
-    pa_threaded_mainloop_signal(mainLoop, 0);
-}
-
 void AudioServiceClient::PAStreamDrainSuccessCb(pa_stream *stream, int32_t success, void *userdata)
 {
     if (!userdata) {
@@ -331,6 +367,27 @@ int32_t AudioServiceClient::SaveReadCallback(const std::weak_ptr<AudioCapturerRe
     return AUDIO_CLIENT_SUCCESS;
 }
 
+void AudioServiceClient::ReportWriteError(int32_t errorCode)
+{
+    std::shared_ptr<AudioRendererWriteCallback> cb = writeCallback_.lock();
+    if (cb != nullptr) {
+        cb->OnWriteError(errorCode);
+    }
+}
+
+void AudioServiceClient::ReportReadError(int32_t errorCode)
+{
+    std::shared_ptr<AudioCapturerReadCallback> cb = readCallback_.lock();
+    if (cb != nullptr) {
+        cb->OnReadError(errorCode);
+    }
+}
+
+bool AudioServiceClient::IsStreamUsable()
+{
+    return CheckPaStatusIfinvalid(mainLoop, context, paStream, -1) == CHECK_UTIL_SUCCESS;
+}
+
 void AudioServiceClient::PAStreamWriteCb(pa_stream *stream, size_t length, void *userdata)
 {
     AUDIO_DEBUG_LOG("AudioServiceClient::Inside PA write callback");
@@ -342,18 +399,30 @@ void AudioServiceClient::PAStreamWriteCb(pa_stream *stream, size_t length, void
     auto asClient = static_cast<AudioServiceClient *>(userdata);
     auto mainLoop = static_cast<pa_threaded_mainloop *>(asClient->mainLoop);
     pa_threaded_mainloop_signal(mainLoop, 0);
+    asClient->RecordDataCallback();
 
     if (asClient->renderMode_ != RENDER_MODE_CALLBACK) {
+        // Drain the write cache on the mainloop thread, app writes only touch the ring
+        if (asClient->ringCache_.IsValid()) {
+            asClient->FlushRingCacheToPA(length);
+            asClient->ContinueCacheDrain();
+            asClient->isCacheStarved_ = (pa_stream_writable_size(stream) > 0);
+            asClient->NotifyRingCacheWritable();
+        }
         return;
     }
 
-    std::shared_ptr<AudioRendererWriteCallback> cb = asClient->writeCallback_.lock();
-    if (cb != nullptr) {
+    if (!asClient->writeCallback_.expired()) {
         size_t requestSize;
         asClient->GetMinimumBufferSize(requestSize);
-        AUDIO_INFO_LOG("AudioServiceClient::PAStreamWriteCb: cb != nullptr firing OnWriteData");
-        AUDIO_INFO_LOG("AudioServiceClient::OnWriteData requestSize : %{public}zu", requestSize);
-        cb->OnWriteData(requestSize);
+        AUDIO_DEBUG_LOG("AudioServiceClient::OnWriteData requestSize : %{public}zu", requestSize);
+        // The app fills or drains its buffer inside the callback, run it off the mainloop shared by all streams
+        PostCountedNotification(asClient->pendingWriteRequests_, [weakCb = asClient->writeCallback_, requestSize] {
+            std::shared_ptr<AudioRendererWriteCallback> cb = weakCb.lock();
+            if (cb != nullptr) {
+                cb->OnWriteData(requestSize);
+            }
+        }, 1);
     } else {
         AUDIO_ERR_LOG("AudioServiceClient::PAStreamWriteCb: cb == nullptr not firing OnWriteData");
     }
@@ -369,18 +438,23 @@ void AudioServiceClient::PAStreamReadCb(pa_stream *stream, size_t length, void *
     auto asClient = static_cast<AudioServiceClient *>(userdata);
     auto mainLoop = static_cast<pa_threaded_mainloop *>(asClient->mainLoop);
     pa_threaded_mainloop_signal(mainLoop, 0);
+    asClient->RecordDataCallback();
 
     if (asClient->captureMode_ != CAPTURE_MODE_CALLBACK) {
         return;
     }
 
-    std::shared_ptr<AudioCapturerReadCallback> cb = asClient->readCallback_.lock();
-    if (cb != nullptr) {
+    if (!asClient->readCallback_.expired()) {
         size_t requestSize;
         asClient->GetMinimumBufferSize(requestSize);
-        AUDIO_INFO_LOG("AudioServiceClient::PAStreamReadCb: cb != nullptr firing OnReadData");
-        AUDIO_INFO_LOG("AudioServiceClient::OnReadData requestSize : %{public}zu", requestSize);
-        cb->OnReadData(requestSize);
+        AUDIO_DEBUG_LOG("AudioServiceClient::OnReadData requestSize : %{public}zu", requestSize);
+        // The app fills or drains its buffer inside the callback, run it off the mainloop shared by all streams
+        PostCountedNotification(asClient->pendingReadRequests_, [weakCb = asClient->readCallback_, requestSize] {
+            std::shared_ptr<AudioCapturerReadCallback> cb = weakCb.lock();
+            if (cb != nullptr) {
+                cb->OnReadData(requestSize);
+            }
+        }, 1);
     } else {
         AUDIO_ERR_LOG("AudioServiceClient::PAStreamReadCb: cb == nullptr not firing OnReadData");
     }
@@ -395,12 +469,69 @@ void AudioServiceClient::PAStreamUnderFlowCb(pa_stream *stream, void *userdata)
 
     AudioServiceClient *asClient = (AudioServiceClient *)userdata;
     asClient->underFlowCount++;
+    asClient->streamStats_.AddUnderrun();
+}
+
+void AudioServiceClient::PAStreamOverFlowCb(pa_stream *stream, void *userdata)
+{
+    if (!userdata) {
+        AUDIO_ERR_LOG("AudioServiceClient::PAStreamOverFlowCb: userdata is null");
+        return;
+    }
+
+    AudioServiceClient *asClient = (AudioServiceClient *)userdata;
+    asClient->streamStats_.AddOverrun();
+}
+
+void AudioServiceClient::RecordDataCallback()
+{
+    pa_usec_t now = pa_rtclock_now();
+    streamStats_.AddCallback(now, callbackPeriodUsec_);
+    if (now - lastStatsPublishUsec_ >= STATS_PUBLISH_INTERVAL_IN_USEC) {
+        lastStatsPublishUsec_ = now;
+        PublishStreamStatistics();
+    }
+}
+
+void AudioServiceClient::PublishStreamStatistics()
+{
+    AudioStreamStatistics stats;
+    streamStats_.GetStatistics(stats);
+
+    string jitter;
+    for (size_t i = 0; i < STATISTICS_JITTER_BUCKETS; i++) {
+        jitter += (i == 0 ? "" : ",") + to_string(stats.callbackJitter[i]);
+    }
+
+    pa_proplist *propList = pa_proplist_new();
+    if (propList == nullptr) {
+        return;
+    }
+    pa_proplist_sets(propList, STATS_PROP_UNDERRUNS, to_string(stats.underrunCount).c_str());
+    pa_proplist_sets(propList, STATS_PROP_OVERRUNS, to_string(stats.overrunCount).c_str());
+    pa_proplist_sets(propList, STATS_PROP_BYTES_DROPPED, to_string(stats.bytesDropped).c_str());
+    pa_proplist_sets(propList, STATS_PROP_BLOCKING_USEC,
+        (to_string(stats.avgBlockingTimeUsec) + "/" + to_string(stats.maxBlockingTimeUsec)).c_str());
+    pa_proplist_sets(propList, STATS_PROP_JITTER, jitter.c_str());
+
+    // Fire and forget, the server dump reads whatever was published last
+    pa_operation *operation = pa_stream_proplist_update(paStream, PA_UPDATE_REPLACE, propList, nullptr, nullptr);
+    pa_proplist_free(propList);
+    if (operation != nullptr) {
+        pa_operation_unref(operation);
+    }
 }
 
 void AudioServiceClient::PAStreamLatencyUpdateCb(pa_stream *stream, void *userdata)
 {
-    pa_threaded_mainloop *mainLoop = (pa_threaded_mainloop *)userdata;
-    pa_threaded_mainloop_signal(mainLoop, 0);
+    if (!userdata) {
+        AUDIO_ERR_LOG("AudioServiceClient::PAStreamLatencyUpdateCb: userdata is null");
+        return;
+    }
+
+    AudioServiceClient *asClient = (AudioServiceClient *)userdata;
+    asClient->PublishTimingSnapshot();
+    pa_threaded_mainloop_signal(asClient->mainLoop, 0);
 }
 
 void AudioServiceClient::PAStreamStateCb(pa_stream *stream, void *userdata)
@@ -432,31 +563,8 @@ void AudioServiceClient::PAStreamStateCb(pa_stream *stream, void *userdata)
     }
 }
 
-void AudioServiceClient::PAContextStateCb(pa_context *context, void *userdata)
-{
-    pa_threaded_mainloop *mainLoop = (pa_threaded_mainloop *)userdata;
-    AUDIO_INFO_LOG("Current Context State: %{private}d", pa_context_get_state(context));
-
-    switch (pa_context_get_state(context)) {
-        case PA_CONTEXT_READY:
-        case PA_CONTEXT_TERMINATED:
-        case PA_CONTEXT_FAILED:
-            pa_threaded_mainloop_signal(mainLoop, 0);
-            break;
-
-        case PA_CONTEXT_UNCONNECTED:
-        case PA_CONTEXT_CONNECTING:
-        case PA_CONTEXT_AUTHORIZING:
-        case PA_CONTEXT_SETTING_NAME:
-        default:
-            break;
-    }
-}
-
 AudioServiceClient::AudioServiceClient()
 {
-    isMainLoopStarted = false;
-    isContextConnected = false;
     isStreamConnected = false;
 
     sinkDevices.clear();
@@ -473,7 +581,6 @@ AudioServiceClient::AudioServiceClient()
     streamIndex = 0;
     sessionID = 0;
     volumeChannels = STEREO;
-    streamInfoUpdated = false;
 
     renderRate = RENDER_RATE_NORMAL;
     renderMode_ = RENDER_MODE_NORMAL;
@@ -505,16 +612,13 @@ AudioServiceClient::AudioServiceClient()
     internalRdBufIndex = 0;
     internalRdBufLen = 0;
     streamCmdStatus = 0;
-    updatePropStatus = 0;
     streamDrainStatus = 0;
     streamFlushStatus = 0;
     underFlowCount = 0;
 
-    acache.readIndex = 0;
-    acache.writeIndex = 0;
-    acache.isFull = false;
-    acache.totalCacheSize = 0;
-    acache.buffer = nullptr;
+    cacheThreshold_ = 0;
+    isCacheStarved_ = false;
+    isCacheWriterWaiting_ = false;
 
     setBufferSize = 0;
     PAStreamCorkSuccessCb = PAStreamStopSuccessCb;
@@ -523,50 +627,33 @@ AudioServiceClient::AudioServiceClient()
 void AudioServiceClient::ResetPAAudioClient()
 {
     lock_guard<mutex> lock(ctrlMutex);
-    if (mainLoop && (isMainLoopStarted == true))
-        pa_threaded_mainloop_stop(mainLoop);
-
-    if (paStream) {
+    if (mainLoop && paStream) {
+        // The mainloop is shared with other streams of the process, only detach this stream from it
+        pa_threaded_mainloop_lock(mainLoop);
         pa_stream_set_state_callback(paStream, nullptr, nullptr);
         pa_stream_set_write_callback(paStream, nullptr, nullptr);
         pa_stream_set_read_callback(paStream, nullptr, nullptr);
         pa_stream_set_latency_update_callback(paStream, nullptr, nullptr);
         pa_stream_set_underflow_callback(paStream, nullptr, nullptr);
+        pa_stream_set_overflow_callback(paStream, nullptr, nullptr);
+        CancelPendingOperations();
+
+        if (volumeOperation_ != nullptr) {
+            pa_operation_cancel(volumeOperation_);
+            pa_operation_unref(volumeOperation_);
+            volumeOperation_ = nullptr;
+        }
+        isVolumeUpdatePending_ = false;
 
         if (isStreamConnected == true)
             pa_stream_disconnect(paStream);
         pa_stream_unref(paStream);
+        pa_threaded_mainloop_unlock(mainLoop);
     }
 
-    if (context) {
-        pa_context_set_state_callback(context, nullptr, nullptr);
-        if (isContextConnected == true)
-            pa_context_disconnect(context);
-        pa_context_unref(context);
-    }
-
-    if (mainLoop)
-        pa_threaded_mainloop_free(mainLoop);
-
-    for (auto &thread : mPositionCBThreads) {
-        if (thread && thread->joinable()) {
-            thread->join();
-        }
-    }
-
-    for (auto &thread : mPeriodPositionCBThreads) {
-        if (thread && thread->joinable()) {
-            thread->join();
-        }
-    }
-
-    if (appCookiePath.compare("")) {
-        remove(appCookiePath.c_str());
-        appCookiePath = "";
-    }
+    // Drops this client's reference, the last one stops the mainloop and disconnects
+    paContext_ = nullptr;
 
-    isMainLoopStarted  = false;
-    isContextConnected = false;
     isStreamConnected  = false;
 
     sinkDevices.clear();
@@ -588,11 +675,20 @@ void AudioServiceClient::ResetPAAudioClient()
     internalRdBufLen   = 0;
     underFlowCount     = 0;
 
-    acache.buffer = nullptr;
-    acache.readIndex = 0;
-    acache.writeIndex = 0;
-    acache.isFull = false;
-    acache.totalCacheSize = 0;
+    ringCache_.Reset();
+    cacheThreshold_ = 0;
+    isCacheStarved_ = false;
+    NotifyRingCacheWritable();
+    acquiredWriteBuffer_ = nullptr;
+    acquiredWriteBufferLen_ = 0;
+    isReadBufferAcquired_ = false;
+    timingSnapshot_.Reset();
+    streamStats_.Reset();
+    callbackPeriodUsec_ = 0;
+    lastStatsPublishUsec_ = 0;
+
+    ReleaseSessionID(sessionID);
+    sessionID = 0;
 
     setBufferSize = 0;
     PAStreamCorkSuccessCb = nullptr;
@@ -652,7 +748,6 @@ bool AudioServiceClient::VerifyClientPermission(const std::string &permissionNam
 
 int32_t AudioServiceClient::Initialize(ASClientType eClientType)
 {
-    int error = PA_ERR_INTERNAL;
     eAudioClientType = eClientType;
 
     mMarkReached = false;
@@ -665,83 +760,15 @@ int32_t AudioServiceClient::Initialize(ASClientType eClientType)
 
     mAudioSystemMgr = AudioSystemManager::GetInstance();
 
-    mainLoop = pa_threaded_mainloop_new();
-    if (mainLoop == nullptr)
-        return AUDIO_CLIENT_INIT_ERR;
-
-    api = pa_threaded_mainloop_get_api(mainLoop);
-    if (api == nullptr) {
-        ResetPAAudioClient();
-        return AUDIO_CLIENT_INIT_ERR;
-    }
-
-    context = pa_context_new(api, "AudioServiceClient");
-    if (context == nullptr) {
-        ResetPAAudioClient();
-        return AUDIO_CLIENT_INIT_ERR;
-    }
-
-    pa_context_set_state_callback(context, PAContextStateCb, mainLoop);
-
-    if (!cachePath_.empty()) {
-        AUDIO_DEBUG_LOG("abilityContext not null");
-        int32_t size = 0;
-
-        const char *cookieData = mAudioSystemMgr->RetrieveCookie(size);
-        if (size <= 0) {
-            AUDIO_ERR_LOG("Error retrieving cookie");
-            return AUDIO_CLIENT_INIT_ERR;
-        }
-
-        appCookiePath = cachePath_ + PATH_SEPARATOR + COOKIE_FILE_NAME;
-
-        ofstream cookieCache(appCookiePath.c_str(), std::ofstream::binary);
-        cookieCache.write(cookieData, size);
-        cookieCache.flush();
-        cookieCache.close();
-
-        pa_context_load_cookie_from_file(context, appCookiePath.c_str());
-    }
-
-    if (pa_context_connect(context, nullptr, PA_CONTEXT_NOFAIL, nullptr) < 0) {
-        error = pa_context_errno(context);
-        AUDIO_ERR_LOG("context connect error: %{public}s", pa_strerror(error));
-        ResetPAAudioClient();
-        return AUDIO_CLIENT_INIT_ERR;
-    }
-
-    isContextConnected = true;
-    pa_threaded_mainloop_lock(mainLoop);
-
-    if (pa_threaded_mainloop_start(mainLoop) < 0) {
-        pa_threaded_mainloop_unlock(mainLoop);
-        ResetPAAudioClient();
+    paContext_ = AudioPaContext::Acquire(cachePath_);
+    if (paContext_ == nullptr) {
+        AUDIO_ERR_LOG("Acquire audio server connection failed");
         return AUDIO_CLIENT_INIT_ERR;
     }
 
-    isMainLoopStarted = true;
-    while (true) {
-        pa_context_state_t state = pa_context_get_state(context);
-        if (state == PA_CONTEXT_READY)
-            break;
-
-        if (!PA_CONTEXT_IS_GOOD(state)) {
-            error = pa_context_errno(context);
-            AUDIO_ERR_LOG("context bad state error: %{public}s", pa_strerror(error));
-            pa_threaded_mainloop_unlock(mainLoop);
-            ResetPAAudioClient();
-            return AUDIO_CLIENT_INIT_ERR;
-        }
-
-        pa_threaded_mainloop_wait(mainLoop);
-    }
-
-    if (appCookiePath.compare("")) {
-        remove(appCookiePath.c_str());
-        appCookiePath = "";
-    }
-
-    pa_threaded_mainloop_unlock(mainLoop);
+    mainLoop = paContext_->GetMainLoop();
+    api = paContext_->GetApi();
+    context = paContext_->GetContext();
     return AUDIO_CLIENT_SUCCESS;
 }
 
@@ -803,7 +830,19 @@ int32_t AudioServiceClient::ConnectStreamToPA()
 
     pa_buffer_attr bufferAttr;
     bufferAttr.fragsize = static_cast<uint32_t>(-1);
-    if (latency_in_msec <= LATENCY_THRESHOLD) {
+    if ((eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) && isLowLatency_) {
+        // With PA_STREAM_ADJUST_LATENCY the server raises these to the minimum latency the sink supports
+        bufferAttr.prebuf = AlignToAudioFrameSize(pa_usec_to_bytes(LOW_LATENCY_IN_MSEC * PA_USEC_PER_MSEC,
+                                                                   &sampleSpec), sampleSpec);
+        bufferAttr.tlength = LOW_LATENCY_T_LENGTH_FACTOR * bufferAttr.prebuf;
+        bufferAttr.maxlength = bufferAttr.tlength;
+    } else if ((eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) && isDeepBuffer_) {
+        // Large requests let both the client and the sink sleep for hundreds of milliseconds between refills
+        bufferAttr.tlength = AlignToAudioFrameSize(pa_usec_to_bytes(DEEP_BUFFER_IN_MSEC * PA_USEC_PER_MSEC,
+                                                                    &sampleSpec), sampleSpec);
+        bufferAttr.prebuf = AlignToAudioFrameSize(bufferAttr.tlength / DEEP_BUFFER_MIN_REQ_DIVISOR, sampleSpec);
+        bufferAttr.maxlength = bufferAttr.tlength;
+    } else if (latency_in_msec <= LATENCY_THRESHOLD) {
         bufferAttr.prebuf = AlignToAudioFrameSize(pa_usec_to_bytes(latency_in_msec * PA_USEC_PER_MSEC, &sampleSpec),
                                                   sampleSpec);
         bufferAttr.maxlength =  NO_OF_PREBUF_TIMES * bufferAttr.prebuf;
@@ -820,13 +859,17 @@ int32_t AudioServiceClient::ConnectStreamToPA()
                                             (pa_stream_flags_t)(PA_STREAM_ADJUST_LATENCY
                                             | PA_STREAM_INTERPOLATE_TIMING
                                             | PA_STREAM_START_CORKED
+                                            | PA_STREAM_AUTO_TIMING_UPDATE
                                             | PA_STREAM_VARIABLE_RATE), nullptr, nullptr);
-        preBuf_ = make_unique<uint8_t[]>(bufferAttr.maxlength);
-        if (preBuf_ == nullptr) {
-            AUDIO_ERR_LOG("Allocate memory for buffer failed.");
-            return AUDIO_CLIENT_INIT_ERR;
+        if (!isLowLatency_ && !isDeepBuffer_) {
+            preBuf_ = make_unique<uint8_t[]>(bufferAttr.maxlength);
+            if (preBuf_ == nullptr) {
+                AUDIO_ERR_LOG("Allocate memory for buffer failed.");
+                pa_threaded_mainloop_unlock(mainLoop);
+                return AUDIO_CLIENT_INIT_ERR;
+            }
+            memset_s(preBuf_.get(), bufferAttr.maxlength, 0, bufferAttr.maxlength);
         }
-        memset_s(preBuf_.get(), bufferAttr.maxlength, 0, bufferAttr.maxlength);
     } else {
         result = pa_stream_connect_record(paStream, nullptr, nullptr,
                                           (pa_stream_flags_t)(PA_STREAM_INTERPOLATE_TIMING
@@ -858,6 +901,27 @@ int32_t AudioServiceClient::ConnectStreamToPA()
         pa_threaded_mainloop_wait(mainLoop);
     }
 
+    if ((eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) && (isLowLatency_ || isDeepBuffer_)) {
+        const pa_buffer_attr *negotiatedAttr = pa_stream_get_buffer_attr(paStream);
+        if (negotiatedAttr != nullptr) {
+            AUDIO_INFO_LOG("%{public}s stream, tlength: %{public}u, minreq: %{public}u, prebuf: %{public}u",
+                isLowLatency_ ? "Low latency" : "Deep buffer", negotiatedAttr->tlength, negotiatedAttr->minreq,
+                negotiatedAttr->prebuf);
+        }
+    }
+
+    // Data callbacks are expected once per minreq (playback) or fragsize (record), the base for the jitter statistics
+    const pa_buffer_attr *streamAttr = pa_stream_get_buffer_attr(paStream);
+    if (streamAttr != nullptr) {
+        size_t period = (eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) ? streamAttr->minreq : streamAttr->fragsize;
+        callbackPeriodUsec_ = pa_bytes_to_usec(period, &sampleSpec);
+    }
+
+    // The sink input of a playback stream keeps its index and channel map for the lifetime of the stream,
+    // cache them so volume updates do not have to query the sink input info
+    streamIndex = pa_stream_get_index(paStream);
+    volumeChannels = sampleSpec.channels;
+
     isStreamConnected = true;
     pa_threaded_mainloop_unlock(mainLoop);
     return AUDIO_CLIENT_SUCCESS;
@@ -877,16 +941,15 @@ int32_t AudioServiceClient::InitializeAudioCache()
         return AUDIO_CLIENT_INIT_ERR;
     }
 
-    acache.buffer = make_unique<uint8_t[]>(bufferAttr->minreq);
-    if (acache.buffer == nullptr) {
+    if (!ringCache_.Init(bufferAttr->minreq * RING_CACHE_SIZE_FACTOR)) {
         AUDIO_ERR_LOG("Allocate memory for buffer failed");
         return AUDIO_CLIENT_INIT_ERR;
     }
 
-    acache.readIndex = 0;
-    acache.writeIndex = 0;
-    acache.totalCacheSize = bufferAttr->minreq;
-    acache.isFull = false;
+    cacheThreshold_ = bufferAttr->minreq;
+    isCacheStarved_ = true;
+    AUDIO_INFO_LOG("audio cache size: %{public}zu, threshold: %{public}zu", ringCache_.GetCapacity(),
+        cacheThreshold_);
     return AUDIO_CLIENT_SUCCESS;
 }
 
@@ -920,7 +983,16 @@ int32_t AudioServiceClient::CreateStream(AudioStreamParams audioParams, AudioStr
 
     pa_proplist_sets(propList, "stream.type", streamName.c_str());
     pa_proplist_sets(propList, "stream.volumeFactor", std::to_string(mVolumeFactor).c_str());
-    pa_proplist_sets(propList, "stream.sessionID", std::to_string(pa_context_get_index(context)).c_str());
+    ReleaseSessionID(sessionID);
+    sessionID = AcquireSessionID();
+    if (sessionID == 0) {
+        AUDIO_ERR_LOG("No session ID left for the stream");
+        pa_proplist_free(propList);
+        pa_threaded_mainloop_unlock(mainLoop);
+        ResetPAAudioClient();
+        return AUDIO_CLIENT_CREATE_STREAM_ERR;
+    }
+    pa_proplist_sets(propList, "stream.sessionID", std::to_string(sessionID).c_str());
     pa_proplist_sets(propList, "stream.startTime", streamStartTime.c_str());
 
     AUDIO_ERR_LOG("Creating stream of channels %{public}d", audioParams.channels);
@@ -964,13 +1036,13 @@ int32_t AudioServiceClient::CreateStream(AudioStreamParams audioParams, AudioStr
     pa_stream_set_state_callback(paStream, PAStreamStateCb, (void *)this);
     pa_stream_set_write_callback(paStream, PAStreamWriteCb, (void *)this);
     pa_stream_set_read_callback(paStream, PAStreamReadCb, (void *)this);
-    pa_stream_set_latency_update_callback(paStream, PAStreamLatencyUpdateCb, mainLoop);
+    pa_stream_set_latency_update_callback(paStream, PAStreamLatencyUpdateCb, (void *)this);
     pa_stream_set_underflow_callback(paStream, PAStreamUnderFlowCb, (void *)this);
+    pa_stream_set_overflow_callback(paStream, PAStreamOverFlowCb, (void *)this);
 
     pa_threaded_mainloop_unlock(mainLoop);
 
     error = ConnectStreamToPA();
-    streamInfoUpdated = false;
     if (error < 0) {
         AUDIO_ERR_LOG("Create Stream Failed");
         ResetPAAudioClient();
@@ -978,7 +1050,8 @@ int32_t AudioServiceClient::CreateStream(AudioStreamParams audioParams, AudioStr
     }
 
     if (eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) {
-        error = InitializeAudioCache();
+        // Low latency streams write straight into the server buffer, an extra cache would only add delay
+        error = isLowLatency_ ? AUDIO_CLIENT_SUCCESS : InitializeAudioCache();
         if (error < 0) {
             AUDIO_ERR_LOG("Initialize audio cache failed");
             ResetPAAudioClient();
@@ -1004,12 +1077,11 @@ int32_t AudioServiceClient::CreateStream(AudioStreamParams audioParams, AudioStr
 int32_t AudioServiceClient::GetSessionID(uint32_t &sessionID) const
 {
     AUDIO_DEBUG_LOG("AudioServiceClient: GetSessionID");
-    uint32_t client_index = pa_context_get_index(context);
-    if (client_index == PA_INVALID_INDEX) {
+    if (this->sessionID == 0) {
         return AUDIO_CLIENT_ERR;
     }
 
-    sessionID = client_index;
+    sessionID = this->sessionID;
 
     return AUDIO_CLIENT_SUCCESS;
 }
@@ -1036,6 +1108,7 @@ int32_t AudioServiceClient::StartStream()
     }
 
     streamCmdStatus = 0;
+    streamStats_.RestartCallbackClock();
     operation = pa_stream_cork(paStream, 0, PAStreamStartSuccessCb, (void *)this);
 
     while (pa_operation_get_state(operation) == PA_OPERATION_RUNNING) {
@@ -1092,6 +1165,8 @@ int32_t AudioServiceClient::StopStream()
             internalRdBufLen = 0;
             internalRdBufIndex = 0;
         }
+        // A read buffer still held by the application is gone with the dropped fragment
+        isReadBufferAcquired_ = false;
         return AUDIO_CLIENT_SUCCESS;
     }
 }
@@ -1144,6 +1219,15 @@ int32_t AudioServiceClient::FlushStream()
         return AUDIO_CLIENT_ERR;
     }
 
+    // Producer is held off by dataMutex and consumer by the mainloop lock, so the cache can be reset here
+    ringCache_.Reset();
+    NotifyRingCacheWritable();
+    if (acquiredWriteBuffer_ != nullptr) {
+        pa_stream_cancel_write(paStream);
+        acquiredWriteBuffer_ = nullptr;
+        acquiredWriteBufferLen_ = 0;
+    }
+
     streamFlushStatus = 0;
     operation = pa_stream_flush(paStream, PAStreamFlushSuccessCb, (void *)this);
     if (operation == nullptr) {
@@ -1163,9 +1247,6 @@ int32_t AudioServiceClient::FlushStream()
         return AUDIO_CLIENT_ERR;
     } else {
         AUDIO_INFO_LOG("Stream Flushed Successfully");
-        acache.readIndex = 0;
-        acache.writeIndex = 0;
-        acache.isFull = false;
         return AUDIO_CLIENT_SUCCESS;
     }
 }
@@ -1223,163 +1304,480 @@ int32_t AudioServiceClient::DrainStream()
     }
 }
 
-int32_t AudioServiceClient::SetStreamVolume(uint32_t sessionID, uint32_t volume)
+void AudioServiceClient::PAStreamAsyncSuccessCb(pa_stream *stream, int32_t success, void *userdata)
 {
-    return AUDIO_CLIENT_SUCCESS;
+    if (!userdata) {
+        AUDIO_ERR_LOG("AudioServiceClient::PAStreamAsyncSuccessCb: userdata is null");
+        return;
+    }
+
+    auto pending = static_cast<PendingStreamOperation *>(userdata);
+    AudioServiceClient *asClient = pending->client;
+    if (success && (pending->targetState != INVALID)) {
+        asClient->state_ = pending->targetState;
+        asClient->WriteStateChangedSysEvents();
+        asClient->PostStateChange(asClient->state_);
+    }
+    asClient->CompletePendingOperation(pending, success);
 }
 
-int32_t AudioServiceClient::PaWriteStream(const uint8_t *buffer, size_t &length)
+// The functions below up to CorkStreamAsync are called with the mainloop lock held
+AudioServiceClient::PendingStreamOperation *AudioServiceClient::AddPendingOperation(State targetState,
+    const StreamOperationCallback &callback)
 {
-    int error = 0;
+    auto pending = std::make_unique<PendingStreamOperation>();
+    pending->client = this;
+    pending->targetState = targetState;
+    pending->callback = callback;
+    PendingStreamOperation *operation = pending.get();
+    pendingOperations_.push_back(std::move(pending));
+    return operation;
+}
 
-    while (length > 0) {
-        size_t writableSize;
+void AudioServiceClient::CompletePendingOperation(PendingStreamOperation *pending, bool success)
+{
+    if (pending->operation != nullptr) {
+        pa_operation_unref(pending->operation);
+    }
+    if (pending == cacheDrainOperation_) {
+        cacheDrainOperation_ = nullptr;
+    }
 
-        while (!(writableSize = pa_stream_writable_size(paStream))) {
-            pa_threaded_mainloop_wait(mainLoop);
-        }
+    StreamOperationCallback callback = pending->callback;
+    pendingOperations_.remove_if([pending](const std::unique_ptr<PendingStreamOperation> &operation) {
+        return operation.get() == pending;
+    });
 
-        AUDIO_DEBUG_LOG("Write stream: writable size = %{public}zu, length = %{public}zu", writableSize, length);
-        if (writableSize > length) {
-            writableSize = length;
-        }
+    // Application code must not run on the mainloop thread, and a completion must never be lost to a full backlog
+    if (callback) {
+        AudioCallbackExecutor::GetInstance().PostReliable([callback, success] { callback(success); });
+    }
+}
 
-        writableSize = AlignToAudioFrameSize(writableSize, sampleSpec);
-        if (writableSize == 0) {
-            AUDIO_ERR_LOG("Align to frame size failed");
-            error = AUDIO_CLIENT_WRITE_STREAM_ERR;
-            break;
+void AudioServiceClient::CancelPendingOperations()
+{
+    for (auto &pending : pendingOperations_) {
+        if (pending->operation != nullptr) {
+            pa_operation_cancel(pending->operation);
+            pa_operation_unref(pending->operation);
         }
-
-        error = pa_stream_write(paStream, (void *)buffer, writableSize, nullptr, 0LL,
-                                PA_SEEK_RELATIVE);
-        if (error < 0) {
-            AUDIO_ERR_LOG("Write stream failed");
-            error = AUDIO_CLIENT_WRITE_STREAM_ERR;
-            break;
+        StreamOperationCallback callback = pending->callback;
+        if (callback) {
+            AudioCallbackExecutor::GetInstance().PostReliable([callback] { callback(false); });
         }
-
-        AUDIO_DEBUG_LOG("Writable size: %{public}zu, bytes to write: %{public}zu, return val: %{public}d",
-                        writableSize, length, error);
-        buffer = buffer + writableSize;
-        length -= writableSize;
-
-        HandleRenderPositionCallbacks(writableSize);
     }
-
-    return error;
+    pendingOperations_.clear();
+    cacheDrainOperation_ = nullptr;
 }
 
-void AudioServiceClient::HandleRenderPositionCallbacks(size_t bytesWritten)
+void AudioServiceClient::SendDrainOperation(PendingStreamOperation *pending)
 {
-    mTotalBytesWritten += bytesWritten;
-    if (mFrameSize == 0) {
-        AUDIO_ERR_LOG("HandleRenderPositionCallbacks: capturePeriodPositionCb not set");
-        return;
+    pending->operation = pa_stream_drain(paStream, PAStreamAsyncSuccessCb, pending);
+    if (pending->operation == nullptr) {
+        AUDIO_ERR_LOG("Stream Drain Operation Failed");
+        CompletePendingOperation(pending, false);
     }
+}
 
-    uint64_t writtenFrameNumber = mTotalBytesWritten / mFrameSize;
-    AUDIO_DEBUG_LOG("frame size: %{public}d", mFrameSize);
-
-    {
-        std::lock_guard<std::mutex> lock(rendererMarkReachedMutex_);
-        if (!mMarkReached && mRenderPositionCb) {
-            AUDIO_DEBUG_LOG("frame mark position: %{public}" PRIu64 ", Total frames written: %{public}" PRIu64,
-                static_cast<uint64_t>(mFrameMarkPosition), static_cast<uint64_t>(writtenFrameNumber));
-            if (writtenFrameNumber >= mFrameMarkPosition) {
-                AUDIO_DEBUG_LOG("audio service client OnMarkReached");
-                mPositionCBThreads.emplace_back(std::make_unique<std::thread>(&RendererPositionCallback::OnMarkReached,
-                                                mRenderPositionCb, mFrameMarkPosition));
-                mMarkReached = true;
-            }
-        }
+void AudioServiceClient::ContinueCacheDrain()
+{
+    // A trailing partial frame stays in the cache, the application may still complete it with its next write
+    if ((cacheDrainOperation_ == nullptr) || ((mFrameSize != 0) && (ringCache_.GetReadableSize() >= mFrameSize))) {
+        return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(rendererPeriodReachedMutex_);
-        if (mRenderPeriodPositionCb) {
-            mFramePeriodWritten += (bytesWritten / mFrameSize);
-            AUDIO_DEBUG_LOG("frame period number: %{public}" PRIu64 ", Total frames written: %{public}" PRIu64,
-                static_cast<uint64_t>(mFramePeriodNumber), static_cast<uint64_t>(writtenFrameNumber));
-            if (mFramePeriodWritten >= mFramePeriodNumber) {
-                mFramePeriodWritten %= mFramePeriodNumber;
-                AUDIO_DEBUG_LOG("OnPeriodReached, remaining frames: %{public}" PRIu64,
-                    static_cast<uint64_t>(mFramePeriodWritten));
-                mPeriodPositionCBThreads.emplace_back(std::make_unique<std::thread>(
-                    &RendererPeriodPositionCallback::OnPeriodReached, mRenderPeriodPositionCb, mFramePeriodNumber));
-            }
-        }
-    }
+    PendingStreamOperation *pending = cacheDrainOperation_;
+    cacheDrainOperation_ = nullptr;
+    SendDrainOperation(pending);
 }
 
-int32_t AudioServiceClient::DrainAudioCache()
+int32_t AudioServiceClient::DrainStreamAsync(const StreamOperationCallback &callback)
 {
+    if (eAudioClientType != AUDIO_SERVICE_CLIENT_PLAYBACK) {
+        AUDIO_ERR_LOG("Drain is not supported");
+        return AUDIO_CLIENT_ERR;
+    }
+
     if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
         return AUDIO_CLIENT_PA_ERR;
     }
 
     pa_threaded_mainloop_lock(mainLoop);
-
-    int32_t error = 0;
-    if (acache.buffer == nullptr) {
-        AUDIO_ERR_LOG("Drain cache failed");
+    if ((pa_stream_get_state(paStream) != PA_STREAM_READY) || (cacheDrainOperation_ != nullptr)) {
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("Stream Drain Failed");
         return AUDIO_CLIENT_ERR;
     }
 
-    size_t length = acache.writeIndex - acache.readIndex;
-    const uint8_t *buffer = acache.buffer.get();
-
-    error = PaWriteStream(buffer, length);
+    PendingStreamOperation *pending = AddPendingOperation(INVALID, callback);
+    if (ringCache_.IsValid()) {
+        // The server only drains what it has, the write callback sends the drain once the cache is empty
+        FlushRingCacheToPA(pa_stream_writable_size(paStream));
+        NotifyRingCacheWritable();
+        cacheDrainOperation_ = pending;
+        ContinueCacheDrain();
+    } else {
+        SendDrainOperation(pending);
+    }
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::FlushStreamAsync(const StreamOperationCallback &callback)
+{
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    lock_guard<mutex> lock(dataMutex);
+    pa_threaded_mainloop_lock(mainLoop);
+    if (pa_stream_get_state(paStream) != PA_STREAM_READY) {
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("Stream Flush Failed");
+        return AUDIO_CLIENT_ERR;
+    }
 
-    acache.readIndex = 0;
-    acache.writeIndex = 0;
+    ringCache_.Reset();
+    NotifyRingCacheWritable();
+    if (acquiredWriteBuffer_ != nullptr) {
+        pa_stream_cancel_write(paStream);
+        acquiredWriteBuffer_ = nullptr;
+        acquiredWriteBufferLen_ = 0;
+    }
 
+    PendingStreamOperation *pending = AddPendingOperation(INVALID, callback);
+    pending->operation = pa_stream_flush(paStream, PAStreamAsyncSuccessCb, pending);
+    if (pending->operation == nullptr) {
+        pending->callback = nullptr;
+        CompletePendingOperation(pending, false);
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("Stream Flush Operation Failed");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    // The cache is empty now, a drain waiting for it goes out after the flush
+    ContinueCacheDrain();
     pa_threaded_mainloop_unlock(mainLoop);
-    return error;
+
+    return AUDIO_CLIENT_SUCCESS;
 }
 
-size_t AudioServiceClient::WriteToAudioCache(const StreamBuffer &stream)
+int32_t AudioServiceClient::CorkStreamAsync(State targetState, const StreamOperationCallback &callback)
 {
-    if (stream.buffer == nullptr) {
-        return 0;
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    lock_guard<mutex> lock(ctrlMutex);
+    pa_threaded_mainloop_lock(mainLoop);
+    if (pa_stream_get_state(paStream) != PA_STREAM_READY) {
+        int32_t error = pa_context_errno(context);
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("Stream Cork Failed : %{public}d", error);
+        return AUDIO_CLIENT_ERR;
+    }
+
+    PendingStreamOperation *pending = AddPendingOperation(targetState, callback);
+    pending->operation = pa_stream_cork(paStream, 1, PAStreamAsyncSuccessCb, pending);
+    if (pending->operation == nullptr) {
+        pending->callback = nullptr;
+        CompletePendingOperation(pending, false);
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("Stream Cork Operation Failed");
+        return AUDIO_CLIENT_ERR;
+    }
+    // A writer waiting for space sees the cork and returns, the data path stop does not wait for it
+    pa_threaded_mainloop_signal(mainLoop, 0);
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::PauseStreamAsync(const StreamOperationCallback &callback)
+{
+    return CorkStreamAsync(PAUSED, callback);
+}
+
+int32_t AudioServiceClient::StopStreamAsync(const StreamOperationCallback &callback)
+{
+    // StopStream drops the pending capture fragment, which may still be lent to a reader of a record stream
+    if (eAudioClientType != AUDIO_SERVICE_CLIENT_PLAYBACK) {
+        AUDIO_ERR_LOG("Asynchronous stop is not supported");
+        return AUDIO_CLIENT_ERR;
     }
+    return CorkStreamAsync(STOPPED, callback);
+}
 
-    const uint8_t *inputBuffer = stream.buffer;
-    uint8_t *cacheBuffer = acache.buffer.get() + acache.writeIndex;
+int32_t AudioServiceClient::SetStreamVolume(uint32_t sessionID, uint32_t volume)
+{
+    return AUDIO_CLIENT_SUCCESS;
+}
 
-    size_t inputLen = stream.bufferLen;
+int32_t AudioServiceClient::PaWriteStream(const uint8_t *buffer, size_t &length)
+{
+    int error = 0;
 
-    while (inputLen > 0) {
-        size_t writableSize = acache.totalCacheSize - acache.writeIndex;
+    while (length > 0) {
+        size_t writableSize;
 
-        if (writableSize > inputLen) {
-            writableSize = inputLen;
+        // A corked stream requests nothing, a writer waiting for it would never wake up
+        while (!(writableSize = pa_stream_writable_size(paStream)) && (pa_stream_is_corked(paStream) != 1)) {
+            pa_threaded_mainloop_wait(mainLoop);
+        }
+        if (writableSize == 0) {
+            AUDIO_INFO_LOG("Stream corked, %{public}zu bytes left unwritten", length);
+            break;
         }
 
+        AUDIO_DEBUG_LOG("Write stream: writable size = %{public}zu, length = %{public}zu", writableSize, length);
+        if (writableSize > length) {
+            writableSize = length;
+        }
+
+        writableSize = AlignToAudioFrameSize(writableSize, sampleSpec);
         if (writableSize == 0) {
+            AUDIO_ERR_LOG("Align to frame size failed");
+            error = AUDIO_CLIENT_WRITE_STREAM_ERR;
+            break;
+        }
+
+        error = pa_stream_write(paStream, (void *)buffer, writableSize, nullptr, 0LL,
+                                PA_SEEK_RELATIVE);
+        if (error < 0) {
+            AUDIO_ERR_LOG("Write stream failed");
+            error = AUDIO_CLIENT_WRITE_STREAM_ERR;
+            break;
+        }
+
+        AUDIO_DEBUG_LOG("Writable size: %{public}zu, bytes to write: %{public}zu, return val: %{public}d",
+                        writableSize, length, error);
+        buffer = buffer + writableSize;
+        length -= writableSize;
+
+        HandleRenderPositionCallbacks(writableSize);
+    }
+
+    PublishTimingSnapshot();
+    return error;
+}
+
+void AudioServiceClient::HandleRenderPositionCallbacks(size_t bytesWritten)
+{
+    mTotalBytesWritten += bytesWritten;
+    if (mFrameSize == 0) {
+        AUDIO_ERR_LOG("HandleRenderPositionCallbacks: capturePeriodPositionCb not set");
+        return;
+    }
+
+    uint64_t writtenFrameNumber = mTotalBytesWritten / mFrameSize;
+    AUDIO_DEBUG_LOG("frame size: %{public}d", mFrameSize);
+
+    {
+        std::lock_guard<std::mutex> lock(rendererMarkReachedMutex_);
+        if (!mMarkReached && mRenderPositionCb) {
+            AUDIO_DEBUG_LOG("frame mark position: %{public}" PRIu64 ", Total frames written: %{public}" PRIu64,
+                static_cast<uint64_t>(mFrameMarkPosition), static_cast<uint64_t>(writtenFrameNumber));
+            if (writtenFrameNumber >= mFrameMarkPosition) {
+                AUDIO_DEBUG_LOG("audio service client OnMarkReached");
+                AudioCallbackExecutor::GetInstance().PostReliable(
+                    [cb = mRenderPositionCb, position = mFrameMarkPosition] { cb->OnMarkReached(position); });
+                mMarkReached = true;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(rendererPeriodReachedMutex_);
+        if (mRenderPeriodPositionCb) {
+            mFramePeriodWritten += (bytesWritten / mFrameSize);
+            AUDIO_DEBUG_LOG("frame period number: %{public}" PRIu64 ", Total frames written: %{public}" PRIu64,
+                static_cast<uint64_t>(mFramePeriodNumber), static_cast<uint64_t>(writtenFrameNumber));
+            if (mFramePeriodWritten >= mFramePeriodNumber) {
+                uint64_t periods = mFramePeriodWritten / mFramePeriodNumber;
+                mFramePeriodWritten %= mFramePeriodNumber;
+                AUDIO_DEBUG_LOG("OnPeriodReached, remaining frames: %{public}" PRIu64,
+                    static_cast<uint64_t>(mFramePeriodWritten));
+                PostCountedNotification(pendingPeriods_,
+                    [cb = mRenderPeriodPositionCb, frameCount = mFramePeriodNumber] {
+                        cb->OnPeriodReached(frameCount);
+                    }, periods);
+            }
+        }
+    }
+}
+
+void AudioServiceClient::PostCountedNotification(const std::shared_ptr<std::atomic<uint64_t>> &pending,
+    const std::function<void()> &notify, uint64_t count)
+{
+    // Keep at most one task per notification kind queued, notifications raised meanwhile are run by that task
+    if (pending->fetch_add(count) > 0) {
+        return;
+    }
+
+    AudioCallbackExecutor::GetInstance().PostReliable([pending, notify] {
+        for (uint64_t left = pending->exchange(0); left > 0; left--) {
+            notify();
+        }
+    });
+}
+
+void AudioServiceClient::PostStateChange(State state)
+{
+    AudioCallbackExecutor::GetInstance().PostReliable([weakCb = streamCallback_, state] {
+        std::shared_ptr<AudioStreamCallback> streamCb = weakCb.lock();
+        if (streamCb != nullptr) {
+            streamCb->OnStateChange(state);
+        }
+    });
+}
+
+int32_t AudioServiceClient::DrainAudioCache()
+{
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    if (isLowLatency_) {
+        // Nothing is cached on the client side
+        return AUDIO_CLIENT_SUCCESS;
+    }
+
+    if (!ringCache_.IsValid() || mFrameSize == 0) {
+        AUDIO_ERR_LOG("Drain cache failed");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop);
+
+    while (ringCache_.GetReadableSize() >= mFrameSize) {
+        size_t writableSize = pa_stream_writable_size(paStream);
+        if (writableSize < mFrameSize) {
+            pa_threaded_mainloop_wait(mainLoop);
+            continue;
+        }
+
+        if (FlushRingCacheToPA(writableSize) == 0) {
+            AUDIO_ERR_LOG("Drain cache failed");
+            pa_threaded_mainloop_unlock(mainLoop);
+            return AUDIO_CLIENT_WRITE_STREAM_ERR;
+        }
+    }
+
+    // Drop a trailing partial frame, PA only accepts whole frames
+    streamStats_.AddDroppedBytes(ringCache_.Skip(ringCache_.GetReadableSize()));
+    isCacheStarved_ = (pa_stream_writable_size(paStream) > 0);
+    NotifyRingCacheWritable();
+
+    pa_threaded_mainloop_unlock(mainLoop);
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+size_t AudioServiceClient::FlushRingCacheToPA(size_t maxLength)
+{
+    // Must be called with the mainloop lock held, this is the only consumer of the ring cache
+    if (acquiredWriteBuffer_ != nullptr) {
+        // The stream write block is lent to the application until CommitWriteStreamBuffer
+        return 0;
+    }
+
+    size_t length = AlignToAudioFrameSize(min(maxLength, ringCache_.GetReadableSize()), sampleSpec);
+    size_t totalWritten = 0;
+
+    while (length > 0) {
+        void *data = nullptr;
+        size_t nbytes = length;
+        if (pa_stream_begin_write(paStream, &data, &nbytes) < 0 || data == nullptr) {
+            AUDIO_ERR_LOG("pa_stream_begin_write failed");
             break;
         }
 
-        if (memcpy_s(cacheBuffer, acache.totalCacheSize, inputBuffer, writableSize)) {
+        nbytes = AlignToAudioFrameSize(min(nbytes, length), sampleSpec);
+        if (nbytes == 0) {
+            pa_stream_cancel_write(paStream);
             break;
         }
 
-        inputBuffer = inputBuffer + writableSize;
-        cacheBuffer = cacheBuffer + writableSize;
-        inputLen -= writableSize;
-        acache.writeIndex += writableSize;
+        size_t readSize = ringCache_.Read(static_cast<uint8_t *>(data), nbytes);
+        if (readSize != nbytes || pa_stream_write(paStream, data, readSize, nullptr, 0LL, PA_SEEK_RELATIVE) < 0) {
+            AUDIO_ERR_LOG("Write cache to stream failed");
+            pa_stream_cancel_write(paStream);
+            break;
+        }
+
+        length -= readSize;
+        totalWritten += readSize;
+        HandleRenderPositionCallbacks(readSize);
+    }
+
+    if (totalWritten > 0) {
+        PublishTimingSnapshot();
+    }
+    return totalWritten;
+}
+
+void AudioServiceClient::KickRingCacheDrain()
+{
+    // The write callback only fires when PA requests more data. If it found the cache empty last time,
+    // push the cached data once enough has accumulated, otherwise the callback drains it on its own.
+    if (!isCacheStarved_ || ringCache_.GetReadableSize() < min(cacheThreshold_, ringCache_.GetCapacity())) {
+        return;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop);
+    size_t writableSize = pa_stream_writable_size(paStream);
+    if (writableSize > 0) {
+        FlushRingCacheToPA(writableSize);
+        writableSize = pa_stream_writable_size(paStream);
+    }
+    isCacheStarved_ = (writableSize > 0);
+    pa_threaded_mainloop_unlock(mainLoop);
+}
+
+bool AudioServiceClient::WaitRingCacheWritable()
+{
+    unique_lock<mutex> lock(cacheWaitMutex_);
+    isCacheWriterWaiting_ = true;
+    bool isWritable = cacheWaitCond_.wait_for(lock, chrono::milliseconds(RING_CACHE_WAIT_TIMEOUT_IN_MS),
+        [this] { return ringCache_.GetWritableSize() > 0; });
+    isCacheWriterWaiting_ = false;
+    return isWritable;
+}
+
+void AudioServiceClient::NotifyRingCacheWritable()
+{
+    if (isCacheWriterWaiting_) {
+        lock_guard<mutex> lock(cacheWaitMutex_);
+        cacheWaitCond_.notify_all();
+    }
+}
+
+size_t AudioServiceClient::WriteToAudioCache(const StreamBuffer &stream)
+{
+    if (stream.buffer == nullptr) {
+        return 0;
     }
 
-    if ((acache.writeIndex - acache.readIndex) == acache.totalCacheSize) {
-        acache.isFull = true;
+    size_t cachedLen = 0;
+    while (cachedLen < stream.bufferLen) {
+        size_t writtenSize = ringCache_.Write(stream.buffer + cachedLen, stream.bufferLen - cachedLen);
+        cachedLen += writtenSize;
+        KickRingCacheDrain();
+
+        if ((writtenSize == 0) && !WaitRingCacheWritable()) {
+            AUDIO_ERR_LOG("Wait for audio cache timed out, cached: %{public}zu", cachedLen);
+            streamStats_.AddDroppedBytes(stream.bufferLen - cachedLen);
+            break;
+        }
     }
 
-    return (stream.bufferLen - inputLen);
+    return cachedLen;
 }
 
 size_t AudioServiceClient::WriteStreamInCb(const StreamBuffer &stream, int32_t &pError)
 {
     lock_guard<mutex> lock(dataMutex);
+    BlockingTimeRecorder blockingTime(streamStats_);
     int error = 0;
     if (CheckPaStatusIfinvalid(mainLoop, context, paStream, 0, pError) < 0) {
         return 0;
@@ -1398,58 +1796,128 @@ size_t AudioServiceClient::WriteStreamInCb(const StreamBuffer &stream, int32_t &
 size_t AudioServiceClient::WriteStream(const StreamBuffer &stream, int32_t &pError)
 {
     lock_guard<mutex> lock(dataMutex);
-    int error = 0;
-    size_t cachedLen = WriteToAudioCache(stream);
-
-    if (!acache.isFull) {
-        pError = error;
-        return cachedLen;
-    }
+    BlockingTimeRecorder blockingTime(streamStats_);
     if (CheckPaStatusIfinvalid(mainLoop, context, paStream, 0, pError) < 0) {
         return 0;
     }
-    pa_threaded_mainloop_lock(mainLoop);
 
-    if (acache.buffer == nullptr) {
+    if (!ringCache_.IsValid() && !isLowLatency_) {
         AUDIO_ERR_LOG("Buffer is null");
         pError = AUDIO_CLIENT_WRITE_STREAM_ERR;
-        return cachedLen;
+        return 0;
     }
 
-    const uint8_t *buffer = acache.buffer.get();
-    size_t length = acache.totalCacheSize;
+    if (acquiredWriteBuffer_ != nullptr) {
+        AUDIO_ERR_LOG("Write buffer acquired but not committed");
+        pError = AUDIO_CLIENT_WRITE_STREAM_ERR;
+        return 0;
+    }
 
-    error = PaWriteStream(buffer, length);
-    acache.readIndex += acache.totalCacheSize;
-    acache.isFull = false;
-
-    if (!error && (length >= 0) && !acache.isFull) {
-        uint8_t *cacheBuffer = acache.buffer.get();
-        uint32_t offset = acache.readIndex;
-        uint32_t size = (acache.writeIndex - acache.readIndex);
-        if (size > 0) {
-            if (memcpy_s(cacheBuffer, acache.totalCacheSize, cacheBuffer + offset, size)) {
-                AUDIO_ERR_LOG("Update cache failed");
-                pError = AUDIO_CLIENT_WRITE_STREAM_ERR;
-                return cachedLen;
+    if (isLowLatency_) {
+        pa_threaded_mainloop_lock(mainLoop);
+        size_t length = stream.bufferLen;
+        pError = PaWriteStream(stream.buffer, length);
+        pa_threaded_mainloop_unlock(mainLoop);
+        return stream.bufferLen - length;
+    }
+
+    pError = 0;
+    return WriteToAudioCache(stream);
+}
+
+int32_t AudioServiceClient::AcquireWriteStreamBuffer(StreamBuffer &stream)
+{
+    lock_guard<mutex> lock(dataMutex);
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    if (acquiredWriteBuffer_ != nullptr || mFrameSize == 0) {
+        AUDIO_ERR_LOG("Acquire write buffer failed, buffer already acquired");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop);
+
+    // Data cached by WriteStream has to reach PA ahead of the acquired block
+    size_t writableSize = pa_stream_writable_size(paStream);
+    while ((writableSize < mFrameSize) || (ringCache_.GetReadableSize() >= mFrameSize)) {
+        if (writableSize < mFrameSize) {
+            if (pa_stream_is_corked(paStream) == 1) {
+                AUDIO_ERR_LOG("Acquire write buffer failed, stream corked");
+                pa_threaded_mainloop_unlock(mainLoop);
+                return AUDIO_CLIENT_ERR;
             }
-            AUDIO_INFO_LOG("rearranging the audio cache");
-        }
-        acache.readIndex = 0;
-        acache.writeIndex = 0;
-
-        if (cachedLen < stream.bufferLen) {
-            StreamBuffer str;
-            str.buffer = stream.buffer + cachedLen;
-            str.bufferLen = stream.bufferLen - cachedLen;
-            AUDIO_DEBUG_LOG("writing pending data to audio cache: %{public}d", str.bufferLen);
-            cachedLen += WriteToAudioCache(str);
+            pa_threaded_mainloop_wait(mainLoop);
+        } else if (FlushRingCacheToPA(writableSize) == 0) {
+            AUDIO_ERR_LOG("Write cache to stream failed");
+            pa_threaded_mainloop_unlock(mainLoop);
+            return AUDIO_CLIENT_WRITE_STREAM_ERR;
         }
+        writableSize = pa_stream_writable_size(paStream);
+    }
+    isCacheStarved_ = false;
+
+    void *data = nullptr;
+    size_t nbytes = writableSize;
+    if (pa_stream_begin_write(paStream, &data, &nbytes) < 0 || data == nullptr) {
+        AUDIO_ERR_LOG("pa_stream_begin_write failed");
+        pa_threaded_mainloop_unlock(mainLoop);
+        return AUDIO_CLIENT_WRITE_STREAM_ERR;
     }
 
+    nbytes = AlignToAudioFrameSize(min(nbytes, writableSize), sampleSpec);
+    if (nbytes == 0) {
+        AUDIO_ERR_LOG("Align to frame size failed");
+        pa_stream_cancel_write(paStream);
+        pa_threaded_mainloop_unlock(mainLoop);
+        return AUDIO_CLIENT_WRITE_STREAM_ERR;
+    }
+
+    acquiredWriteBuffer_ = data;
+    acquiredWriteBufferLen_ = nbytes;
     pa_threaded_mainloop_unlock(mainLoop);
-    pError = error;
-    return cachedLen;
+
+    stream.buffer = static_cast<uint8_t *>(data);
+    stream.bufferLen = nbytes;
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::CommitWriteStreamBuffer(size_t length)
+{
+    lock_guard<mutex> lock(dataMutex);
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    if (acquiredWriteBuffer_ == nullptr) {
+        AUDIO_ERR_LOG("Commit write buffer failed, no buffer acquired");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    if ((length > acquiredWriteBufferLen_) || (length % mFrameSize != 0)) {
+        AUDIO_ERR_LOG("Invalid commit length: %{public}zu, acquired: %{public}zu", length, acquiredWriteBufferLen_);
+        return AUDIO_CLIENT_INVALID_PARAMS_ERR;
+    }
+
+    int32_t ret = AUDIO_CLIENT_SUCCESS;
+    pa_threaded_mainloop_lock(mainLoop);
+    if (length == 0) {
+        pa_stream_cancel_write(paStream);
+    } else if (pa_stream_write(paStream, acquiredWriteBuffer_, length, nullptr, 0LL, PA_SEEK_RELATIVE) < 0) {
+        AUDIO_ERR_LOG("Write stream failed");
+        pa_stream_cancel_write(paStream);
+        ret = AUDIO_CLIENT_WRITE_STREAM_ERR;
+    } else {
+        HandleRenderPositionCallbacks(length);
+        PublishTimingSnapshot();
+    }
+
+    acquiredWriteBuffer_ = nullptr;
+    acquiredWriteBufferLen_ = 0;
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    return ret;
 }
 
 int32_t AudioServiceClient::UpdateReadBuffer(uint8_t *buffer, size_t &length, size_t &readSize)
@@ -1481,6 +1949,12 @@ int32_t AudioServiceClient::UpdateReadBuffer(uint8_t *buffer, size_t &length, si
 
 int32_t AudioServiceClient::RenderPrebuf(uint32_t writeLen)
 {
+    if (isLowLatency_ || isDeepBuffer_) {
+        // Prebuffered silence would sit in front of the first frames, for a deep buffer that is hundreds of
+        // milliseconds of extra start up delay
+        return AUDIO_CLIENT_SUCCESS;
+    }
+
     const pa_buffer_attr *bufferAttr = pa_stream_get_buffer_attr(paStream);
     if (bufferAttr == nullptr) {
         AUDIO_ERR_LOG("pa_stream_get_buffer_attr returned nullptr");
@@ -1523,12 +1997,43 @@ int32_t AudioServiceClient::RenderPrebuf(uint32_t writeLen)
     return AUDIO_CLIENT_SUCCESS;
 }
 
-void AudioServiceClient::OnTimeOut()
+void AudioServiceClient::PAReadTimeoutCb(pa_mainloop_api *mainLoopApi, pa_time_event *event,
+    const struct timeval *tv, void *userdata)
 {
+    AudioServiceClient *asClient = static_cast<AudioServiceClient *>(userdata);
     AUDIO_ERR_LOG("Inside read timeout callback");
-    pa_threaded_mainloop_lock(mainLoop);
-    pa_threaded_mainloop_signal(mainLoop, 0);
-    pa_threaded_mainloop_unlock(mainLoop);
+    asClient->isReadTimedOut_ = true;
+    pa_threaded_mainloop_signal(asClient->mainLoop, 0);
+}
+
+// Called with the mainloop lock held. The timeout is a time event on the shared mainloop, so blocking reads do
+// not need a timer thread of their own. Wakeups for other streams sharing the mainloop do not move the deadline,
+// it is armed on the first wait of a read call and only cleared by EndReadWait.
+bool AudioServiceClient::WaitForReadData()
+{
+    if (readTimeoutEvent_ == nullptr) {
+        isReadTimedOut_ = false;
+        readTimeoutEvent_ = pa_context_rttime_new(context, pa_rtclock_now() + READ_TIMEOUT_IN_SEC * PA_USEC_PER_SEC,
+            PAReadTimeoutCb, this);
+        if (readTimeoutEvent_ == nullptr) {
+            AUDIO_ERR_LOG("pa_context_rttime_new failed, not waiting without a timeout");
+            return false;
+        }
+    }
+
+    if (!isReadTimedOut_) {
+        pa_threaded_mainloop_wait(mainLoop);
+    }
+    return !isReadTimedOut_;
+}
+
+// Called with the mainloop lock held at the end of every read call that may have waited
+void AudioServiceClient::EndReadWait()
+{
+    if (readTimeoutEvent_ != nullptr) {
+        api->time_free(readTimeoutEvent_);
+        readTimeoutEvent_ = nullptr;
+    }
 }
 
 void AudioServiceClient::SetClientID(int32_t clientPid, int32_t clientUid)
@@ -1555,8 +2060,8 @@ void AudioServiceClient::HandleCapturePositionCallbacks(size_t bytesRead)
                 static_cast<uint64_t>(mFrameMarkPosition), static_cast<uint64_t>(readFrameNumber));
             if (readFrameNumber >= mFrameMarkPosition) {
                 AUDIO_DEBUG_LOG("audio service client capturer OnMarkReached");
-                mPositionCBThreads.emplace_back(std::make_unique<std::thread>(&CapturerPositionCallback::OnMarkReached,
-                                                mCapturePositionCb, mFrameMarkPosition));
+                AudioCallbackExecutor::GetInstance().PostReliable(
+                    [cb = mCapturePositionCb, position = mFrameMarkPosition] { cb->OnMarkReached(position); });
                 mMarkReached = true;
             }
         }
@@ -1569,11 +2074,14 @@ void AudioServiceClient::HandleCapturePositionCallbacks(size_t bytesRead)
             AUDIO_DEBUG_LOG("frame period number: %{public}" PRIu64 ", Total frames read: %{public}" PRIu64,
                 static_cast<uint64_t>(mFramePeriodNumber), static_cast<uint64_t>(readFrameNumber));
             if (mFramePeriodRead >= mFramePeriodNumber) {
+                uint64_t periods = mFramePeriodRead / mFramePeriodNumber;
                 mFramePeriodRead %= mFramePeriodNumber;
                 AUDIO_DEBUG_LOG("audio service client OnPeriodReached, remaining frames: %{public}" PRIu64,
                     static_cast<uint64_t>(mFramePeriodRead));
-                mPeriodPositionCBThreads.emplace_back(std::make_unique<std::thread>(
-                    &CapturerPeriodPositionCallback::OnPeriodReached, mCapturePeriodPositionCb, mFramePeriodNumber));
+                PostCountedNotification(pendingPeriods_,
+                    [cb = mCapturePeriodPositionCb, frameCount = mFramePeriodNumber] {
+                        cb->OnPeriodReached(frameCount);
+                    }, periods);
             }
         }
     }
@@ -1589,56 +2097,129 @@ int32_t AudioServiceClient::ReadStream(StreamBuffer &stream, bool isBlocking)
     }
 
     lock_guard<mutex> lock(dataMutex);
+    if (isReadBufferAcquired_) {
+        AUDIO_ERR_LOG("Read stream failed, read buffer is acquired");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    BlockingTimeRecorder blockingTime(streamStats_);
     pa_threaded_mainloop_lock(mainLoop);
+    int32_t ret = AUDIO_CLIENT_SUCCESS;
     while (length > 0) {
-        while (!internalReadBuffer) {
-            int retVal = pa_stream_peek(paStream, &internalReadBuffer, &internalRdBufLen);
-            if (retVal < 0) {
-                AUDIO_ERR_LOG("pa_stream_peek failed, retVal: %{public}d", retVal);
-                pa_threaded_mainloop_unlock(mainLoop);
-                return AUDIO_CLIENT_READ_STREAM_ERR;
-            }
-
-            if (internalRdBufLen <= 0) {
-                if (isBlocking) {
-                    StartTimer(READ_TIMEOUT_IN_SEC);
-                    pa_threaded_mainloop_wait(mainLoop);
-                    StopTimer();
-                    if (IsTimeOut()) {
-                        AUDIO_ERR_LOG("Read timeout");
-                        pa_threaded_mainloop_unlock(mainLoop);
-                        return AUDIO_CLIENT_READ_STREAM_ERR;
-                    }
-                } else {
-                    pa_threaded_mainloop_unlock(mainLoop);
-                    HandleCapturePositionCallbacks(readSize);
-                    return readSize;
-                }
-            } else if (!internalReadBuffer) {
-                retVal = pa_stream_drop(paStream);
-                if (retVal < 0) {
-                    AUDIO_ERR_LOG("pa_stream_drop failed, retVal: %{public}d", retVal);
-                    pa_threaded_mainloop_unlock(mainLoop);
-                    return AUDIO_CLIENT_READ_STREAM_ERR;
-                }
-            } else {
-                internalRdBufIndex = 0;
-                AUDIO_DEBUG_LOG("buffer size from PA: %{public}zu", internalRdBufLen);
-            }
+        ret = PeekReadFragment(isBlocking);
+        if ((ret != AUDIO_CLIENT_SUCCESS) || !internalReadBuffer) {
+            break;
         }
 
         if (UpdateReadBuffer(buffer, length, readSize) != 0) {
-            pa_threaded_mainloop_unlock(mainLoop);
-            return AUDIO_CLIENT_READ_STREAM_ERR;
+            ret = AUDIO_CLIENT_READ_STREAM_ERR;
+            break;
         }
         buffer = stream.buffer + readSize;
     }
+    EndReadWait();
     pa_threaded_mainloop_unlock(mainLoop);
+    if (ret != AUDIO_CLIENT_SUCCESS) {
+        return ret;
+    }
     HandleCapturePositionCallbacks(readSize);
 
     return readSize;
 }
 
+// Called with the mainloop lock held. Leaves internalReadBuffer null only if isBlocking is false and no data is queued.
+int32_t AudioServiceClient::PeekReadFragment(bool isBlocking)
+{
+    while (!internalReadBuffer) {
+        int retVal = pa_stream_peek(paStream, &internalReadBuffer, &internalRdBufLen);
+        if (retVal < 0) {
+            AUDIO_ERR_LOG("pa_stream_peek failed, retVal: %{public}d", retVal);
+            return AUDIO_CLIENT_READ_STREAM_ERR;
+        }
+
+        if (internalRdBufLen <= 0) {
+            if (!isBlocking) {
+                return AUDIO_CLIENT_SUCCESS;
+            }
+            if (!WaitForReadData()) {
+                AUDIO_ERR_LOG("Read timeout");
+                return AUDIO_CLIENT_READ_STREAM_ERR;
+            }
+        } else if (!internalReadBuffer) {
+            // A hole, the server dropped captured data because the client did not read it in time
+            streamStats_.AddOverrun();
+            streamStats_.AddDroppedBytes(internalRdBufLen);
+            retVal = pa_stream_drop(paStream);
+            if (retVal < 0) {
+                AUDIO_ERR_LOG("pa_stream_drop failed, retVal: %{public}d", retVal);
+                return AUDIO_CLIENT_READ_STREAM_ERR;
+            }
+        } else {
+            internalRdBufIndex = 0;
+            AUDIO_DEBUG_LOG("buffer size from PA: %{public}zu", internalRdBufLen);
+        }
+    }
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::AcquireReadStreamBuffer(StreamBuffer &stream)
+{
+    lock_guard<mutex> lock(dataMutex);
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    if (isReadBufferAcquired_) {
+        AUDIO_ERR_LOG("Acquire read buffer failed, buffer already acquired");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop);
+    int32_t ret = PeekReadFragment(true);
+    EndReadWait();
+    if (ret != AUDIO_CLIENT_SUCCESS) {
+        pa_threaded_mainloop_unlock(mainLoop);
+        return ret;
+    }
+
+    // A fragment partly copied out by ReadStream is lent from where the copy stopped
+    stream.buffer = static_cast<uint8_t *>(const_cast<void *>(internalReadBuffer)) + internalRdBufIndex;
+    stream.bufferLen = internalRdBufLen;
+    isReadBufferAcquired_ = true;
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::ReleaseReadStreamBuffer()
+{
+    lock_guard<mutex> lock(dataMutex);
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    if (!isReadBufferAcquired_) {
+        AUDIO_ERR_LOG("Release read buffer failed, no buffer acquired");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    pa_threaded_mainloop_lock(mainLoop);
+    size_t bytesRead = internalRdBufLen;
+    int retVal = pa_stream_drop(paStream);
+    internalReadBuffer = nullptr;
+    internalRdBufLen = 0;
+    internalRdBufIndex = 0;
+    isReadBufferAcquired_ = false;
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    if (retVal < 0) {
+        AUDIO_ERR_LOG("pa_stream_drop failed, retVal: %{public}d", retVal);
+        return AUDIO_CLIENT_READ_STREAM_ERR;
+    }
+    HandleCapturePositionCallbacks(bytesRead);
+    return AUDIO_CLIENT_SUCCESS;
+}
+
 int32_t AudioServiceClient::ReleaseStream()
 {
     state_ = RELEASED;
@@ -1771,12 +2352,49 @@ uint32_t AudioServiceClient::GetStreamVolume(uint32_t sessionID)
     return DEFAULT_STREAM_VOLUME;
 }
 
+void AudioServiceClient::PublishTimingSnapshot()
+{
+    // Called on the mainloop thread or with the mainloop lock held, which serializes the writers
+    const pa_timing_info *info = pa_stream_get_timing_info(paStream);
+    if (info == nullptr) {
+        return;
+    }
+
+    StreamTimingSnapshot snapshot {};
+    if (eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) {
+        snapshot.timeStamp = pa_bytes_to_usec(info->write_index, &sampleSpec);
+    } else if (pa_stream_get_time(paStream, &snapshot.timeStamp) < 0) {
+        return;
+    }
+
+    pa_usec_t paLatency {0};
+    int negative {0};
+    if (pa_stream_get_latency(paStream, &paLatency, &negative) < 0) {
+        return;
+    }
+
+    snapshot.latency = negative ? 0 : paLatency;
+    snapshot.publishTime = pa_rtclock_now();
+    snapshot.isRunning = (pa_stream_is_corked(paStream) == 0);
+    timingSnapshot_.Write(snapshot);
+}
+
 int32_t AudioServiceClient::GetCurrentTimeStamp(uint64_t &timeStamp)
 {
     if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
         return AUDIO_CLIENT_PA_ERR;
     }
 
+    // Use the timing published by the automatic timing updates, no round trip to the server
+    StreamTimingSnapshot snapshot {};
+    if (timingSnapshot_.Read(snapshot)) {
+        timeStamp = snapshot.timeStamp;
+        if ((eAudioClientType == AUDIO_SERVICE_CLIENT_RECORD) && snapshot.isRunning) {
+            timeStamp += pa_rtclock_now() - snapshot.publishTime;
+        }
+        return AUDIO_CLIENT_SUCCESS;
+    }
+
     lock_guard<mutex> lock(dataMutex);
     pa_threaded_mainloop_lock(mainLoop);
 
@@ -1795,6 +2413,7 @@ int32_t AudioServiceClient::GetCurrentTimeStamp(uint64_t &timeStamp)
     const pa_timing_info *info = pa_stream_get_timing_info(paStream);
     if (info == nullptr) {
         AUDIO_ERR_LOG("pa_stream_get_timing_info failed");
+        pa_threaded_mainloop_unlock(mainLoop);
         return AUDIO_CLIENT_ERR;
     }
 
@@ -1803,6 +2422,7 @@ int32_t AudioServiceClient::GetCurrentTimeStamp(uint64_t &timeStamp)
     } else if (eAudioClientType == AUDIO_SERVICE_CLIENT_RECORD) {
         if (pa_stream_get_time(paStream, &timeStamp)) {
             AUDIO_ERR_LOG("AudioServiceClient::GetCurrentTimeStamp failed for AUDIO_SERVICE_CLIENT_RECORD");
+            pa_threaded_mainloop_unlock(mainLoop);
             return AUDIO_CLIENT_ERR;
         }
     }
@@ -1812,14 +2432,9 @@ int32_t AudioServiceClient::GetCurrentTimeStamp(uint64_t &timeStamp)
     return AUDIO_CLIENT_SUCCESS;
 }
 
-int32_t AudioServiceClient::GetAudioLatency(uint64_t &latency)
+int32_t AudioServiceClient::QueryAudioLatency(pa_usec_t &paLatency)
 {
-    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
-        return AUDIO_CLIENT_PA_ERR;
-    }
     lock_guard<mutex> lock(dataMutex);
-    pa_usec_t paLatency {0};
-    pa_usec_t cacheLatency {0};
     int negative {0};
 
     // Get PA latency
@@ -1833,7 +2448,6 @@ int32_t AudioServiceClient::GetAudioLatency(uint64_t &latency)
         }
         if (pa_stream_get_latency(paStream, &paLatency, &negative) >= 0) {
             if (negative) {
-                latency = 0;
                 pa_threaded_mainloop_unlock(mainLoop);
                 return AUDIO_CLIENT_ERR;
             }
@@ -1844,9 +2458,33 @@ int32_t AudioServiceClient::GetAudioLatency(uint64_t &latency)
     }
     pa_threaded_mainloop_unlock(mainLoop);
 
+    return AUDIO_CLIENT_SUCCESS;
+}
+
+int32_t AudioServiceClient::GetAudioLatency(uint64_t &latency)
+{
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+    pa_usec_t paLatency {0};
+    pa_usec_t cacheLatency {0};
+
+    StreamTimingSnapshot snapshot {};
+    if (timingSnapshot_.Read(snapshot)) {
+        // Playback latency shrinks as the sink consumes data since the last update
+        paLatency = snapshot.latency;
+        pa_usec_t elapsed = pa_rtclock_now() - snapshot.publishTime;
+        if ((eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) && snapshot.isRunning) {
+            paLatency = (paLatency > elapsed) ? (paLatency - elapsed) : 0;
+        }
+    } else if (QueryAudioLatency(paLatency) != AUDIO_CLIENT_SUCCESS) {
+        latency = 0;
+        return AUDIO_CLIENT_ERR;
+    }
+
     if (eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) {
         // Get audio write cache latency
-        cacheLatency = pa_bytes_to_usec((acache.totalCacheSize - acache.writeIndex), &sampleSpec);
+        cacheLatency = pa_bytes_to_usec(ringCache_.GetReadableSize(), &sampleSpec);
 
         // Total latency will be sum of audio write cache latency + PA latency
         uint64_t fwLatency = paLatency + cacheLatency;
@@ -1870,6 +2508,42 @@ int32_t AudioServiceClient::GetAudioLatency(uint64_t &latency)
     return AUDIO_CLIENT_SUCCESS;
 }
 
+int32_t AudioServiceClient::GetStreamStatistics(AudioStreamStatistics &stats)
+{
+    if (CheckPaStatusIfinvalid(mainLoop, context, paStream, AUDIO_CLIENT_PA_ERR) < 0) {
+        return AUDIO_CLIENT_PA_ERR;
+    }
+
+    streamStats_.GetStatistics(stats);
+    stats.bufferFillPercent = 0;
+
+    pa_threaded_mainloop_lock(mainLoop);
+    const pa_buffer_attr *bufferAttr = pa_stream_get_buffer_attr(paStream);
+    if (bufferAttr == nullptr) {
+        pa_threaded_mainloop_unlock(mainLoop);
+        AUDIO_ERR_LOG("pa_stream_get_buffer_attr returned nullptr");
+        return AUDIO_CLIENT_ERR;
+    }
+
+    const uint32_t fullPercent = 100;
+    if (eAudioClientType == AUDIO_SERVICE_CLIENT_PLAYBACK) {
+        // Whatever the server does not request yet is still queued for playback
+        size_t writableSize = pa_stream_writable_size(paStream);
+        if ((bufferAttr->tlength > 0) && (writableSize <= bufferAttr->tlength)) {
+            stats.bufferFillPercent = (bufferAttr->tlength - writableSize) * fullPercent / bufferAttr->tlength;
+        }
+    } else {
+        size_t readableSize = pa_stream_readable_size(paStream);
+        if ((bufferAttr->maxlength > 0) && (readableSize != static_cast<size_t>(-1))) {
+            stats.bufferFillPercent = min(readableSize * fullPercent / bufferAttr->maxlength,
+                static_cast<size_t>(fullPercent));
+        }
+    }
+    pa_threaded_mainloop_unlock(mainLoop);
+
+    return AUDIO_CLIENT_SUCCESS;
+}
+
 void AudioServiceClient::RegisterAudioRendererCallbacks(const AudioRendererCallbacks &cb)
 {
     AUDIO_INFO_LOG("Registering audio render callbacks");
@@ -2013,70 +2687,39 @@ int32_t AudioServiceClient::SetStreamVolume(float volume)
         return AUDIO_CLIENT_INVALID_PARAMS_ERR;
     }
 
+    if (mAudioSystemMgr == nullptr) {
+        AUDIO_ERR_LOG("System manager instance is null");
+        return AUDIO_CLIENT_ERR;
+    }
+
     int32_t volumeFactor = AudioSystemManager::MapVolumeFromHDI(mVolumeFactor);
     int32_t newVolumeFactor = AudioSystemManager::MapVolumeFromHDI(volume);
     if (newVolumeFactor > volumeFactor) {
         mUnMute_ = true;
     }
     AUDIO_INFO_LOG("mUnMute_ %{public}d", mUnMute_);
-    pa_threaded_mainloop_lock(mainLoop);
 
     mVolumeFactor = volume;
-    pa_proplist *propList = pa_proplist_new();
-    if (propList == nullptr) {
-        AUDIO_ERR_LOG("pa_proplist_new failed");
-        pa_threaded_mainloop_unlock(mainLoop);
-        return AUDIO_CLIENT_ERR;
-    }
-
-    updatePropStatus = 0;
-    pa_proplist_sets(propList, "stream.volumeFactor", std::to_string(mVolumeFactor).c_str());
-    pa_operation *updatePropOperation = pa_stream_proplist_update(paStream, PA_UPDATE_REPLACE, propList,
-        PAStreamUpdatePropSuccessCb, (void *)this);
-    if (updatePropOperation == nullptr) {
-        AUDIO_ERR_LOG("pa_stream_proplist_update returned null");
-        pa_proplist_free(propList);
-        pa_threaded_mainloop_unlock(mainLoop);
-        return AUDIO_CLIENT_ERR;
-    }
-
-    while (pa_operation_get_state(updatePropOperation) == PA_OPERATION_RUNNING) {
-        pa_threaded_mainloop_wait(mainLoop);
-    }
-    pa_proplist_free(propList);
-    pa_operation_unref(updatePropOperation);
-
-    if (!updatePropStatus) {
-        AUDIO_ERR_LOG("Update volume property failed");
-        pa_threaded_mainloop_unlock(mainLoop);
-        return AUDIO_CLIENT_ERR;
-    }
+    float vol = GetAppliedVolume();
 
-    if (mAudioSystemMgr == nullptr) {
-        AUDIO_ERR_LOG("System manager instance is null");
+    pa_threaded_mainloop_lock(mainLoop);
+    targetPaVolume_ = pa_sw_volume_from_linear(vol);
+    if (volumeOperation_ != nullptr) {
+        // Last writer wins, the update in flight applies the latest volume once it completes
+        isVolumeUpdatePending_ = true;
+    } else if (UpdatePaVolume() != AUDIO_CLIENT_SUCCESS) {
         pa_threaded_mainloop_unlock(mainLoop);
         return AUDIO_CLIENT_ERR;
     }
-
-    if (!streamInfoUpdated) {
-        uint32_t idx = pa_stream_get_index(paStream);
-        pa_operation *operation = pa_context_get_sink_input_info(context, idx, AudioServiceClient::GetSinkInputInfoCb,
-            reinterpret_cast<void *>(this));
-        if (operation == nullptr) {
-            AUDIO_ERR_LOG("pa_context_get_sink_input_info_list returned null");
-            pa_threaded_mainloop_unlock(mainLoop);
-            return AUDIO_CLIENT_ERR;
-        }
-
-        pa_threaded_mainloop_accept(mainLoop);
-
-        pa_operation_unref(operation);
-    } else {
-        SetPaVolume(*this);
-    }
-
     pa_threaded_mainloop_unlock(mainLoop);
 
+    AUDIO_INFO_LOG("Applied volume : %{public}f", vol);
+    HiviewDFX::HiSysEvent::Write("AUDIO", "AUDIO_VOLUME_CHANGE", HiviewDFX::HiSysEvent::EventType::BEHAVIOR,
+        "ISOUTPUT", 1,
+        "STREAMID", sessionID,
+        "STREAMTYPE", mStreamType,
+        "VOLUME", vol);
+
     return AUDIO_CLIENT_SUCCESS;
 }
 
@@ -2085,77 +2728,82 @@ float AudioServiceClient::GetStreamVolume()
     return mVolumeFactor;
 }
 
-void AudioServiceClient::GetSinkInputInfoCb(pa_context *context, const pa_sink_input_info *info, int eol,
-    void *userdata)
+float AudioServiceClient::GetAppliedVolume()
 {
-    AUDIO_INFO_LOG("GetSinkInputInfoVolumeCb in");
-    AudioServiceClient *thiz = reinterpret_cast<AudioServiceClient *>(userdata);
+    // Queries the policy service, so it must not be called with the mainloop lock held
+    int32_t systemVolumeInt = mAudioSystemMgr->GetVolume(static_cast<AudioSystemManager::AudioVolumeType>(mStreamType));
+    float systemVolume = AudioSystemManager::MapVolumeToHDI(systemVolumeInt);
+    float vol = systemVolume * mVolumeFactor;
 
-    if (eol < 0) {
-        AUDIO_ERR_LOG("Failed to get sink input information: %{public}s", pa_strerror(pa_context_errno(context)));
-        return;
+    AudioRingerMode ringerMode = mAudioSystemMgr->GetRingerMode();
+    if ((mStreamType == STREAM_RING) && (ringerMode != RINGER_MODE_NORMAL)) {
+        vol = MIN_STREAM_VOLUME_LEVEL;
     }
 
-    if (eol) {
-        pa_threaded_mainloop_signal(thiz->mainLoop, 1);
-        return;
+    if (mAudioSystemMgr->IsStreamMute(static_cast<AudioSystemManager::AudioVolumeType>(mStreamType))) {
+        if (mUnMute_) {
+            mAudioSystemMgr->SetMute(static_cast<AudioSystemManager::AudioVolumeType>(mStreamType), false);
+        } else {
+            vol = MIN_STREAM_VOLUME_LEVEL;
+        }
     }
 
-    if (info->proplist == nullptr) {
-        AUDIO_ERR_LOG("Invalid prop list for sink input (%{public}d).", info->index);
-        return;
-    }
+    return vol;
+}
 
-    uint32_t sessionID = 0;
-    const char *sessionCStr = pa_proplist_gets(info->proplist, "stream.sessionID");
-    if (sessionCStr != nullptr) {
-        std::stringstream sessionStr;
-        sessionStr << sessionCStr;
-        sessionStr >> sessionID;
+int32_t AudioServiceClient::UpdatePaVolume()
+{
+    // Must be called with the mainloop lock held
+    pa_proplist *propList = pa_proplist_new();
+    if (propList == nullptr) {
+        AUDIO_ERR_LOG("pa_proplist_new failed");
+        return AUDIO_CLIENT_ERR;
     }
 
-    thiz->cvolume = info->volume;
-    thiz->streamIndex = info->index;
-    thiz->sessionID = sessionID;
-    thiz->volumeChannels = info->channel_map.channels;
-    thiz->streamInfoUpdated = true;
+    pa_proplist_sets(propList, "stream.volumeFactor", std::to_string(mVolumeFactor).c_str());
+    pa_operation *updatePropOperation = pa_stream_proplist_update(paStream, PA_UPDATE_REPLACE, propList,
+        nullptr, nullptr);
+    pa_proplist_free(propList);
+    if (updatePropOperation == nullptr) {
+        AUDIO_ERR_LOG("pa_stream_proplist_update returned null");
+        return AUDIO_CLIENT_ERR;
+    }
+    pa_operation_unref(updatePropOperation);
 
-    SetPaVolume(*thiz);
+    pa_cvolume cv;
+    pa_cvolume_set(&cv, volumeChannels, targetPaVolume_);
+    volumeOperation_ = pa_context_set_sink_input_volume(context, streamIndex, &cv, PAStreamVolumeUpdateCb,
+        static_cast<void *>(this));
+    if (volumeOperation_ == nullptr) {
+        AUDIO_ERR_LOG("pa_context_set_sink_input_volume returned null");
+        return AUDIO_CLIENT_ERR;
+    }
 
-    return;
+    return AUDIO_CLIENT_SUCCESS;
 }
 
-void AudioServiceClient::SetPaVolume(const AudioServiceClient &client)
+void AudioServiceClient::PAStreamVolumeUpdateCb(pa_context *c, int success, void *userdata)
 {
-    pa_cvolume cv = client.cvolume;
-    int32_t systemVolumeInt
-        = client.mAudioSystemMgr->GetVolume(static_cast<AudioSystemManager::AudioVolumeType>(client.mStreamType));
-    float systemVolume = AudioSystemManager::MapVolumeToHDI(systemVolumeInt);
-    float vol = systemVolume * client.mVolumeFactor;
+    if (!userdata) {
+        AUDIO_ERR_LOG("AudioServiceClient::PAStreamVolumeUpdateCb: userdata is null");
+        return;
+    }
 
-    AudioRingerMode ringerMode = client.mAudioSystemMgr->GetRingerMode();
-    if ((client.mStreamType == STREAM_RING) && (ringerMode != RINGER_MODE_NORMAL)) {
-        vol = MIN_STREAM_VOLUME_LEVEL;
+    AudioServiceClient *asClient = static_cast<AudioServiceClient *>(userdata);
+    if (!success) {
+        AUDIO_ERR_LOG("Set sink input volume failed: %{public}s", pa_strerror(pa_context_errno(c)));
     }
 
-    if (client.mAudioSystemMgr->IsStreamMute(static_cast<AudioSystemManager::AudioVolumeType>(client.mStreamType))) {
-        if (client.mUnMute_) {
-            client.mAudioSystemMgr->SetMute(static_cast<AudioSystemManager::AudioVolumeType>(client.mStreamType),
-                false);
-        } else {
-            vol = MIN_STREAM_VOLUME_LEVEL;
-        }
+    if (asClient->volumeOperation_ != nullptr) {
+        pa_operation_unref(asClient->volumeOperation_);
+        asClient->volumeOperation_ = nullptr;
     }
-    uint32_t volume = pa_sw_volume_from_linear(vol);
-    pa_cvolume_set(&cv, client.volumeChannels, volume);
-    pa_operation_unref(pa_context_set_sink_input_volume(client.context, client.streamIndex, &cv, nullptr, nullptr));
 
-    AUDIO_INFO_LOG("Applied volume : %{public}f, pa volume: %{public}d", vol, volume);
-    HiviewDFX::HiSysEvent::Write("AUDIO", "AUDIO_VOLUME_CHANGE", HiviewDFX::HiSysEvent::EventType::BEHAVIOR,
-        "ISOUTPUT", 1,
-        "STREAMID", client.sessionID,
-        "STREAMTYPE", client.mStreamType,
-        "VOLUME", vol);
+    // Volumes set while this update was in flight collapse into one update with the latest value
+    if (asClient->isVolumeUpdatePending_) {
+        asClient->isVolumeUpdatePending_ = false;
+        asClient->UpdatePaVolume();
+    }
 }
 
 int32_t AudioServiceClient::SetStreamRenderRate(AudioRendererRate audioRendererRate)
@@ -2193,6 +2841,40 @@ AudioRendererRate AudioServiceClient::GetStreamRenderRate()
     return renderRate;
 }
 
+void AudioServiceClient::SetLowLatencyMode(bool isLowLatency)
+{
+    if (isLowLatency == isLowLatency_) {
+        return;
+    }
+    if (paStream != nullptr) {
+        AUDIO_ERR_LOG("Low latency mode can only be selected before the stream is created");
+        return;
+    }
+    isLowLatency_ = isLowLatency;
+}
+
+bool AudioServiceClient::IsLowLatencyMode() const
+{
+    return isLowLatency_;
+}
+
+void AudioServiceClient::SetDeepBufferMode(bool isDeepBuffer)
+{
+    if (isDeepBuffer == isDeepBuffer_) {
+        return;
+    }
+    if (paStream != nullptr) {
+        AUDIO_ERR_LOG("Deep buffer mode can only be selected before the stream is created");
+        return;
+    }
+    isDeepBuffer_ = isDeepBuffer;
+}
+
+bool AudioServiceClient::IsDeepBufferMode() const
+{
+    return isDeepBuffer_;
+}
+
 void AudioServiceClient::SaveStreamCallback(const std::weak_ptr<AudioStreamCallback> &callback)
 {
     streamCallback_ = callback;
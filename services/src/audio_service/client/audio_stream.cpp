@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <vector>
@@ -30,9 +31,11 @@ const unsigned long long TIME_CONVERSION_US_S = 1000000ULL; /* us to s */
 const unsigned long long TIME_CONVERSION_NS_US = 1000ULL; /* ns to us */
 const unsigned long long TIME_CONVERSION_NS_S = 1000000000ULL; /* ns to s */
 constexpr int32_t WRITE_RETRY_DELAY_IN_US = 500;
-constexpr int32_t READ_WRITE_WAIT_TIME_IN_US = 500;
-constexpr int32_t CB_WRITE_BUFFERS_WAIT_IN_US = 500;
-constexpr int32_t CB_READ_BUFFERS_WAIT_IN_US = 500;
+// Backoff between retries of a failed callback mode read or write, doubled per failure up to the cap
+constexpr uint32_t IO_RETRY_MIN_DELAY_MS = 5;
+constexpr uint32_t IO_RETRY_MAX_DELAY_MS = 160;
+// A buffer whose write keeps failing, e.g. on a partial frame, is handed back after this many retries
+constexpr uint32_t MAX_WRITE_RETRIES = 5;
 
 const map<pair<ContentType, StreamUsage>, AudioStreamType> AudioStream::streamTypeMap_ = AudioStream::CreateStreamMap();
 
@@ -101,16 +104,8 @@ AudioStream::AudioStream(AudioStreamType eStreamType, AudioMode eMode, int32_t a
 
 AudioStream::~AudioStream()
 {
-    isReadyToWrite_ = false;
-    isReadyToRead_ = false;
-
-    if (writeThread_ && writeThread_->joinable()) {
-        writeThread_->join();
-    }
-
-    if (readThread_ && readThread_->joinable()) {
-        readThread_->join();
-    }
+    StopBufferThread(isReadyToWrite_, writeThread_);
+    StopBufferThread(isReadyToRead_, readThread_);
 
     if (state_ != RELEASED && state_ != NEW) {
         ReleaseAudioStream();
@@ -128,6 +123,8 @@ AudioStream::~AudioStream()
 void AudioStream::SetRendererInfo(const AudioRendererInfo &rendererInfo)
 {
     rendererInfo_ = rendererInfo;
+    SetLowLatencyMode((static_cast<uint32_t>(rendererInfo.rendererFlags) & RENDERER_FLAG_LOW_LATENCY) != 0);
+    SetDeepBufferMode(IsDeepBufferStream(rendererInfo));
 }
 
 void AudioStream::SetCapturerInfo(const AudioCapturerInfo &capturerInfo)
@@ -185,6 +182,7 @@ int32_t AudioStream::GetBufferSize(size_t &bufferSize) const
     if (GetMinimumBufferSize(bufferSize) != 0) {
         return ERR_OPERATION_FAILED;
     }
+    bufferSize = ToAppBytes(bufferSize);
 
     return SUCCESS;
 }
@@ -208,6 +206,16 @@ int32_t AudioStream::GetLatency(uint64_t &latency)
     }
 }
 
+int32_t AudioStream::GetStatistics(AudioStreamStatistics &stats)
+{
+    if (GetStreamStatistics(stats) != SUCCESS) {
+        return ERR_OPERATION_FAILED;
+    }
+    stats.bytesDropped = ToAppBytes(stats.bytesDropped);
+
+    return SUCCESS;
+}
+
 vector<AudioSampleFormat> AudioStream::GetSupportedFormats() const
 {
     return AUDIO_SUPPORTED_FORMATS;
@@ -271,6 +279,9 @@ int32_t AudioStream::GetAudioStreamInfo(AudioStreamParams &audioStreamInfo)
     if (GetAudioStreamParams(audioStreamInfo) != 0) {
         return ERR_OPERATION_FAILED;
     }
+    if (formatConverter_ != nullptr) {
+        audioStreamInfo.format = appFormat_;
+    }
 
     return SUCCESS;
 }
@@ -324,19 +335,39 @@ int32_t AudioStream::SetAudioStreamInfo(const AudioStreamParams info,
         AUDIO_DEBUG_LOG("AudioStream: Error initializing!");
         return ret;
     }
-    if (CreateStream(info, eStreamType_) != SUCCESS) {
+    AudioStreamParams streamInfo = info;
+    streamInfo.format = GetStreamFormat(static_cast<AudioSampleFormat>(info.format));
+    if (CreateStream(streamInfo, eStreamType_) != SUCCESS) {
         AUDIO_ERR_LOG("AudioStream:Create stream failed");
         return ERROR;
     }
+    appFormat_ = static_cast<AudioSampleFormat>(info.format);
+    streamFormat_ = static_cast<AudioSampleFormat>(streamInfo.format);
+    formatConverter_ = nullptr;
+    if (appFormat_ != streamFormat_) {
+        AUDIO_INFO_LOG("AudioStream: converting format %{public}d to stream format %{public}d", appFormat_,
+            streamFormat_);
+        formatConverter_ = std::make_unique<AudioFormatConverter>();
+        // Only playback narrows the samples, capture widens them and has no rounding error to spread
+        formatConverter_->SetDitherEnabled(eMode_ == AUDIO_MODE_PLAYBACK);
+    }
     state_ = PREPARED;
     AUDIO_INFO_LOG("AudioStream:Set stream Info SUCCESS");
 
+    // Pooled streams have no client yet and are registered once claimed
+    if (proxyObj != nullptr) {
+        RegisterClientTracker(proxyObj);
+    }
+    return SUCCESS;
+}
+
+void AudioStream::RegisterClientTracker(const std::shared_ptr<AudioClientTracker> &proxyObj)
+{
     if (audioStreamTracker_) {
         (void)GetSessionID(sessionId_);
         AUDIO_DEBUG_LOG("AudioStream:Calling register tracker, sessionid = %{public}d", sessionId_);
         audioStreamTracker_->RegisterTracker(sessionId_, state_, rendererInfo_, capturerInfo_, proxyObj);
     }
-    return SUCCESS;
 }
 
 bool AudioStream::StartAudioStream()
@@ -346,6 +377,10 @@ bool AudioStream::StartAudioStream()
         return false;
     }
 
+    // An asynchronous pause or stop leaves the buffer threads to exit on their own, reap them before starting anew
+    StopBufferThread(isReadyToWrite_, writeThread_);
+    StopBufferThread(isReadyToRead_, readThread_);
+
     int32_t ret = StartStream();
     if (ret != SUCCESS) {
         AUDIO_ERR_LOG("StartStream Start failed:%{public}d", ret);
@@ -399,8 +434,8 @@ int32_t AudioStream::Read(uint8_t &buffer, size_t userSize, bool isBlockingRead)
     stream.buffer = &buffer;
     stream.bufferLen = userSize;
     isReadInProgress_ = true;
-    int32_t readLen = ReadStream(stream, isBlockingRead);
-    isReadInProgress_ = false;
+    int32_t readLen = ReadInAppFormat(stream, isBlockingRead);
+    EndIo(isReadInProgress_);
     if (readLen < 0) {
         AUDIO_ERR_LOG("ReadStream fail,ret:%{public}d", readLen);
         return ERR_INVALID_READ;
@@ -409,6 +444,59 @@ int32_t AudioStream::Read(uint8_t &buffer, size_t userSize, bool isBlockingRead)
     return readLen;
 }
 
+int32_t AudioStream::AcquireReadBuffer(BufferDesc &bufDesc)
+{
+    if (captureMode_ == CAPTURE_MODE_CALLBACK) {
+        AUDIO_ERR_LOG("AudioStream::AcquireReadBuffer not supported. CaptureMode is callback");
+        return ERR_INCORRECT_MODE;
+    }
+
+    if (state_ != RUNNING) {
+        AUDIO_ERR_LOG("AcquireReadBuffer: Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
+    }
+
+    if (formatConverter_ != nullptr) {
+        AUDIO_ERR_LOG("AcquireReadBuffer: not supported when format %{public}d is converted", appFormat_);
+        return ERR_NOT_SUPPORTED;
+    }
+
+    if (isFirstRead_) {
+        FlushAudioStream();
+        isFirstRead_ = false;
+    }
+
+    StreamBuffer stream;
+    isReadInProgress_ = true;
+    int32_t ret = AcquireReadStreamBuffer(stream);
+    EndIo(isReadInProgress_);
+    if (ret != 0) {
+        AUDIO_ERR_LOG("AcquireReadStreamBuffer fail, ret:%{public}d", ret);
+        bufDesc.buffer = nullptr;
+        return ERR_INVALID_READ;
+    }
+
+    bufDesc.buffer = stream.buffer;
+    bufDesc.bufLength = stream.bufferLen;
+    bufDesc.dataLength = stream.bufferLen;
+    return SUCCESS;
+}
+
+int32_t AudioStream::ReleaseReadBuffer()
+{
+    if (captureMode_ == CAPTURE_MODE_CALLBACK) {
+        AUDIO_ERR_LOG("AudioStream::ReleaseReadBuffer not supported. CaptureMode is callback");
+        return ERR_INCORRECT_MODE;
+    }
+
+    int32_t ret = ReleaseReadStreamBuffer();
+    if (ret != 0) {
+        AUDIO_ERR_LOG("ReleaseReadStreamBuffer fail, ret:%{public}d", ret);
+        return ERR_OPERATION_FAILED;
+    }
+    return SUCCESS;
+}
+
 size_t AudioStream::Write(uint8_t *buffer, size_t buffer_size)
 {
     if (renderMode_ == RENDER_MODE_CALLBACK) {
@@ -432,50 +520,90 @@ size_t AudioStream::Write(uint8_t *buffer, size_t buffer_size)
     StreamBuffer stream;
     stream.buffer = buffer;
     stream.bufferLen = buffer_size;
+    if (ConvertToStreamFormat(stream) != SUCCESS) {
+        return ERR_WRITE_FAILED;
+    }
     isWriteInProgress_ = true;
 
     if (isFirstWrite_) {
         if (RenderPrebuf(stream.bufferLen)) {
+            EndIo(isWriteInProgress_);
             return ERR_WRITE_FAILED;
         }
         isFirstWrite_ = false;
     }
 
     size_t bytesWritten = WriteStream(stream, writeError);
-    isWriteInProgress_ = false;
+    EndIo(isWriteInProgress_);
     if (writeError != 0) {
         AUDIO_ERR_LOG("WriteStream fail,writeError:%{public}d", writeError);
         return ERR_WRITE_FAILED;
     }
-    return bytesWritten;
+    return ToAppBytes(bytesWritten);
 }
 
-bool AudioStream::PauseAudioStream()
+int32_t AudioStream::AcquireWriteBuffer(BufferDesc &bufDesc)
 {
+    if (renderMode_ == RENDER_MODE_CALLBACK) {
+        AUDIO_ERR_LOG("AudioStream::AcquireWriteBuffer not supported. RenderMode is callback");
+        return ERR_INCORRECT_MODE;
+    }
+
     if (state_ != RUNNING) {
-        AUDIO_ERR_LOG("PauseAudioStream: State is not RUNNING. Illegal state:%{public}u", state_);
-        return false;
+        AUDIO_ERR_LOG("AcquireWriteBuffer: Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
     }
-    State oldState = state_;
-    state_ = PAUSED; // Set it before stopping as Read/Write and Stop can be called from different threads
-    if (captureMode_ == CAPTURE_MODE_CALLBACK) {
-        isReadyToRead_ = false;
-        if (readThread_ && readThread_->joinable()) {
-            readThread_->join();
+
+    if (formatConverter_ != nullptr) {
+        AUDIO_ERR_LOG("AcquireWriteBuffer: not supported when format %{public}d is converted", appFormat_);
+        return ERR_NOT_SUPPORTED;
+    }
+
+    if (isFirstWrite_) {
+        size_t minBufferSize = 0;
+        if ((GetMinimumBufferSize(minBufferSize) != 0) || RenderPrebuf(minBufferSize)) {
+            return ERR_WRITE_FAILED;
         }
+        isFirstWrite_ = false;
     }
 
-    // Ends the WriteBuffers thread
+    StreamBuffer stream;
+    if (AcquireWriteStreamBuffer(stream) != 0) {
+        AUDIO_ERR_LOG("AcquireWriteStreamBuffer fail");
+        bufDesc.buffer = nullptr;
+        return ERR_OPERATION_FAILED;
+    }
+
+    bufDesc.buffer = stream.buffer;
+    bufDesc.bufLength = stream.bufferLen;
+    bufDesc.dataLength = 0;
+    return SUCCESS;
+}
+
+int32_t AudioStream::CommitWriteBuffer(size_t length)
+{
     if (renderMode_ == RENDER_MODE_CALLBACK) {
-        isReadyToWrite_ = false;
-        if (writeThread_ && writeThread_->joinable()) {
-            writeThread_->join();
-        }
+        AUDIO_ERR_LOG("AudioStream::CommitWriteBuffer not supported. RenderMode is callback");
+        return ERR_INCORRECT_MODE;
+    }
+
+    int32_t ret = CommitWriteStreamBuffer(length);
+    if (ret != 0) {
+        AUDIO_ERR_LOG("CommitWriteStreamBuffer fail, ret:%{public}d", ret);
+        return ERR_WRITE_FAILED;
     }
+    return SUCCESS;
+}
 
-    while (isReadInProgress_ || isWriteInProgress_) {
-        std::this_thread::sleep_for(std::chrono::microseconds(READ_WRITE_WAIT_TIME_IN_US));
+bool AudioStream::PauseAudioStream()
+{
+    if (state_ != RUNNING) {
+        AUDIO_ERR_LOG("PauseAudioStream: State is not RUNNING. Illegal state:%{public}u", state_);
+        return false;
     }
+    State oldState = state_;
+    state_ = PAUSED; // Set it before stopping as Read/Write and Stop can be called from different threads
+    StopDataPath();
 
     int32_t ret = PauseStream();
     if (ret != SUCCESS) {
@@ -508,39 +636,139 @@ bool AudioStream::StopAudioStream()
     }
     State oldState = state_;
     state_ = STOPPED; // Set it before stopping as Read/Write and Stop can be called from different threads
+    StopDataPath();
+
+    int32_t ret = StopStream();
+    if (ret != SUCCESS) {
+        AUDIO_DEBUG_LOG("StreamStop fail,ret:%{public}d", ret);
+        state_ = oldState;
+        return false;
+    }
+
+    AUDIO_INFO_LOG("StopAudioStream SUCCESS");
+
+    if (audioStreamTracker_) {
+        AUDIO_DEBUG_LOG("AudioStream:Calling Update tracker for stop");
+        audioStreamTracker_->UpdateTracker(sessionId_, state_, rendererInfo_, capturerInfo_);
+    }
+    return true;
+}
+
+void AudioStream::EndIo(std::atomic<bool> &isInProgress)
+{
+    {
+        // Pairs with the predicate check in StopDataPath so the wakeup cannot be lost
+        std::lock_guard<std::mutex> lock(ioMutex_);
+        isInProgress = false;
+    }
+    ioIdleCond_.notify_all();
+}
+
+void AudioStream::StopDataPath()
+{
     if (captureMode_ == CAPTURE_MODE_CALLBACK) {
-        isReadyToRead_ = false;
-        if (readThread_ && readThread_->joinable()) {
-            readThread_->join();
-        }
+        StopBufferThread(isReadyToRead_, readThread_);
     }
 
     // Ends the WriteBuffers thread
     if (renderMode_ == RENDER_MODE_CALLBACK) {
-        isReadyToWrite_ = false;
-        if (writeThread_ && writeThread_->joinable()) {
-            writeThread_->join();
-        }
+        StopBufferThread(isReadyToWrite_, writeThread_);
     }
 
-    while (isReadInProgress_ || isWriteInProgress_) {
-        std::this_thread::sleep_for(std::chrono::microseconds(READ_WRITE_WAIT_TIME_IN_US));
+    std::unique_lock<std::mutex> lock(ioMutex_);
+    ioIdleCond_.wait(lock, [this] { return !isReadInProgress_ && !isWriteInProgress_; });
+}
+
+void AudioStream::SignalDataPathStop()
+{
+    // Only wakes the buffer threads, they see the new state and exit; StartAudioStream or the destructor joins them
+    isReadyToRead_ = false;
+    isReadyToWrite_ = false;
+    NotifyBufferQueue();
+}
+
+int32_t AudioStream::PauseAudioStreamAsync(const StreamOperationCallback &callback)
+{
+    if (state_ != RUNNING) {
+        AUDIO_ERR_LOG("PauseAudioStreamAsync: State is not RUNNING. Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
     }
+    State oldState = state_;
+    state_ = PAUSED; // Set it before stopping as Read/Write and Stop can be called from different threads
+    SignalDataPathStop();
 
-    int32_t ret = StopStream();
+    int32_t ret = PauseStreamAsync(callback);
     if (ret != SUCCESS) {
-        AUDIO_DEBUG_LOG("StreamStop fail,ret:%{public}d", ret);
+        AUDIO_ERR_LOG("PauseStreamAsync fail, ret:%{public}d", ret);
         state_ = oldState;
-        return false;
+        return ERR_OPERATION_FAILED;
     }
 
-    AUDIO_INFO_LOG("StopAudioStream SUCCESS");
+    // Reported right away, like the state itself; a failed cork is only seen by the callback
+    if (audioStreamTracker_) {
+        audioStreamTracker_->UpdateTracker(sessionId_, state_, rendererInfo_, capturerInfo_);
+    }
+    return SUCCESS;
+}
+
+int32_t AudioStream::StopAudioStreamAsync(const StreamOperationCallback &callback)
+{
+    if (state_ == PAUSED) {
+        // Already corked, complete the same way as an issued operation
+        state_ = STOPPED;
+        if (callback) {
+            AudioCallbackExecutor::GetInstance().PostReliable([callback] { callback(true); });
+        }
+        return SUCCESS;
+    }
+
+    if (state_ != RUNNING) {
+        AUDIO_ERR_LOG("StopAudioStreamAsync: State is not RUNNING. Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
+    }
+    State oldState = state_;
+    state_ = STOPPED; // Set it before stopping as Read/Write and Stop can be called from different threads
+    SignalDataPathStop();
+
+    int32_t ret = StopStreamAsync(callback);
+    if (ret != SUCCESS) {
+        AUDIO_ERR_LOG("StopStreamAsync fail, ret:%{public}d", ret);
+        state_ = oldState;
+        return ERR_OPERATION_FAILED;
+    }
 
     if (audioStreamTracker_) {
-        AUDIO_DEBUG_LOG("AudioStream:Calling Update tracker for stop");
         audioStreamTracker_->UpdateTracker(sessionId_, state_, rendererInfo_, capturerInfo_);
     }
-    return true;
+    return SUCCESS;
+}
+
+int32_t AudioStream::FlushAudioStreamAsync(const StreamOperationCallback &callback)
+{
+    if ((state_ != RUNNING) && (state_ != PAUSED) && (state_ != STOPPED)) {
+        AUDIO_ERR_LOG("FlushAudioStreamAsync: State is not RUNNING. Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
+    }
+
+    if (FlushStreamAsync(callback) != SUCCESS) {
+        AUDIO_ERR_LOG("FlushStreamAsync fail");
+        return ERR_OPERATION_FAILED;
+    }
+    return SUCCESS;
+}
+
+int32_t AudioStream::DrainAudioStreamAsync(const StreamOperationCallback &callback)
+{
+    if (state_ != RUNNING) {
+        AUDIO_ERR_LOG("DrainAudioStreamAsync: State is not RUNNING. Illegal state:%{public}u", state_);
+        return ERR_ILLEGAL_STATE;
+    }
+
+    if (DrainStreamAsync(callback) != SUCCESS) {
+        AUDIO_ERR_LOG("DrainStreamAsync fail");
+        return ERR_OPERATION_FAILED;
+    }
+    return SUCCESS;
 }
 
 bool AudioStream::FlushAudioStream()
@@ -614,6 +842,13 @@ AudioStreamType AudioStream::GetStreamType(ContentType contentType, StreamUsage
     return streamType;
 }
 
+bool AudioStream::IsDeepBufferStream(const AudioRendererInfo &rendererInfo)
+{
+    // Opt-in only, deep buffering trades start and seek latency for power, which only the app can judge
+    uint32_t flags = static_cast<uint32_t>(rendererInfo.rendererFlags);
+    return ((flags & RENDERER_FLAG_DEEP_BUFFER) != 0) && ((flags & RENDERER_FLAG_LOW_LATENCY) == 0);
+}
+
 int32_t AudioStream::SetAudioStreamType(AudioStreamType audioStreamType)
 {
     return SetStreamType(audioStreamType);
@@ -660,9 +895,10 @@ int32_t AudioStream::SetRenderMode(AudioRenderMode renderMode)
     }
     renderMode_ = renderMode;
 
+    ClearBufferQueues();
     for (int32_t i = 0; i < MAX_NUM_BUFFERS; ++i) {
         size_t length;
-        GetMinimumBufferSize(length);
+        GetBufferSize(length);
         AUDIO_INFO_LOG("AudioServiceClient:: GetMinimumBufferSize: %{public}zu", length);
 
         bufferPool_[i] = std::make_unique<uint8_t[]>(length);
@@ -674,7 +910,7 @@ int32_t AudioStream::SetRenderMode(AudioRenderMode renderMode)
         BufferDesc bufDesc {};
         bufDesc.buffer = bufferPool_[i].get();
         bufDesc.bufLength = length;
-        freeBufferQ_.emplace(bufDesc);
+        freeBufferQ_.Push(bufDesc);
     }
 
     return SUCCESS;
@@ -694,9 +930,10 @@ int32_t AudioStream::SetCaptureMode(AudioCaptureMode captureMode)
     }
     captureMode_ = captureMode;
 
+    ClearBufferQueues();
     for (int32_t i = 0; i < MAX_NUM_BUFFERS; ++i) {
         size_t length;
-        GetMinimumBufferSize(length);
+        GetBufferSize(length);
         AUDIO_INFO_LOG("AudioStream::SetCaptureMode: length %{public}zu", length);
 
         bufferPool_[i] = std::make_unique<uint8_t[]>(length);
@@ -708,7 +945,7 @@ int32_t AudioStream::SetCaptureMode(AudioCaptureMode captureMode)
         BufferDesc bufDesc {};
         bufDesc.buffer = bufferPool_[i].get();
         bufDesc.bufLength = length;
-        freeBufferQ_.emplace(bufDesc);
+        freeBufferQ_.Push(bufDesc);
     }
 
     return SUCCESS;
@@ -758,30 +995,29 @@ int32_t AudioStream::GetBufferDesc(BufferDesc &bufDesc)
         return ERR_INCORRECT_MODE;
     }
 
-    AUDIO_INFO_LOG("AudioStream::freeBufferQ_ count %{public}zu", freeBufferQ_.size());
-    AUDIO_INFO_LOG("AudioStream::filledBufferQ_ count %{public}zu", filledBufferQ_.size());
+    AUDIO_DEBUG_LOG("AudioStream::freeBufferQ_ count %{public}zu", freeBufferQ_.GetSize());
+    AUDIO_DEBUG_LOG("AudioStream::filledBufferQ_ count %{public}zu", filledBufferQ_.GetSize());
 
+    BufferDesc queuedBufDesc {};
     if (renderMode_ == RENDER_MODE_CALLBACK) {
-        if (!freeBufferQ_.empty()) {
-            bufDesc.buffer = freeBufferQ_.front().buffer;
-            bufDesc.bufLength = freeBufferQ_.front().bufLength;
-            freeBufferQ_.pop();
+        if (freeBufferQ_.Pop(queuedBufDesc)) {
+            bufDesc.buffer = queuedBufDesc.buffer;
+            bufDesc.bufLength = queuedBufDesc.bufLength;
         } else {
             bufDesc.buffer = nullptr;
-            AUDIO_INFO_LOG("AudioStream::GetBufferDesc freeBufferQ_.empty()");
+            AUDIO_INFO_LOG("AudioStream::GetBufferDesc freeBufferQ_ is empty");
             return ERR_OPERATION_FAILED;
         }
     }
 
     if (captureMode_ == CAPTURE_MODE_CALLBACK) {
-        if (!filledBufferQ_.empty()) {
-            bufDesc.buffer = filledBufferQ_.front().buffer;
-            bufDesc.bufLength = filledBufferQ_.front().bufLength;
-            bufDesc.dataLength = filledBufferQ_.front().dataLength;
-            filledBufferQ_.pop();
+        if (filledBufferQ_.Pop(queuedBufDesc)) {
+            bufDesc.buffer = queuedBufDesc.buffer;
+            bufDesc.bufLength = queuedBufDesc.bufLength;
+            bufDesc.dataLength = queuedBufDesc.dataLength;
         } else {
             bufDesc.buffer = nullptr;
-            AUDIO_INFO_LOG("AudioStream::GetBufferDesc filledBufferQ_.empty()");
+            AUDIO_INFO_LOG("AudioStream::GetBufferDesc filledBufferQ_ is empty");
             return ERR_OPERATION_FAILED;
         }
     }
@@ -796,11 +1032,11 @@ int32_t AudioStream::GetBufQueueState(BufferQueueState &bufState)
     }
 
     if (renderMode_ == RENDER_MODE_CALLBACK) {
-        bufState.numBuffers = filledBufferQ_.size();
+        bufState.numBuffers = filledBufferQ_.GetSize();
     }
 
     if (captureMode_ == CAPTURE_MODE_CALLBACK) {
-        bufState.numBuffers = freeBufferQ_.size();
+        bufState.numBuffers = freeBufferQ_.GetSize();
     }
 
     return SUCCESS;
@@ -820,15 +1056,22 @@ int32_t AudioStream::Enqueue(const BufferDesc &bufDesc)
     }
 
     if (renderMode_ == RENDER_MODE_CALLBACK) {
-        AUDIO_INFO_LOG("AudioStream::Enqueue: filledBuffer length: %{public}zu.", bufDesc.bufLength);
-        filledBufferQ_.emplace(bufDesc);
+        AUDIO_DEBUG_LOG("AudioStream::Enqueue: filledBuffer length: %{public}zu.", bufDesc.bufLength);
+        if (!filledBufferQ_.Push(bufDesc)) {
+            AUDIO_ERR_LOG("AudioStream::Enqueue: failed. filledBufferQ_ is full.");
+            return ERR_OPERATION_FAILED;
+        }
     }
 
     if (captureMode_ == CAPTURE_MODE_CALLBACK) {
-        AUDIO_INFO_LOG("AudioStream::Enqueue: freeBuffer length: %{public}zu.", bufDesc.bufLength);
-        freeBufferQ_.emplace(bufDesc);
+        AUDIO_DEBUG_LOG("AudioStream::Enqueue: freeBuffer length: %{public}zu.", bufDesc.bufLength);
+        if (!freeBufferQ_.Push(bufDesc)) {
+            AUDIO_ERR_LOG("AudioStream::Enqueue: failed. freeBufferQ_ is full.");
+            return ERR_OPERATION_FAILED;
+        }
     }
 
+    NotifyBufferQueue();
     return SUCCESS;
 }
 
@@ -839,46 +1082,183 @@ int32_t AudioStream::Clear()
         return ERR_INCORRECT_MODE;
     }
 
-    while (!filledBufferQ_.empty()) {
-        freeBufferQ_.emplace(filledBufferQ_.front());
-        filledBufferQ_.pop();
+    BufferDesc bufDesc {};
+    while (filledBufferQ_.Pop(bufDesc)) {
+        freeBufferQ_.Push(bufDesc);
+    }
+
+    return SUCCESS;
+}
+
+AudioSampleFormat AudioStream::GetStreamFormat(AudioSampleFormat appFormat)
+{
+    // Float is carried as S16LE, the format the HDI sinks and sources run at, so the server does not convert again.
+    // This quantizes to 16 bits and clips outside [-1.0, 1.0], playback dithers to hide the truncation.
+    return (appFormat == SAMPLE_F32LE) ? SAMPLE_S16LE : appFormat;
+}
+
+size_t AudioStream::ToAppBytes(size_t streamBytes) const
+{
+    if (formatConverter_ == nullptr) {
+        return streamBytes;
+    }
+    return (streamBytes / AudioFormatConverter::GetSampleSize(streamFormat_)) *
+        AudioFormatConverter::GetSampleSize(appFormat_);
+}
+
+int32_t AudioStream::ConvertToStreamFormat(StreamBuffer &stream)
+{
+    if (formatConverter_ == nullptr) {
+        return SUCCESS;
+    }
+
+    size_t sampleCount = stream.bufferLen / AudioFormatConverter::GetSampleSize(appFormat_);
+    size_t streamLen = sampleCount * AudioFormatConverter::GetSampleSize(streamFormat_);
+    if (convertBuffer_.size() < streamLen) {
+        convertBuffer_.resize(streamLen);
+    }
+
+    int32_t ret = formatConverter_->Convert(stream.buffer, appFormat_, convertBuffer_.data(), streamFormat_,
+        sampleCount);
+    if (ret != SUCCESS) {
+        AUDIO_ERR_LOG("AudioStream::ConvertToStreamFormat failed: %{public}d", ret);
+        return ret;
     }
 
+    stream.buffer = convertBuffer_.data();
+    stream.bufferLen = streamLen;
     return SUCCESS;
 }
 
+int32_t AudioStream::ReadInAppFormat(StreamBuffer &stream, bool isBlockingRead)
+{
+    if (formatConverter_ == nullptr) {
+        return ReadStream(stream, isBlockingRead);
+    }
+
+    uint8_t *appBuffer = stream.buffer;
+    size_t sampleCount = stream.bufferLen / AudioFormatConverter::GetSampleSize(appFormat_);
+    size_t streamLen = sampleCount * AudioFormatConverter::GetSampleSize(streamFormat_);
+    if (convertBuffer_.size() < streamLen) {
+        convertBuffer_.resize(streamLen);
+    }
+
+    StreamBuffer readBuffer;
+    readBuffer.buffer = convertBuffer_.data();
+    readBuffer.bufferLen = streamLen;
+    int32_t readLen = ReadStream(readBuffer, isBlockingRead);
+    if (readLen <= 0) {
+        return readLen;
+    }
+
+    sampleCount = static_cast<size_t>(readLen) / AudioFormatConverter::GetSampleSize(streamFormat_);
+    int32_t ret = formatConverter_->Convert(convertBuffer_.data(), streamFormat_, appBuffer, appFormat_,
+        sampleCount);
+    if (ret != SUCCESS) {
+        AUDIO_ERR_LOG("AudioStream::ReadInAppFormat convert failed: %{public}d", ret);
+        return ret;
+    }
+    return static_cast<int32_t>(ToAppBytes(readLen));
+}
+
+void AudioStream::ClearBufferQueues()
+{
+    BufferDesc bufDesc {};
+    while (freeBufferQ_.Pop(bufDesc)) {}
+    while (filledBufferQ_.Pop(bufDesc)) {}
+}
+
+void AudioStream::NotifyBufferQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(bufferQueueMutex_);
+    }
+    bufferQueueCond_.notify_all();
+}
+
+bool AudioStream::WaitForBuffers(const AudioBufferQueue &bufferQ, const std::atomic<bool> &isReady)
+{
+    std::unique_lock<std::mutex> lock(bufferQueueMutex_);
+    bufferQueueCond_.wait(lock, [&bufferQ, &isReady] { return !isReady || !bufferQ.IsEmpty(); });
+    return isReady;
+}
+
+// Sleeps for delayMs unless the worker is stopped first, and doubles delayMs for the next failure
+bool AudioStream::WaitForRetry(const std::atomic<bool> &isReady, uint32_t &delayMs)
+{
+    std::unique_lock<std::mutex> lock(bufferQueueMutex_);
+    bufferQueueCond_.wait_for(lock, std::chrono::milliseconds(delayMs), [&isReady] { return !isReady; });
+    delayMs = std::min(delayMs * 2, IO_RETRY_MAX_DELAY_MS);
+    return isReady;
+}
+
+void AudioStream::StopBufferThread(std::atomic<bool> &isReady, std::unique_ptr<std::thread> &bufferThread)
+{
+    isReady = false;
+    NotifyBufferQueue();
+    if (bufferThread && bufferThread->joinable()) {
+        bufferThread->join();
+    }
+}
+
 void AudioStream::WriteBuffers()
 {
     AUDIO_INFO_LOG("AudioStream::WriteBuffers thread start");
     StreamBuffer stream;
+    BufferDesc bufDesc {};
     size_t bytesWritten;
     int32_t writeError;
+    uint32_t retryDelayMs = IO_RETRY_MIN_DELAY_MS;
+
+    // Sleeps until the app enqueues a buffer, WriteStreamInCb then blocks until PA requests data
+    while (WaitForBuffers(filledBufferQ_, isReadyToWrite_)) {
+        if (state_ != RUNNING) {
+            AUDIO_ERR_LOG("Write: Illegal  state:%{public}u", state_);
+            isReadyToWrite_ = false;
+            return;
+        }
+        if (!filledBufferQ_.Pop(bufDesc)) {
+            continue; // Taken back by Clear
+        }
 
-    while (isReadyToWrite_) {
-        while (!filledBufferQ_.empty()) {
-            if (state_ != RUNNING) {
-                AUDIO_ERR_LOG("Write: Illegal  state:%{public}u", state_);
-                isReadyToWrite_ = false;
-                return;
-            }
-            AUDIO_DEBUG_LOG("AudioStream::WriteBuffers !filledBufferQ_.empty()");
-            stream.buffer = filledBufferQ_.front().buffer;
-            stream.bufferLen = filledBufferQ_.front().dataLength;
-            AUDIO_DEBUG_LOG("AudioStream::WriteBuffers stream.bufferLen:%{public}d", stream.bufferLen);
-            if (stream.buffer == nullptr) {
-                AUDIO_ERR_LOG("AudioStream::WriteBuffers stream.buffer == nullptr return");
-                return;
-            }
+        stream.buffer = bufDesc.buffer;
+        stream.bufferLen = bufDesc.dataLength;
+        AUDIO_DEBUG_LOG("AudioStream::WriteBuffers stream.bufferLen:%{public}d", stream.bufferLen);
+        if (stream.buffer == nullptr) {
+            AUDIO_ERR_LOG("AudioStream::WriteBuffers stream.buffer == nullptr return");
+            return;
+        }
+        if (ConvertToStreamFormat(stream) != SUCCESS) {
+            freeBufferQ_.Push(bufDesc);
+            continue;
+        }
+        // Keeps the buffer until all of it is written so a transient failure does not drop audio
+        uint32_t retries = 0;
+        while (stream.bufferLen > 0) {
             bytesWritten = WriteStreamInCb(stream, writeError);
-            if (writeError != 0) {
-                AUDIO_ERR_LOG("AudioStream::WriteStreamInCb fail, writeError:%{public}d", writeError);
-            } else {
-                AUDIO_INFO_LOG("AudioStream::WriteBuffers WriteStream, bytesWritten:%{public}zu", bytesWritten);
-                freeBufferQ_.emplace(filledBufferQ_.front());
-                filledBufferQ_.pop();
+            stream.buffer += bytesWritten;
+            stream.bufferLen -= bytesWritten;
+            if (writeError == 0) {
+                AUDIO_DEBUG_LOG("AudioStream::WriteBuffers WriteStream, bytesWritten:%{public}zu", bytesWritten);
+                retryDelayMs = IO_RETRY_MIN_DELAY_MS;
+                if (bytesWritten == 0) {
+                    break; // Corked by an asynchronous pause or stop, the rest of the buffer is dropped
+                }
+                continue;
             }
+            AUDIO_ERR_LOG("AudioStream::WriteStreamInCb fail, writeError:%{public}d", writeError);
+            ReportWriteError(writeError);
+            if (++retries > MAX_WRITE_RETRIES || !IsStreamUsable() || state_ != RUNNING ||
+                !WaitForRetry(isReadyToWrite_, retryDelayMs)) {
+                break;
+            }
+        }
+        freeBufferQ_.Push(bufDesc);
+        if (stream.bufferLen > 0 && !IsStreamUsable()) {
+            AUDIO_ERR_LOG("AudioStream::WriteBuffers stream is dead, stop writing");
+            isReadyToWrite_ = false;
+            break;
         }
-        std::this_thread::sleep_for(std::chrono::microseconds(CB_WRITE_BUFFERS_WAIT_IN_US));
     }
     AUDIO_INFO_LOG("AudioStream::WriteBuffers thread end");
 }
@@ -887,35 +1267,47 @@ void AudioStream::ReadBuffers()
 {
     AUDIO_INFO_LOG("AudioStream::ReadBuffers thread start");
     StreamBuffer stream;
+    BufferDesc bufDesc {};
     int32_t readLen;
     bool isBlockingRead = true;
+    uint32_t retryDelayMs = IO_RETRY_MIN_DELAY_MS;
+
+    // Sleeps until the app enqueues a free buffer, ReadStream then blocks until PA has data
+    while (WaitForBuffers(freeBufferQ_, isReadyToRead_)) {
+        if (state_ != RUNNING) {
+            AUDIO_ERR_LOG("AudioStream::ReadBuffers Read: Illegal  state:%{public}u", state_);
+            isReadyToRead_ = false;
+            return;
+        }
+        if (!freeBufferQ_.Pop(bufDesc)) {
+            continue;
+        }
 
-    while (isReadyToRead_) {
-        while (!freeBufferQ_.empty()) {
-            if (state_ != RUNNING) {
-                AUDIO_ERR_LOG("AudioStream::ReadBuffers Read: Illegal  state:%{public}u", state_);
+        stream.buffer = bufDesc.buffer;
+        stream.bufferLen = bufDesc.bufLength;
+        AUDIO_DEBUG_LOG("AudioStream::ReadBuffers requested stream.bufferLen:%{public}d", stream.bufferLen);
+        if (stream.buffer == nullptr) {
+            AUDIO_ERR_LOG("AudioStream::ReadBuffers stream.buffer == nullptr return");
+            return;
+        }
+        readLen = ReadInAppFormat(stream, isBlockingRead);
+        if (readLen < 0) {
+            AUDIO_ERR_LOG("AudioStream::ReadBuffers ReadStream fail, ret: %{public}d", readLen);
+            freeBufferQ_.Push(bufDesc);
+            ReportReadError(readLen);
+            // A timeout or a failed peek may clear up, a failed stream never does
+            if (!IsStreamUsable()) {
+                AUDIO_ERR_LOG("AudioStream::ReadBuffers stream is dead, stop reading");
                 isReadyToRead_ = false;
-                return;
-            }
-            AUDIO_DEBUG_LOG("AudioStream::ReadBuffers !freeBufferQ_.empty()");
-            stream.buffer = freeBufferQ_.front().buffer;
-            stream.bufferLen = freeBufferQ_.front().bufLength;
-            AUDIO_DEBUG_LOG("AudioStream::ReadBuffers requested stream.bufferLen:%{public}d", stream.bufferLen);
-            if (stream.buffer == nullptr) {
-                AUDIO_ERR_LOG("AudioStream::ReadBuffers stream.buffer == nullptr return");
-                return;
-            }
-            readLen = ReadStream(stream, isBlockingRead);
-            if (readLen < 0) {
-                AUDIO_ERR_LOG("AudioStream::ReadBuffers ReadStream fail, ret: %{public}d", readLen);
-            } else {
-                AUDIO_INFO_LOG("AudioStream::ReadBuffers ReadStream, bytesRead:%{public}d", readLen);
-                freeBufferQ_.front().dataLength = readLen;
-                filledBufferQ_.emplace(freeBufferQ_.front());
-                freeBufferQ_.pop();
+                break;
             }
+            WaitForRetry(isReadyToRead_, retryDelayMs);
+            continue;
         }
-        std::this_thread::sleep_for(std::chrono::microseconds(CB_READ_BUFFERS_WAIT_IN_US));
+        retryDelayMs = IO_RETRY_MIN_DELAY_MS;
+        AUDIO_DEBUG_LOG("AudioStream::ReadBuffers ReadStream, bytesRead:%{public}d", readLen);
+        bufDesc.dataLength = readLen;
+        filledBufferQ_.Push(bufDesc);
     }
 
     AUDIO_INFO_LOG("AudioStream::ReadBuffers thread end");
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "audio_errors.h"
+#include "audio_log.h"
+
+#include "audio_stream_pool.h"
+
+namespace OHOS {
+namespace AudioStandard {
+namespace {
+// Wait before retrying a configuration whose stream could not be set up, e.g. while the server restarts
+const std::chrono::seconds REFILL_RETRY_INTERVAL(1);
+}
+
+AudioStreamPool &AudioStreamPool::GetInstance()
+{
+    static AudioStreamPool pool;
+    return pool;
+}
+
+AudioStreamPool::~AudioStreamPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        isRunning_ = false;
+    }
+    refillCond_.notify_one();
+    if (refillThread_.joinable()) {
+        refillThread_.join();
+    }
+}
+
+void AudioStreamPool::SetPoolSize(const AudioStreamPoolKey &key, uint32_t count)
+{
+    // Releasing a stream talks to the server, the surplus is destroyed after the lock is dropped
+    std::vector<std::shared_ptr<AudioStream>> released;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        if (count == 0) {
+            auto it = pool_.find(key);
+            if (it != pool_.end()) {
+                released.swap(it->second.streams);
+                pool_.erase(it);
+            }
+        } else {
+            PoolEntry &entry = pool_[key];
+            entry.targetSize = count;
+            while (entry.streams.size() > count) {
+                released.push_back(entry.streams.back());
+                entry.streams.pop_back();
+            }
+            if (!refillThread_.joinable()) {
+                refillThread_ = std::thread(&AudioStreamPool::RefillLoop, this);
+                pthread_setname_np(refillThread_.native_handle(), "OS_AudioPool");
+            }
+        }
+    }
+    refillCond_.notify_one();
+    AUDIO_INFO_LOG("AudioStreamPool: stream type %{public}d, rate %{public}u pool size %{public}u",
+        key.streamType, key.params.samplingRate, count);
+}
+
+std::shared_ptr<AudioStream> AudioStreamPool::Claim(const AudioStreamPoolKey &key)
+{
+    std::shared_ptr<AudioStream> stream = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        auto it = pool_.find(key);
+        if (it == pool_.end()) {
+            return nullptr;
+        }
+
+        std::vector<std::shared_ptr<AudioStream>> &streams = it->second.streams;
+        while (!streams.empty() && stream == nullptr) {
+            stream = streams.back();
+            streams.pop_back();
+            if (stream->GetState() != PREPARED) {
+                AUDIO_ERR_LOG("AudioStreamPool: dropping pooled stream in state %{public}d", stream->GetState());
+                stream = nullptr;
+            }
+        }
+
+        if (stream == nullptr) {
+            missCount_++;
+        } else {
+            hitCount_++;
+            setupTimeSavedUsec_ += (setupCount_ == 0) ? 0 : (setupTotalUsec_ / setupCount_);
+        }
+    }
+    refillCond_.notify_one();
+    return stream;
+}
+
+void AudioStreamPool::GetStats(AudioStreamPoolStats &stats)
+{
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    stats.hitCount = hitCount_;
+    stats.missCount = missCount_;
+    stats.avgSetupTimeUsec = (setupCount_ == 0) ? 0 : (setupTotalUsec_ / setupCount_);
+    stats.setupTimeSavedUsec = setupTimeSavedUsec_;
+    stats.pooledCount = 0;
+    for (auto &it : pool_) {
+        stats.pooledCount += it.second.streams.size();
+    }
+}
+
+// Called with poolMutex_ held
+bool AudioStreamPool::FindShortEntry(AudioStreamPoolKey &key)
+{
+    for (auto &it : pool_) {
+        if (it.second.streams.size() < it.second.targetSize) {
+            key = it.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioStreamPool::RefillLoop()
+{
+    AUDIO_INFO_LOG("AudioStreamPool: refill thread start");
+    std::unique_lock<std::mutex> lock(poolMutex_);
+    while (isRunning_) {
+        AudioStreamPoolKey key;
+        if (!FindShortEntry(key)) {
+            refillCond_.wait(lock);
+            continue;
+        }
+
+        // Stream setup takes several round trips to the server, Claim must not wait for it
+        lock.unlock();
+        auto startTime = std::chrono::steady_clock::now();
+        std::shared_ptr<AudioStream> stream = nullptr;
+        int32_t ret = CreatePooledStream(key, stream);
+        uint64_t setupUsec = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        lock.lock();
+
+        if (ret == ERR_NOT_SUPPORTED) {
+            // Retrying cannot help, stop pooling the configuration
+            pool_.erase(key);
+            continue;
+        }
+        if (ret != SUCCESS) {
+            refillCond_.wait_for(lock, REFILL_RETRY_INTERVAL, [this] { return !isRunning_; });
+            continue;
+        }
+
+        setupCount_++;
+        setupTotalUsec_ += setupUsec;
+        auto it = pool_.find(key);
+        if ((it != pool_.end()) && (it->second.streams.size() < it->second.targetSize)) {
+            it->second.streams.push_back(stream);
+        } else {
+            // The pool shrank meanwhile
+            lock.unlock();
+            stream = nullptr;
+            lock.lock();
+        }
+    }
+    AUDIO_INFO_LOG("AudioStreamPool: refill thread end");
+}
+
+int32_t AudioStreamPool::CreatePooledStream(const AudioStreamPoolKey &key, std::shared_ptr<AudioStream> &stream)
+{
+    int32_t appUid = static_cast<int32_t>(getuid());
+    auto newStream = std::make_shared<AudioStream>(key.streamType, AUDIO_MODE_PLAYBACK, appUid);
+    newStream->SetRendererInfo(key.rendererInfo);
+    newStream->SetClientID(getpid(), appUid);
+
+    // No client tracker yet, the renderer claiming the stream registers it
+    int32_t ret = newStream->SetAudioStreamInfo(key.params, nullptr);
+    if (ret != SUCCESS) {
+        AUDIO_ERR_LOG("AudioStreamPool: set up pooled stream failed: %{public}d", ret);
+        return ret;
+    }
+    stream = newStream;
+    return SUCCESS;
+}
+} // namespace AudioStandard
+} // namespace OHOS
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_CAPTURER_FILE_SOURCE_UNIT_TEST_H
+#define AUDIO_CAPTURER_FILE_SOURCE_UNIT_TEST_H
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "audio_capturer_file_source.h"
+
+namespace OHOS {
+namespace AudioStandard {
+class AudioCapturerFileSourceUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+    // Bytes that differ from their neighbours and from the headers, so a misplaced read shows up
+    static std::vector<char> CreatePcm(size_t size);
+    static bool WriteFile(const std::string &path, const std::vector<char> &content);
+    // WAV file with a fmt chunk, an odd sized chunk before the data and a chunk after it
+    static std::vector<char> CreateWav(const std::vector<char> &pcm, const FileSourceAttr &attr);
+    static FileSourceAttr CreateAttr(const std::string &path, bool isRealtime, uint32_t jitterUsec);
+};
+} // namespace AudioStandard
+} // namespace OHOS
+
+#endif // AUDIO_CAPTURER_FILE_SOURCE_UNIT_TEST_H
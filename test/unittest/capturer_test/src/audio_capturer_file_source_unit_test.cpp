@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_capturer_file_source_unit_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "audio_errors.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace AudioStandard {
+namespace {
+    const string RAW_TEST_FILE = "/data/audiocapture_file_source_test.pcm";
+    const string WAV_TEST_FILE = "/data/audiocapture_file_source_test.wav";
+    const string MISSING_TEST_FILE = "/data/audiocapture_file_source_missing.pcm";
+
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    constexpr uint32_t CHANNELS = 2;
+    constexpr uint32_t BITS_PER_SAMPLE = 16;
+    constexpr uint32_t BITS_PER_BYTE = 8;
+    constexpr size_t FRAME_SIZE = CHANNELS * BITS_PER_SAMPLE / BITS_PER_BYTE;
+    // Not a multiple of the frame size, the trailing partial frame is never served
+    constexpr size_t PCM_SIZE = 1001 * FRAME_SIZE + 3;
+    constexpr size_t SERVED_SIZE = PCM_SIZE - PCM_SIZE % FRAME_SIZE;
+    // Reads that are not a divisor of the data size cross the end at a different offset every time
+    constexpr size_t READ_SIZE = 333 * FRAME_SIZE;
+    constexpr size_t LOOP_COUNT = 3;
+    constexpr uint32_t PATTERN_PRIME = 251;
+
+    constexpr uint32_t RIFF_SIZE_OFFSET = 4;
+    constexpr uint32_t WAV_FMT_SIZE = 16;
+    constexpr uint16_t WAV_FORMAT_PCM = 1;
+    constexpr uint32_t ODD_CHUNK_SIZE = 5;
+    constexpr uint32_t BYTE_SHIFT = 8;
+
+    constexpr uint64_t USEC_PER_SEC = 1000000;
+    constexpr uint64_t BLOCK_USEC = 10000;
+    constexpr size_t BLOCK_SIZE = SAMPLE_RATE * BLOCK_USEC / USEC_PER_SEC * FRAME_SIZE;
+    constexpr size_t PACED_BLOCKS = 10;
+    constexpr uint32_t JITTER_USEC = 5000;
+    // Sleeps never end early, but the last due time is rounded down to a microsecond
+    constexpr uint64_t PACING_EARLY_USEC = 1000;
+    // Loose enough for a loaded test device, tight enough to catch reads paced twice
+    constexpr uint64_t PACING_LATE_USEC = 50000;
+
+    void PutLe16(vector<char> &out, uint16_t value)
+    {
+        out.push_back(static_cast<char>(value));
+        out.push_back(static_cast<char>(value >> BYTE_SHIFT));
+    }
+
+    void PutLe32(vector<char> &out, uint32_t value)
+    {
+        PutLe16(out, static_cast<uint16_t>(value));
+        PutLe16(out, static_cast<uint16_t>(value >> (BYTE_SHIFT * 2)));
+    }
+
+    void PutChunkHeader(vector<char> &out, const char *id, uint32_t size)
+    {
+        out.insert(out.end(), id, id + strlen(id));
+        PutLe32(out, size);
+    }
+
+    uint64_t GetElapsedUsec(chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now() - start).count());
+    }
+} // namespace
+
+void AudioCapturerFileSourceUnitTest::SetUpTestCase(void) {}
+void AudioCapturerFileSourceUnitTest::TearDownTestCase(void)
+{
+    remove(RAW_TEST_FILE.c_str());
+    remove(WAV_TEST_FILE.c_str());
+}
+void AudioCapturerFileSourceUnitTest::SetUp(void) {}
+void AudioCapturerFileSourceUnitTest::TearDown(void)
+{
+    AudioCapturerFileSource::GetInstance()->DeInit();
+}
+
+vector<char> AudioCapturerFileSourceUnitTest::CreatePcm(size_t size)
+{
+    vector<char> pcm(size);
+    for (size_t i = 0; i < size; i++) {
+        pcm[i] = static_cast<char>(i % PATTERN_PRIME);
+    }
+    return pcm;
+}
+
+bool AudioCapturerFileSourceUnitTest::WriteFile(const string &path, const vector<char> &content)
+{
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(content.data(), static_cast<streamsize>(content.size()));
+    return file.good();
+}
+
+vector<char> AudioCapturerFileSourceUnitTest::CreateWav(const vector<char> &pcm, const FileSourceAttr &attr)
+{
+    uint16_t frameSize = static_cast<uint16_t>(attr.channel * attr.bitsPerSample / BITS_PER_BYTE);
+    vector<char> wav;
+    PutChunkHeader(wav, "RIFF", 0);
+    wav.insert(wav.end(), {'W', 'A', 'V', 'E'});
+
+    PutChunkHeader(wav, "fmt ", WAV_FMT_SIZE);
+    PutLe16(wav, WAV_FORMAT_PCM);
+    PutLe16(wav, static_cast<uint16_t>(attr.channel));
+    PutLe32(wav, attr.sampleRate);
+    PutLe32(wav, attr.sampleRate * frameSize);
+    PutLe16(wav, frameSize);
+    PutLe16(wav, static_cast<uint16_t>(attr.bitsPerSample));
+
+    // Odd sized chunks are followed by a pad byte the parser has to skip
+    PutChunkHeader(wav, "LIST", ODD_CHUNK_SIZE);
+    wav.insert(wav.end(), ODD_CHUNK_SIZE + 1, 'x');
+
+    PutChunkHeader(wav, "data", static_cast<uint32_t>(pcm.size()));
+    wav.insert(wav.end(), pcm.begin(), pcm.end());
+    if (pcm.size() & 1) {
+        wav.push_back(0);
+    }
+
+    // Trailing metadata must not be served as audio
+    PutChunkHeader(wav, "id3 ", ODD_CHUNK_SIZE);
+    wav.insert(wav.end(), ODD_CHUNK_SIZE + 1, 'y');
+
+    uint32_t riffSize = static_cast<uint32_t>(wav.size() - RIFF_SIZE_OFFSET * 2);
+    for (uint32_t i = 0; i < RIFF_SIZE_OFFSET; i++) {
+        wav[RIFF_SIZE_OFFSET + i] = static_cast<char>(riffSize >> (BYTE_SHIFT * i));
+    }
+    return wav;
+}
+
+FileSourceAttr AudioCapturerFileSourceUnitTest::CreateAttr(const string &path, bool isRealtime, uint32_t jitterUsec)
+{
+    FileSourceAttr attr = {};
+    attr.filePath = path.c_str();
+    attr.sampleRate = SAMPLE_RATE;
+    attr.channel = CHANNELS;
+    attr.bitsPerSample = BITS_PER_SAMPLE;
+    attr.isRealtime = isRealtime;
+    attr.jitterUsec = jitterUsec;
+    return attr;
+}
+
+/**
+* @tc.name  : Test Init API with a WAV file.
+* @tc.number: Audio_Capturer_File_Source_Init_001
+* @tc.desc  : Test Init on a WAV file with chunks before and after the data chunk. CaptureFrame serves the data
+*           : chunk only, trimmed to whole frames.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_Init_001, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    FileSourceAttr attr = AudioCapturerFileSourceUnitTest::CreateAttr(WAV_TEST_FILE, false, 0);
+    vector<char> pcm = AudioCapturerFileSourceUnitTest::CreatePcm(PCM_SIZE);
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(WAV_TEST_FILE,
+        AudioCapturerFileSourceUnitTest::CreateWav(pcm, attr)));
+
+    ASSERT_EQ(SUCCESS, source->Init(attr));
+    EXPECT_EQ(SUCCESS, source->Start());
+
+    vector<char> frame(SERVED_SIZE * 2);
+    uint64_t replyBytes = 0;
+    EXPECT_EQ(SUCCESS, source->CaptureFrame(frame.data(), frame.size(), replyBytes));
+    EXPECT_EQ(frame.size(), replyBytes);
+    EXPECT_TRUE(equal(pcm.begin(), pcm.begin() + SERVED_SIZE, frame.begin()));
+    EXPECT_TRUE(equal(pcm.begin(), pcm.begin() + SERVED_SIZE, frame.begin() + SERVED_SIZE));
+}
+
+/**
+* @tc.name  : Test Init API with a raw PCM file.
+* @tc.number: Audio_Capturer_File_Source_Init_002
+* @tc.desc  : Test Init on a raw file whose size is not a multiple of the frame size. The trailing partial frame
+*           : is dropped, so reading past the end wraps at a frame boundary.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_Init_002, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    vector<char> pcm = AudioCapturerFileSourceUnitTest::CreatePcm(PCM_SIZE);
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(RAW_TEST_FILE, pcm));
+
+    ASSERT_EQ(SUCCESS, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(RAW_TEST_FILE, false, 0)));
+    EXPECT_EQ(SUCCESS, source->Start());
+
+    vector<char> frame(SERVED_SIZE + FRAME_SIZE);
+    uint64_t replyBytes = 0;
+    EXPECT_EQ(SUCCESS, source->CaptureFrame(frame.data(), frame.size(), replyBytes));
+    EXPECT_EQ(frame.size(), replyBytes);
+    EXPECT_TRUE(equal(pcm.begin(), pcm.begin() + SERVED_SIZE, frame.begin()));
+    EXPECT_TRUE(equal(pcm.begin(), pcm.begin() + FRAME_SIZE, frame.begin() + SERVED_SIZE));
+}
+
+/**
+* @tc.name  : Test Init API via illegal input.
+* @tc.number: Audio_Capturer_File_Source_Init_003
+* @tc.desc  : Test Init with a missing file and with a file shorter than a frame. Returns ERROR and CaptureFrame
+*           : fails afterwards.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_Init_003, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    EXPECT_EQ(ERROR, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(MISSING_TEST_FILE, false, 0)));
+
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(RAW_TEST_FILE,
+        AudioCapturerFileSourceUnitTest::CreatePcm(FRAME_SIZE - 1)));
+    EXPECT_EQ(ERROR, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(RAW_TEST_FILE, false, 0)));
+
+    char frame[FRAME_SIZE] = {};
+    uint64_t replyBytes = 0;
+    EXPECT_EQ(ERROR, source->CaptureFrame(frame, sizeof(frame), replyBytes));
+}
+
+/**
+* @tc.name  : Test CaptureFrame API across the end of the file.
+* @tc.number: Audio_Capturer_File_Source_CaptureFrame_001
+* @tc.desc  : Test CaptureFrame with reads that cross the end of the data at varying offsets. The data loops
+*           : without gaps or repeats.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_CaptureFrame_001, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    vector<char> pcm = AudioCapturerFileSourceUnitTest::CreatePcm(PCM_SIZE);
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(RAW_TEST_FILE, pcm));
+    ASSERT_EQ(SUCCESS, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(RAW_TEST_FILE, false, 0)));
+    EXPECT_EQ(SUCCESS, source->Start());
+
+    vector<char> frame(READ_SIZE);
+    size_t position = 0;
+    while (position < SERVED_SIZE * LOOP_COUNT) {
+        uint64_t replyBytes = 0;
+        ASSERT_EQ(SUCCESS, source->CaptureFrame(frame.data(), frame.size(), replyBytes));
+        ASSERT_EQ(frame.size(), replyBytes);
+        for (size_t i = 0; i < frame.size(); i++) {
+            ASSERT_EQ(pcm[(position + i) % SERVED_SIZE], frame[i]) << "byte " << position + i;
+        }
+        position += frame.size();
+    }
+}
+
+/**
+* @tc.name  : Test CaptureFrame API in real-time mode.
+* @tc.number: Audio_Capturer_File_Source_CaptureFrame_002
+* @tc.desc  : Test CaptureFrame with isRealtime set. Reads return at the sample rate, neither faster nor paced
+*           : twice.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_CaptureFrame_002, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(RAW_TEST_FILE,
+        AudioCapturerFileSourceUnitTest::CreatePcm(PCM_SIZE)));
+    ASSERT_EQ(SUCCESS, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(RAW_TEST_FILE, true, 0)));
+    EXPECT_EQ(SUCCESS, source->Start());
+
+    vector<char> frame(BLOCK_SIZE);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < PACED_BLOCKS; i++) {
+        uint64_t replyBytes = 0;
+        EXPECT_EQ(SUCCESS, source->CaptureFrame(frame.data(), frame.size(), replyBytes));
+    }
+    uint64_t elapsed = GetElapsedUsec(start);
+    EXPECT_GE(elapsed, PACED_BLOCKS * BLOCK_USEC - PACING_EARLY_USEC);
+    EXPECT_LE(elapsed, PACED_BLOCKS * BLOCK_USEC + PACING_LATE_USEC);
+}
+
+/**
+* @tc.name  : Test CaptureFrame API in real-time mode with jitter.
+* @tc.number: Audio_Capturer_File_Source_CaptureFrame_003
+* @tc.desc  : Test CaptureFrame with isRealtime and jitterUsec set. Jitter delays single reads, the timeline does
+*           : not drift by the sum of the delays.
+*/
+HWTEST(AudioCapturerFileSourceUnitTest, Audio_Capturer_File_Source_CaptureFrame_003, TestSize.Level1)
+{
+    AudioCapturerFileSource *source = AudioCapturerFileSource::GetInstance();
+    ASSERT_TRUE(AudioCapturerFileSourceUnitTest::WriteFile(RAW_TEST_FILE,
+        AudioCapturerFileSourceUnitTest::CreatePcm(PCM_SIZE)));
+    ASSERT_EQ(SUCCESS, source->Init(AudioCapturerFileSourceUnitTest::CreateAttr(RAW_TEST_FILE, true, JITTER_USEC)));
+    EXPECT_EQ(SUCCESS, source->Start());
+
+    vector<char> frame(BLOCK_SIZE);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < PACED_BLOCKS; i++) {
+        uint64_t replyBytes = 0;
+        EXPECT_EQ(SUCCESS, source->CaptureFrame(frame.data(), frame.size(), replyBytes));
+    }
+    uint64_t elapsed = GetElapsedUsec(start);
+    EXPECT_GE(elapsed, PACED_BLOCKS * BLOCK_USEC - PACING_EARLY_USEC);
+    EXPECT_LE(elapsed, PACED_BLOCKS * BLOCK_USEC + JITTER_USEC + PACING_LATE_USEC);
+}
+} // namespace AudioStandard
+} // namespace OHOS
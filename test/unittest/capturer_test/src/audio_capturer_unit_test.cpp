@@ -1359,6 +1359,99 @@ HWTEST(AudioCapturerUnitTest, Audio_Capturer_Read_007, TestSize.Level1)
     free(buffer);
 }
 
+/**
+* @tc.name  : Test AcquireReadBuffer and ReleaseReadBuffer API via legal state.
+* @tc.number: Audio_Capturer_AcquireReadBuffer_001
+* @tc.desc  : Test AcquireReadBuffer interface. Returns SUCCESS with a captured fragment, which is consumed by
+*           : ReleaseReadBuffer. Read fails while the fragment is held.
+*/
+HWTEST(AudioCapturerUnitTest, Audio_Capturer_AcquireReadBuffer_001, TestSize.Level1)
+{
+    AudioCapturerOptions capturerOptions;
+
+    AudioCapturerUnitTest::InitializeCapturerOptions(capturerOptions);
+    unique_ptr<AudioCapturer> audioCapturer = AudioCapturer::Create(capturerOptions);
+    ASSERT_NE(nullptr, audioCapturer);
+
+    bool isStarted = audioCapturer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    size_t bufferLen;
+    int32_t ret = audioCapturer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+
+    uint8_t *buffer = (uint8_t *) malloc(bufferLen);
+    ASSERT_NE(nullptr, buffer);
+
+    BufferDesc bufDesc {};
+    for (int32_t i = 0; i < READ_BUFFERS_COUNT; i++) {
+        ret = audioCapturer->AcquireReadBuffer(bufDesc);
+        EXPECT_EQ(SUCCESS, ret);
+        if (ret != SUCCESS) {
+            break;
+        }
+        EXPECT_NE(nullptr, bufDesc.buffer);
+        EXPECT_NE(VALUE_ZERO, static_cast<int32_t>(bufDesc.dataLength));
+
+        bool isReadRejected = audioCapturer->Read(*buffer, bufferLen, true) < 0;
+        EXPECT_EQ(true, isReadRejected);
+
+        ret = audioCapturer->ReleaseReadBuffer();
+        EXPECT_EQ(SUCCESS, ret);
+    }
+
+    ret = audioCapturer->ReleaseReadBuffer();
+    EXPECT_NE(SUCCESS, ret);
+
+    audioCapturer->Stop();
+    audioCapturer->Release();
+
+    free(buffer);
+}
+
+/**
+* @tc.name  : Test GetStatistics API.
+* @tc.number: Audio_Capturer_GetStatistics_001
+* @tc.desc  : Test GetStatistics interface. Returns 0 {SUCCESS} and sane values after capturing some data.
+*/
+HWTEST(AudioCapturerUnitTest, Audio_Capturer_GetStatistics_001, TestSize.Level1)
+{
+    bool isBlockingRead = true;
+    AudioCapturerOptions capturerOptions;
+
+    AudioCapturerUnitTest::InitializeCapturerOptions(capturerOptions);
+    unique_ptr<AudioCapturer> audioCapturer = AudioCapturer::Create(capturerOptions);
+    ASSERT_NE(nullptr, audioCapturer);
+
+    bool isStarted = audioCapturer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    size_t bufferLen;
+    int32_t ret = audioCapturer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+
+    uint8_t *buffer = (uint8_t *) malloc(bufferLen);
+    ASSERT_NE(nullptr, buffer);
+
+    for (int32_t i = 0; i < READ_BUFFERS_COUNT; i++) {
+        int32_t bytesRead = audioCapturer->Read(*buffer, bufferLen, isBlockingRead);
+        EXPECT_GE(bytesRead, VALUE_ZERO);
+    }
+
+    AudioStreamStatistics stats;
+    ret = audioCapturer->GetStatistics(stats);
+    EXPECT_EQ(SUCCESS, ret);
+    EXPECT_LE(stats.avgBlockingTimeUsec, stats.maxBlockingTimeUsec);
+    EXPECT_LE(stats.bufferFillPercent, static_cast<uint32_t>(VALUE_HUNDRED));
+    // Underruns are only counted for playback
+    EXPECT_EQ(0u, stats.underrunCount);
+
+    audioCapturer->Stop();
+    audioCapturer->Release();
+
+    free(buffer);
+}
+
 /**
 * @tc.name  : Test GetAudioTime API via legal input.
 * @tc.number: Audio_Capturer_GetAudioTime_001
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_FORMAT_CONVERTER_UNIT_TEST_H
+#define AUDIO_FORMAT_CONVERTER_UNIT_TEST_H
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "audio_format_converter.h"
+
+namespace OHOS {
+namespace AudioStandard {
+class AudioFormatConverterUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+    // Fills sampleCount samples of format with a ramp that covers full scale, clipping and rounding ties
+    static std::vector<uint8_t> CreateSource(AudioSampleFormat format, size_t sampleCount);
+    // Straightforward per sample conversion the optimized paths must match bit for bit
+    static std::vector<uint8_t> ConvertReference(const std::vector<uint8_t> &src, AudioSampleFormat srcFormat,
+        AudioSampleFormat dstFormat, size_t sampleCount);
+};
+} // namespace AudioStandard
+} // namespace OHOS
+
+#endif // AUDIO_FORMAT_CONVERTER_UNIT_TEST_H
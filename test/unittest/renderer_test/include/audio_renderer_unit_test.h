@@ -16,6 +16,8 @@
 #ifndef AUDIO_RENDERER_UNIT_TEST_H
 #define AUDIO_RENDERER_UNIT_TEST_H
 
+#include <future>
+
 #include "gtest/gtest.h"
 #include "audio_renderer.h"
 
@@ -42,6 +44,22 @@ public:
     void OnWriteData(size_t length) override;
 };
 
+class AudioRendererOperationCallbackTest : public AudioRendererOperationCallback {
+public:
+    void OnOperationComplete(bool success) override
+    {
+        result_.set_value(success);
+    }
+
+    std::future<bool> GetResult()
+    {
+        return result_.get_future();
+    }
+
+private:
+    std::promise<bool> result_;
+};
+
 class AudioRendererUnitTest : public testing::Test {
 public:
     // SetUpTestCase: Called before all test cases
@@ -57,6 +75,9 @@ public:
     // Init Renderer Options
     static void InitializeRendererOptions(AudioRendererOptions &rendererOptions);
 };
+
+// Parameterized by the renderer flag that selects the stream mode
+class AudioRendererModeUnitTest : public AudioRendererUnitTest, public testing::WithParamInterface<int32_t> {};
 } // namespace AudioStandard
 } // namespace OHOS
 
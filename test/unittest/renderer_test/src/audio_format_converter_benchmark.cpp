@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "audio_format_converter.h"
+
+using namespace std;
+using namespace OHOS::AudioStandard;
+
+namespace {
+// 20 ms of 48 kHz stereo, the size of a typical client write
+constexpr size_t SAMPLE_COUNT = 1920;
+constexpr size_t MAX_SAMPLE_SIZE = 4;
+constexpr float SINE_STEP = 0.01f;
+constexpr float SINE_AMPLITUDE = 0.8f;
+
+void ConvertFormat(benchmark::State &state, AudioSampleFormat srcFormat, AudioSampleFormat dstFormat, bool dither)
+{
+    vector<float> source(SAMPLE_COUNT);
+    for (size_t i = 0; i < SAMPLE_COUNT; i++) {
+        source[i] = SINE_AMPLITUDE * sinf(i * SINE_STEP);
+    }
+
+    AudioFormatConverter converter;
+    vector<uint8_t> src(SAMPLE_COUNT * MAX_SAMPLE_SIZE);
+    vector<uint8_t> dst(SAMPLE_COUNT * MAX_SAMPLE_SIZE);
+    converter.Convert(reinterpret_cast<uint8_t *>(source.data()), SAMPLE_F32LE, src.data(), srcFormat, SAMPLE_COUNT);
+    converter.SetDitherEnabled(dither);
+
+    for (auto _ : state) {
+        converter.Convert(src.data(), srcFormat, dst.data(), dstFormat, SAMPLE_COUNT);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * SAMPLE_COUNT);
+}
+
+void BM_ConvertS16ToF32(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_S16LE, SAMPLE_F32LE, false);
+}
+
+void BM_ConvertF32ToS16(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_F32LE, SAMPLE_S16LE, false);
+}
+
+void BM_ConvertF32ToS16Dither(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_F32LE, SAMPLE_S16LE, true);
+}
+
+void BM_ConvertS32ToF32(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_S32LE, SAMPLE_F32LE, false);
+}
+
+void BM_ConvertF32ToS32(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_F32LE, SAMPLE_S32LE, false);
+}
+
+void BM_ConvertS24ToS16Dither(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_S24LE, SAMPLE_S16LE, true);
+}
+
+void BM_ConvertU8ToS16(benchmark::State &state)
+{
+    ConvertFormat(state, SAMPLE_U8, SAMPLE_S16LE, false);
+}
+} // namespace
+
+BENCHMARK(BM_ConvertS16ToF32);
+BENCHMARK(BM_ConvertF32ToS16);
+BENCHMARK(BM_ConvertF32ToS16Dither);
+BENCHMARK(BM_ConvertS32ToF32);
+BENCHMARK(BM_ConvertF32ToS32);
+BENCHMARK(BM_ConvertS24ToS16Dither);
+BENCHMARK(BM_ConvertU8ToS16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_format_converter_unit_test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "audio_errors.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace AudioStandard {
+namespace {
+    const vector<AudioSampleFormat> ALL_FORMATS = {
+        SAMPLE_U8, SAMPLE_S16LE, SAMPLE_S24LE, SAMPLE_S32LE, SAMPLE_F32LE
+    };
+    const vector<size_t> CHANNEL_COUNTS = {1, 2, 6, 8};
+    // Odd counts leave tails behind every SIMD block size, the large ones cross the scratch buffer size
+    const vector<size_t> FRAME_COUNTS = {1, 3, 7, 17, 333, 1023, 1025};
+
+    constexpr size_t GUARD_BYTES = 16;
+    constexpr uint8_t GUARD_VALUE = 0xA5;
+
+    constexpr float U8_SCALE = 128.0f;
+    constexpr float S16_SCALE = 32768.0f;
+    constexpr float S24_SCALE = 8388608.0f;
+    constexpr float S32_SCALE = 2147483648.0f;
+    constexpr float U8_MAX = 255.0f;
+    constexpr float S16_MAX = 32767.0f;
+    constexpr float S24_MAX = 8388607.0f;
+    constexpr float S32_MAX = 2147483520.0f;
+    constexpr float RAMP_PEAK = 1.25f;
+    constexpr float HALF_LSB = 0.5f;
+    constexpr size_t U8_CODES = 256;
+    constexpr size_t S16_CODES = 65536;
+    constexpr size_t SOURCE_PATTERNS = 4;
+    constexpr uint32_t LCG_MUL = 1103515245u;
+    constexpr uint32_t LCG_ADD = 12345u;
+    constexpr uint32_t BYTE_SHIFT = 8;
+    constexpr uint32_t BYTE_MASK = 0xFF;
+    constexpr int32_t DITHER_MAX_ERROR = 1;
+
+    float DecodeSample(const uint8_t *sample, AudioSampleFormat format)
+    {
+        switch (format) {
+            case SAMPLE_U8:
+                return (static_cast<float>(sample[0]) - U8_SCALE) * (1.0f / U8_SCALE);
+            case SAMPLE_S16LE: {
+                int16_t value;
+                (void)memcpy(&value, sample, sizeof(value));
+                return value * (1.0f / S16_SCALE);
+            }
+            case SAMPLE_S24LE: {
+                uint32_t value = (static_cast<uint32_t>(sample[0]) << BYTE_SHIFT) |
+                    (static_cast<uint32_t>(sample[1]) << (BYTE_SHIFT * 2)) |
+                    (static_cast<uint32_t>(sample[2]) << (BYTE_SHIFT * 3));
+                return static_cast<int32_t>(value) * (1.0f / S32_SCALE);
+            }
+            case SAMPLE_S32LE: {
+                int32_t value;
+                (void)memcpy(&value, sample, sizeof(value));
+                return value * (1.0f / S32_SCALE);
+            }
+            case SAMPLE_F32LE: {
+                float value;
+                (void)memcpy(&value, sample, sizeof(value));
+                return value;
+            }
+            default:
+                return 0.0f;
+        }
+    }
+
+    int32_t Quantize(float value, float minValue, float maxValue)
+    {
+        return static_cast<int32_t>(lrintf(min(max(value, minValue), maxValue)));
+    }
+
+    void EncodeSample(float value, AudioSampleFormat format, uint8_t *sample)
+    {
+        switch (format) {
+            case SAMPLE_U8:
+                sample[0] = static_cast<uint8_t>(Quantize(value * U8_SCALE + U8_SCALE, 0.0f, U8_MAX));
+                break;
+            case SAMPLE_S16LE: {
+                int16_t out = static_cast<int16_t>(Quantize(value * S16_SCALE, -S16_SCALE, S16_MAX));
+                (void)memcpy(sample, &out, sizeof(out));
+                break;
+            }
+            case SAMPLE_S24LE: {
+                uint32_t out = static_cast<uint32_t>(Quantize(value * S24_SCALE, -S24_SCALE, S24_MAX));
+                sample[0] = static_cast<uint8_t>(out & BYTE_MASK);
+                sample[1] = static_cast<uint8_t>((out >> BYTE_SHIFT) & BYTE_MASK);
+                sample[2] = static_cast<uint8_t>((out >> (BYTE_SHIFT * 2)) & BYTE_MASK);
+                break;
+            }
+            case SAMPLE_S32LE: {
+                int32_t out = Quantize(value * S32_SCALE, -S32_SCALE, S32_MAX);
+                (void)memcpy(sample, &out, sizeof(out));
+                break;
+            }
+            case SAMPLE_F32LE:
+                (void)memcpy(sample, &value, sizeof(value));
+                break;
+            default:
+                break;
+        }
+    }
+
+    string FormatPairName(AudioSampleFormat srcFormat, AudioSampleFormat dstFormat, size_t sampleCount)
+    {
+        return "src " + to_string(srcFormat) + ", dst " + to_string(dstFormat) + ", samples " +
+            to_string(sampleCount);
+    }
+} // namespace
+
+void AudioFormatConverterUnitTest::SetUpTestCase(void) {}
+void AudioFormatConverterUnitTest::TearDownTestCase(void) {}
+void AudioFormatConverterUnitTest::SetUp(void) {}
+void AudioFormatConverterUnitTest::TearDown(void) {}
+
+vector<uint8_t> AudioFormatConverterUnitTest::CreateSource(AudioSampleFormat format, size_t sampleCount)
+{
+    size_t sampleSize = AudioFormatConverter::GetSampleSize(format);
+    vector<uint8_t> src(sampleCount * sampleSize);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < sampleCount; i++) {
+        uint8_t *sample = src.data() + i * sampleSize;
+        if (format != SAMPLE_F32LE) {
+            // Random codes, with the first two samples at the negative and positive extremes
+            for (size_t byte = 0; byte < sampleSize; byte++) {
+                seed = seed * LCG_MUL + LCG_ADD;
+                sample[byte] = static_cast<uint8_t>(seed >> (BYTE_SHIFT * 2));
+            }
+            if (i < 2) {
+                (void)memset(sample, (i == 0) ? 0x00 : 0xFF, sampleSize);
+                if (format != SAMPLE_U8) {
+                    sample[sampleSize - 1] = (i == 0) ? 0x80 : 0x7F;
+                }
+            }
+            continue;
+        }
+
+        float value;
+        switch (i % SOURCE_PATTERNS) {
+            case 0:
+                // Ramp past full scale in both directions to exercise clipping
+                value = -RAMP_PEAK + 2.0f * RAMP_PEAK * i / sampleCount;
+                break;
+            case 1:
+                // Exact halfway points between S16 codes, rounding must go to even
+                value = (static_cast<float>(i % S16_CODES) - S16_SCALE + HALF_LSB) / S16_SCALE;
+                break;
+            case 2:
+                // Exact halfway points between U8 codes
+                value = (static_cast<float>(i % U8_CODES) - U8_SCALE + HALF_LSB) / U8_SCALE;
+                break;
+            default:
+                value = ((i / SOURCE_PATTERNS) % 2 == 0) ? 1.0f : -1.0f;
+                break;
+        }
+        (void)memcpy(sample, &value, sizeof(value));
+    }
+    return src;
+}
+
+vector<uint8_t> AudioFormatConverterUnitTest::ConvertReference(const vector<uint8_t> &src,
+    AudioSampleFormat srcFormat, AudioSampleFormat dstFormat, size_t sampleCount)
+{
+    size_t srcSampleSize = AudioFormatConverter::GetSampleSize(srcFormat);
+    size_t dstSampleSize = AudioFormatConverter::GetSampleSize(dstFormat);
+    vector<uint8_t> dst(sampleCount * dstSampleSize);
+    if (srcFormat == dstFormat) {
+        dst = src;
+        return dst;
+    }
+    for (size_t i = 0; i < sampleCount; i++) {
+        EncodeSample(DecodeSample(src.data() + i * srcSampleSize, srcFormat), dstFormat,
+            dst.data() + i * dstSampleSize);
+    }
+    return dst;
+}
+
+/**
+* @tc.name  : Test Convert API against a scalar reference.
+* @tc.number: Audio_Format_Converter_Convert_001
+* @tc.desc  : Test Convert for every source and destination format pair with several channel counts and odd
+*           : lengths. The output must match the scalar reference bit for bit and nothing past it may be written.
+*/
+HWTEST(AudioFormatConverterUnitTest, Audio_Format_Converter_Convert_001, TestSize.Level1)
+{
+    AudioFormatConverter converter;
+    for (AudioSampleFormat srcFormat : ALL_FORMATS) {
+        for (AudioSampleFormat dstFormat : ALL_FORMATS) {
+            for (size_t channels : CHANNEL_COUNTS) {
+                for (size_t frames : FRAME_COUNTS) {
+                    size_t sampleCount = frames * channels;
+                    SCOPED_TRACE(FormatPairName(srcFormat, dstFormat, sampleCount));
+                    vector<uint8_t> src = AudioFormatConverterUnitTest::CreateSource(srcFormat, sampleCount);
+                    vector<uint8_t> expected = AudioFormatConverterUnitTest::ConvertReference(src, srcFormat,
+                        dstFormat, sampleCount);
+
+                    vector<uint8_t> dst(expected.size() + GUARD_BYTES, GUARD_VALUE);
+                    int32_t ret = converter.Convert(src.data(), srcFormat, dst.data(), dstFormat, sampleCount);
+                    EXPECT_EQ(SUCCESS, ret);
+
+                    auto diff = mismatch(expected.begin(), expected.end(), dst.begin());
+                    EXPECT_TRUE(diff.first == expected.end()) << "first difference at byte " <<
+                        (diff.first - expected.begin());
+                    EXPECT_TRUE(all_of(dst.begin() + expected.size(), dst.end(),
+                        [](uint8_t value) { return value == GUARD_VALUE; }));
+                }
+            }
+        }
+    }
+}
+
+/**
+* @tc.name  : Test Convert API with dither.
+* @tc.number: Audio_Format_Converter_Dither_001
+* @tc.desc  : Test Convert from F32LE to S16LE with dither enabled. Each output sample stays within one LSB
+*           : of the undithered reference.
+*/
+HWTEST(AudioFormatConverterUnitTest, Audio_Format_Converter_Dither_001, TestSize.Level1)
+{
+    AudioFormatConverter converter;
+    converter.SetDitherEnabled(true);
+    EXPECT_TRUE(converter.IsDitherEnabled());
+
+    size_t sampleCount = FRAME_COUNTS.back() * CHANNEL_COUNTS[1];
+    vector<uint8_t> src = AudioFormatConverterUnitTest::CreateSource(SAMPLE_F32LE, sampleCount);
+    vector<uint8_t> expected = AudioFormatConverterUnitTest::ConvertReference(src, SAMPLE_F32LE, SAMPLE_S16LE,
+        sampleCount);
+    vector<uint8_t> dst(expected.size());
+    int32_t ret = converter.Convert(src.data(), SAMPLE_F32LE, dst.data(), SAMPLE_S16LE, sampleCount);
+    EXPECT_EQ(SUCCESS, ret);
+
+    const int16_t *expectedSamples = reinterpret_cast<const int16_t *>(expected.data());
+    const int16_t *samples = reinterpret_cast<const int16_t *>(dst.data());
+    for (size_t i = 0; i < sampleCount; i++) {
+        EXPECT_LE(abs(samples[i] - expectedSamples[i]), DITHER_MAX_ERROR) << "sample " << i;
+    }
+}
+
+/**
+* @tc.name  : Test Convert API with invalid parameters.
+* @tc.number: Audio_Format_Converter_Convert_002
+* @tc.desc  : Test Convert with null buffers and an unsupported format. Returns ERR_INVALID_PARAM and
+*           : ERR_NOT_SUPPORTED.
+*/
+HWTEST(AudioFormatConverterUnitTest, Audio_Format_Converter_Convert_002, TestSize.Level1)
+{
+    AudioFormatConverter converter;
+    uint8_t buffer[GUARD_BYTES] = {};
+
+    EXPECT_EQ(ERR_INVALID_PARAM, converter.Convert(nullptr, SAMPLE_S16LE, buffer, SAMPLE_F32LE, 1));
+    EXPECT_EQ(ERR_INVALID_PARAM, converter.Convert(buffer, SAMPLE_S16LE, nullptr, SAMPLE_F32LE, 1));
+    EXPECT_EQ(ERR_NOT_SUPPORTED, converter.Convert(buffer, INVALID_WIDTH, buffer + 1, SAMPLE_F32LE, 1));
+    EXPECT_FALSE(AudioFormatConverter::IsSupported(INVALID_WIDTH));
+    EXPECT_EQ(0u, AudioFormatConverter::GetSampleSize(INVALID_WIDTH));
+}
+} // namespace AudioStandard
+} // namespace OHOS
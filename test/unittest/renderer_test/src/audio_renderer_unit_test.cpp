@@ -16,7 +16,9 @@
 #include "audio_renderer_unit_test.h"
 
 #include <chrono>
+#include <cstring>
 #include <thread>
+#include <vector>
 
 #include "audio_errors.h"
 #include "audio_info.h"
@@ -37,6 +39,7 @@ namespace {
     const int32_t RENDERER_FLAG = 0;
     // Writing only 500 buffers of data for test
     const int32_t WRITE_BUFFERS_COUNT = 500;
+    const int32_t RENDERER_MODE_FLAGS[] = { RENDERER_FLAG_LOW_LATENCY, RENDERER_FLAG_DEEP_BUFFER };
     constexpr int32_t PAUSE_BUFFER_POSITION = 400000;
     constexpr int32_t PAUSE_RENDER_TIME_SECONDS = 1;
 
@@ -45,6 +48,9 @@ namespace {
     constexpr uint64_t BUFFER_DURATION_FIFTEEN = 15;
     constexpr uint64_t BUFFER_DURATION_TWENTY = 20;
     constexpr uint32_t PLAYBACK_DURATION = 2;
+    constexpr uint32_t ASYNC_OPERATION_TIMEOUT = 5;
+    // S16LE stereo, as set in InitializeRendererOptions
+    constexpr size_t FRAME_SIZE_S16LE_STEREO = 4;
 
     static size_t g_reqBufLen = 0;
 } // namespace
@@ -456,6 +462,47 @@ HWTEST(AudioRendererUnitTest, Audio_Renderer_Create_014, TestSize.Level0)
     audioRenderer->Release();
 }
 
+/**
+* @tc.name  : Test Create API with a pooled stream.
+* @tc.number: Audio_Renderer_Create_015
+* @tc.desc  : Test Create interface after SetStreamPoolSize. Returns audioRenderer instance built from the pooled
+*             stream, which is counted as a pool hit and starts successfully.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_Create_015, TestSize.Level0)
+{
+    AudioRendererOptions rendererOptions;
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    rendererOptions.rendererInfo.contentType = ContentType::CONTENT_TYPE_SONIFICATION;
+    rendererOptions.rendererInfo.streamUsage = StreamUsage::STREAM_USAGE_NOTIFICATION_RINGTONE;
+
+    int32_t ret = AudioRenderer::SetStreamPoolSize(rendererOptions, 1);
+    EXPECT_EQ(SUCCESS, ret);
+
+    AudioStreamPoolStats stats;
+    for (int32_t i = 0; i < VALUE_HUNDRED; i++) {
+        AudioRenderer::GetStreamPoolStats(stats);
+        if (stats.pooledCount > 0) {
+            break;
+        }
+        this_thread::sleep_for(milliseconds(VALUE_HUNDRED));
+    }
+    EXPECT_EQ(1, stats.pooledCount);
+    uint64_t hitCount = stats.hitCount;
+
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+    AudioRenderer::GetStreamPoolStats(stats);
+    EXPECT_EQ(hitCount + 1, stats.hitCount);
+    EXPECT_GT(stats.setupTimeSavedUsec, 0);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+    audioRenderer->Release();
+
+    ret = AudioRenderer::SetStreamPoolSize(rendererOptions, 0);
+    EXPECT_EQ(SUCCESS, ret);
+}
+
 /**
 * @tc.name  : Test Renderer playback
 * @tc.number: Audio_Renderer_Playback_001
@@ -1773,6 +1820,196 @@ HWTEST(AudioRendererUnitTest, Audio_Renderer_Write_009, TestSize.Level1)
     fclose(wavFile);
 }
 
+/**
+* @tc.name  : Test AcquireWriteBuffer and CommitWriteBuffer API via legal input.
+* @tc.number: Audio_Renderer_AcquireWriteBuffer_001
+* @tc.desc  : Test AcquireWriteBuffer and CommitWriteBuffer interface. Returns SUCCESS, if the data
+*           : is rendered into the acquired buffer and committed successfully.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_AcquireWriteBuffer_001, TestSize.Level1)
+{
+    int32_t ret = -1;
+    FILE *wavFile = fopen(AUDIORENDER_TEST_FILE_PATH.c_str(), "rb");
+    ASSERT_NE(nullptr, wavFile);
+
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    int32_t numBuffersToRender = WRITE_BUFFERS_COUNT;
+    while (numBuffersToRender) {
+        BufferDesc bufDesc = {};
+        ret = audioRenderer->AcquireWriteBuffer(bufDesc);
+        EXPECT_EQ(SUCCESS, ret);
+        ASSERT_NE(nullptr, bufDesc.buffer);
+        EXPECT_GT(bufDesc.bufLength, static_cast<size_t>(VALUE_ZERO));
+
+        size_t bytesRead = fread(bufDesc.buffer, 1, bufDesc.bufLength, wavFile);
+        bytesRead -= bytesRead % FRAME_SIZE_S16LE_STEREO;
+        ret = audioRenderer->CommitWriteBuffer(bytesRead);
+        EXPECT_EQ(SUCCESS, ret);
+        if (bytesRead == 0) {
+            break;
+        }
+        numBuffersToRender--;
+    }
+
+    audioRenderer->Drain();
+    audioRenderer->Stop();
+    audioRenderer->Release();
+
+    fclose(wavFile);
+}
+
+/**
+* @tc.name  : Test AcquireWriteBuffer API via illegal render mode, RENDER_MODE_CALLBACK.
+* @tc.number: Audio_Renderer_AcquireWriteBuffer_002
+* @tc.desc  : Test AcquireWriteBuffer interface. Returns ERR_INCORRECT_MODE, if the render mode is
+*           : RENDER_MODE_CALLBACK.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_AcquireWriteBuffer_002, TestSize.Level1)
+{
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    int32_t ret = audioRenderer->SetRenderMode(RENDER_MODE_CALLBACK);
+    EXPECT_EQ(SUCCESS, ret);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    BufferDesc bufDesc = {};
+    ret = audioRenderer->AcquireWriteBuffer(bufDesc);
+    EXPECT_EQ(ERR_INCORRECT_MODE, ret);
+
+    ret = audioRenderer->CommitWriteBuffer(0);
+    EXPECT_EQ(ERR_INCORRECT_MODE, ret);
+
+    audioRenderer->Release();
+}
+
+/**
+* @tc.name  : Test Write API in the low latency and deep buffer modes.
+* @tc.number: Audio_Renderer_Write_Mode_001
+* @tc.desc  : Test Write interface with RENDERER_FLAG_LOW_LATENCY or RENDERER_FLAG_DEEP_BUFFER set in
+*           : rendererFlags. The buffer size follows the mode, no larger than the default one in low latency
+*           : mode and larger in deep buffer mode, and every byte is written.
+*/
+HWTEST_P(AudioRendererModeUnitTest, Audio_Renderer_Write_Mode_001, TestSize.Level1)
+{
+    int32_t rendererFlags = GetParam();
+    FILE *wavFile = fopen(AUDIORENDER_TEST_FILE_PATH.c_str(), "rb");
+    ASSERT_NE(nullptr, wavFile);
+
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> defaultRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, defaultRenderer);
+    size_t defaultBufferLen;
+    int32_t ret = defaultRenderer->GetBufferSize(defaultBufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+    defaultRenderer->Release();
+
+    rendererOptions.rendererInfo.rendererFlags = rendererFlags;
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    size_t bufferLen;
+    ret = audioRenderer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+    if (rendererFlags == RENDERER_FLAG_LOW_LATENCY) {
+        EXPECT_LE(bufferLen, defaultBufferLen);
+    } else {
+        EXPECT_GT(bufferLen, defaultBufferLen);
+    }
+
+    uint8_t *buffer = (uint8_t *) malloc(bufferLen);
+    ASSERT_NE(nullptr, buffer);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    int32_t numBuffersToRender = WRITE_BUFFERS_COUNT;
+    while (numBuffersToRender) {
+        size_t bytesToWrite = fread(buffer, 1, bufferLen, wavFile);
+        if (bytesToWrite == 0) {
+            break;
+        }
+        int32_t bytesWritten = audioRenderer->Write(buffer, bytesToWrite);
+        EXPECT_EQ(static_cast<int32_t>(bytesToWrite), bytesWritten);
+        numBuffersToRender--;
+    }
+
+    bool isDrained = audioRenderer->Drain();
+    EXPECT_EQ(true, isDrained);
+
+    audioRenderer->Stop();
+    audioRenderer->Release();
+
+    free(buffer);
+    fclose(wavFile);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Audio_Renderer_Write_Mode,
+    AudioRendererModeUnitTest,
+    testing::ValuesIn(RENDERER_MODE_FLAGS));
+
+/**
+* @tc.name  : Test Write API with float samples.
+* @tc.number: Audio_Renderer_Write_F32LE_001
+* @tc.desc  : Test Write interface with SAMPLE_F32LE, which is converted on the client. Returns number of
+*           : bytes written in the float format, if the write is successful.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_Write_F32LE_001, TestSize.Level1)
+{
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    rendererOptions.streamInfo.format = AudioSampleFormat::SAMPLE_F32LE;
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    AudioRendererParams getRendererParams;
+    int32_t ret = audioRenderer->GetParams(getRendererParams);
+    EXPECT_EQ(SUCCESS, ret);
+    EXPECT_EQ(SAMPLE_F32LE, getRendererParams.sampleFormat);
+
+    size_t bufferLen;
+    ret = audioRenderer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+
+    size_t sampleCount = bufferLen / sizeof(float);
+    vector<float> buffer(sampleCount);
+    for (size_t i = 0; i < sampleCount; i++) {
+        buffer[i] = (i % VALUE_HUNDRED) / static_cast<float>(VALUE_HUNDRED) - 0.5f;
+    }
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    for (int32_t i = 0; i < VALUE_HUNDRED; i++) {
+        int32_t bytesWritten = audioRenderer->Write(reinterpret_cast<uint8_t *>(buffer.data()),
+            sampleCount * sizeof(float));
+        EXPECT_EQ(static_cast<int32_t>(sampleCount * sizeof(float)), bytesWritten);
+    }
+
+    bool isDrained = audioRenderer->Drain();
+    EXPECT_EQ(true, isDrained);
+
+    audioRenderer->Stop();
+    audioRenderer->Release();
+}
+
 /**
 * @tc.name  : Test GetAudioTime API via legal input.
 * @tc.number: Audio_Renderer_GetAudioTime_001
@@ -1976,6 +2213,112 @@ HWTEST(AudioRendererUnitTest, Audio_Renderer_Drain_001, TestSize.Level1)
     fclose(wavFile);
 }
 
+/**
+* @tc.name  : Test DrainAsync and StopAsync API.
+* @tc.number: Audio_Renderer_DrainAsync_001
+* @tc.desc  : Test DrainAsync and StopAsync interface. Returns SUCCESS right away and reports completion
+*             through the callback.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_DrainAsync_001, TestSize.Level1)
+{
+    FILE *wavFile = fopen(AUDIORENDER_TEST_FILE_PATH.c_str(), "rb");
+    ASSERT_NE(nullptr, wavFile);
+
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    size_t bufferLen;
+    int32_t ret = audioRenderer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+
+    uint8_t *buffer = (uint8_t *) malloc(bufferLen);
+    ASSERT_NE(nullptr, buffer);
+
+    size_t bytesToWrite = fread(buffer, 1, bufferLen, wavFile);
+    int32_t bytesWritten = audioRenderer->Write(buffer, bytesToWrite);
+    EXPECT_GE(bytesWritten, VALUE_ZERO);
+
+    auto drainCallback = make_shared<AudioRendererOperationCallbackTest>();
+    future<bool> isDrained = drainCallback->GetResult();
+    ret = audioRenderer->DrainAsync(drainCallback);
+    EXPECT_EQ(SUCCESS, ret);
+    ASSERT_EQ(future_status::ready, isDrained.wait_for(seconds(ASYNC_OPERATION_TIMEOUT)));
+    EXPECT_EQ(true, isDrained.get());
+
+    auto stopCallback = make_shared<AudioRendererOperationCallbackTest>();
+    future<bool> isStopped = stopCallback->GetResult();
+    ret = audioRenderer->StopAsync(stopCallback);
+    EXPECT_EQ(SUCCESS, ret);
+    EXPECT_EQ(RENDERER_STOPPED, audioRenderer->GetStatus());
+    ASSERT_EQ(future_status::ready, isStopped.wait_for(seconds(ASYNC_OPERATION_TIMEOUT)));
+    EXPECT_EQ(true, isStopped.get());
+
+    audioRenderer->Release();
+
+    free(buffer);
+    fclose(wavFile);
+}
+
+/**
+* @tc.name  : Test PauseAsync API via legal render mode, RENDER_MODE_CALLBACK.
+* @tc.number: Audio_Renderer_PauseAsync_001
+* @tc.desc  : Test PauseAsync interface. The write thread waiting for the stream does not block the pause,
+*             the restart or the release that follow it.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_PauseAsync_001, TestSize.Level1)
+{
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    int32_t ret = audioRenderer->SetRenderMode(RENDER_MODE_CALLBACK);
+    EXPECT_EQ(SUCCESS, ret);
+    shared_ptr<AudioRendererWriteCallback> cb = make_shared<AudioRenderModeCallbackTest>();
+    ret = audioRenderer->SetRendererWriteCallback(cb);
+    EXPECT_EQ(SUCCESS, ret);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    // Queue every free buffer so the write thread is still waiting for the stream when it is corked
+    BufferDesc bufDesc {};
+    while (audioRenderer->GetBufferDesc(bufDesc) == SUCCESS) {
+        (void)memset(bufDesc.buffer, 0, bufDesc.bufLength);
+        bufDesc.dataLength = bufDesc.bufLength;
+        EXPECT_EQ(SUCCESS, audioRenderer->Enqueue(bufDesc));
+    }
+
+    auto pauseCallback = make_shared<AudioRendererOperationCallbackTest>();
+    future<bool> isPaused = pauseCallback->GetResult();
+    ret = audioRenderer->PauseAsync(pauseCallback);
+    EXPECT_EQ(SUCCESS, ret);
+    EXPECT_EQ(RENDERER_PAUSED, audioRenderer->GetStatus());
+    ASSERT_EQ(future_status::ready, isPaused.wait_for(seconds(ASYNC_OPERATION_TIMEOUT)));
+    EXPECT_EQ(true, isPaused.get());
+
+    isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    ret = audioRenderer->GetBufferDesc(bufDesc);
+    EXPECT_EQ(SUCCESS, ret);
+    if (ret == SUCCESS) {
+        (void)memset(bufDesc.buffer, 0, bufDesc.bufLength);
+        bufDesc.dataLength = bufDesc.bufLength;
+        EXPECT_EQ(SUCCESS, audioRenderer->Enqueue(bufDesc));
+    }
+
+    bool isReleased = audioRenderer->Release();
+    EXPECT_EQ(true, isReleased);
+}
+
 /**
 * @tc.name  : Test Drain API via illegal state, RENDERER_NEW: Without initializing the renderer.
 * @tc.number: Audio_Renderer_Drain_002
@@ -2997,6 +3340,54 @@ HWTEST(AudioRendererUnitTest, Audio_Renderer_GetLatency_001, TestSize.Level1)
     fclose(wavFile);
 }
 
+/**
+* @tc.name  : Test GetStatistics API.
+* @tc.number: Audio_Renderer_GetStatistics_001
+* @tc.desc  : Test GetStatistics interface. Returns 0 {SUCCESS} and sane values after rendering some data.
+*/
+HWTEST(AudioRendererUnitTest, Audio_Renderer_GetStatistics_001, TestSize.Level1)
+{
+    FILE *wavFile = fopen(AUDIORENDER_TEST_FILE_PATH.c_str(), "rb");
+    ASSERT_NE(nullptr, wavFile);
+
+    AudioRendererOptions rendererOptions;
+
+    AudioRendererUnitTest::InitializeRendererOptions(rendererOptions);
+    unique_ptr<AudioRenderer> audioRenderer = AudioRenderer::Create(rendererOptions);
+    ASSERT_NE(nullptr, audioRenderer);
+
+    bool isStarted = audioRenderer->Start();
+    EXPECT_EQ(true, isStarted);
+
+    size_t bufferLen;
+    int32_t ret = audioRenderer->GetBufferSize(bufferLen);
+    EXPECT_EQ(SUCCESS, ret);
+
+    uint8_t *buffer = (uint8_t *) malloc(bufferLen);
+    ASSERT_NE(nullptr, buffer);
+
+    int32_t numBuffersToRender = WRITE_BUFFERS_COUNT;
+    while (numBuffersToRender) {
+        size_t bytesToWrite = fread(buffer, 1, bufferLen, wavFile);
+        int32_t bytesWritten = audioRenderer->Write(buffer, bytesToWrite);
+        EXPECT_GE(bytesWritten, VALUE_ZERO);
+        numBuffersToRender--;
+    }
+
+    AudioStreamStatistics stats;
+    ret = audioRenderer->GetStatistics(stats);
+    EXPECT_EQ(SUCCESS, ret);
+    EXPECT_LE(stats.avgBlockingTimeUsec, stats.maxBlockingTimeUsec);
+    EXPECT_LE(stats.bufferFillPercent, 100);
+    EXPECT_EQ(0, stats.overrunCount);
+
+    audioRenderer->Drain();
+    audioRenderer->Release();
+
+    free(buffer);
+    fclose(wavFile);
+}
+
 /**
 * @tc.name  : Test GetLatency API via illegal state, RENDERER_NEW: without initializing the renderer
 * @tc.number: Audio_Renderer_GetLatency_002